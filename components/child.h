@@ -15,6 +15,8 @@ public:
 	EntityID first_child;
 	// The next child in this level
 	EntityID next;
+	// The previous child in this level, so the `Entity` can be unlinked in O(1).
+	EntityID prev;
 
 	Child(EntityID p_parent);
 };
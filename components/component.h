@@ -36,6 +36,7 @@ public:
                                                                        \
 public:                                                                \
 	/* Storages */                                                     \
+	using storage_type = m_storage_class<m_class>;                     \
 	static _FORCE_INLINE_ m_storage_class<m_class> *create_storage() { \
 		return new m_storage_class<m_class>;                           \
 	}                                                                  \
@@ -76,5 +77,26 @@ private:
 		return create_storage();                                                              \
 	}                                                                                         \
 	COMPONENT_INTERNAL(m_class)                                                               \
+	using storage_type = BatchStorage<m_storage_class, m_batch, m_class>;                     \
+	m_class() = default;
+
+/// Register a component that can store batched data of any size, using a
+/// shared `BatchArena`: the component must be trivially copyable. Prefer this
+/// to `COMPONENT_BATCH` with `-1` for the batches written and cleared often.
+#define COMPONENT_BATCH_ARENA(m_class, m_storage_class)                                      \
+	ECSCLASS(m_class)                                                                        \
+	friend class World;                                                                      \
+                                                                                             \
+private:                                                                                     \
+	/* Storages */                                                                           \
+	static _FORCE_INLINE_ BatchStorage<m_storage_class, -1, m_class, true> *create_storage() { \
+		return new BatchStorage<m_storage_class, -1, m_class, true>;                           \
+	}                                                                                        \
+	static _FORCE_INLINE_ StorageBase *create_storage_no_type() {                            \
+		/* Creates a storage but returns a generic component. */                             \
+		return create_storage();                                                             \
+	}                                                                                        \
+	COMPONENT_INTERNAL(m_class)                                                              \
+	using storage_type = BatchStorage<m_storage_class, -1, m_class, true>;                   \
 	m_class() = default;
 } // namespace godex
@@ -7,9 +7,116 @@
 DynamicComponentInfo::DynamicComponentInfo() {
 }
 
+// Calls `m_macro(Type)` for the `Variant::Type` `m_type`, when it has a fixed
+// size; `m_fallback` otherwise.
+#define PACKED_TYPE_SWITCH(m_type, m_macro, m_fallback) \
+	switch (m_type) {                                  \
+		case Variant::BOOL:                            \
+			m_macro(bool);                             \
+		case Variant::INT:                             \
+			m_macro(int64_t);                          \
+		case Variant::FLOAT:                           \
+			m_macro(double);                           \
+		case Variant::VECTOR2:                         \
+			m_macro(Vector2);                          \
+		case Variant::VECTOR2I:                        \
+			m_macro(Vector2i);                         \
+		case Variant::RECT2:                           \
+			m_macro(Rect2);                            \
+		case Variant::RECT2I:                          \
+			m_macro(Rect2i);                           \
+		case Variant::VECTOR3:                         \
+			m_macro(Vector3);                          \
+		case Variant::VECTOR3I:                        \
+			m_macro(Vector3i);                         \
+		case Variant::TRANSFORM2D:                     \
+			m_macro(Transform2D);                      \
+		case Variant::PLANE:                           \
+			m_macro(Plane);                            \
+		case Variant::QUATERNION:                      \
+			m_macro(Quaternion);                       \
+		case Variant::AABB:                            \
+			m_macro(AABB);                             \
+		case Variant::BASIS:                           \
+			m_macro(Basis);                            \
+		case Variant::TRANSFORM3D:                     \
+			m_macro(Transform3D);                      \
+		case Variant::COLOR:                           \
+			m_macro(Color);                            \
+		default:                                       \
+			m_fallback;                                \
+	}
+
+int DynamicComponentInfo::get_packed_type_size(Variant::Type p_type) {
+	if (p_type == Variant::NIL) {
+		// The slot of a filtered property, nothing to store.
+		return 0;
+	}
+#define PACKED_SIZE(m_type) return sizeof(m_type)
+	PACKED_TYPE_SWITCH(p_type, PACKED_SIZE, return -1);
+#undef PACKED_SIZE
+}
+
+static uint32_t get_packed_type_align(Variant::Type p_type) {
+#define PACKED_ALIGN(m_type) return alignof(m_type)
+	PACKED_TYPE_SWITCH(p_type, PACKED_ALIGN, return 1);
+#undef PACKED_ALIGN
+}
+
+void DynamicComponentInfo::update_layout() {
+	packed_size = 0;
+	packed_offsets.resize(properties.size());
+
+	uint32_t size = 0;
+	for (uint32_t i = 0; i < properties.size(); i += 1) {
+		const int type_size = get_packed_type_size(properties[i].type);
+		if (type_size < 0) {
+			// This property can't be packed, store everything as `Variant`.
+			return;
+		}
+		const uint32_t align = get_packed_type_align(properties[i].type);
+		size = (size + align - 1) & ~(align - 1);
+		packed_offsets[i] = size;
+		size += type_size;
+	}
+
+	if (size <= MAX_PACKED_SIZE) {
+		packed_size = size;
+	}
+}
+
+void DynamicComponentInfo::init_packed_data(uint8_t *r_data) const {
+	for (uint32_t i = 0; i < properties.size(); i += 1) {
+		uint8_t *ptr = r_data + packed_offsets[i];
+#define PACKED_INIT(m_type)                                      \
+	*reinterpret_cast<m_type *>(ptr) = defaults[i].operator m_type(); \
+	break
+		PACKED_TYPE_SWITCH(properties[i].type, PACKED_INIT, break);
+#undef PACKED_INIT
+	}
+}
+
 StorageBase *DynamicComponentInfo::create_storage() {
 	switch (storage_type) {
 		case StorageType::DENSE_VECTOR:
+			if (properties.size() > 0 && is_packed()) {
+				// Creates DynamicDenseVector storage, with the packed properties.
+				if (packed_size <= 16) {
+					return godex_new(DynamicDenseVectorStorage<PackedVariantComponent<16>>(this));
+				} else if (packed_size <= 32) {
+					return godex_new(DynamicDenseVectorStorage<PackedVariantComponent<32>>(this));
+				} else if (packed_size <= 64) {
+					return godex_new(DynamicDenseVectorStorage<PackedVariantComponent<64>>(this));
+				} else if (packed_size <= 128) {
+					return godex_new(DynamicDenseVectorStorage<PackedVariantComponent<128>>(this));
+				} else if (packed_size <= 256) {
+					return godex_new(DynamicDenseVectorStorage<PackedVariantComponent<256>>(this));
+				} else if (packed_size <= 512) {
+					return godex_new(DynamicDenseVectorStorage<PackedVariantComponent<512>>(this));
+				} else {
+					return godex_new(DynamicDenseVectorStorage<PackedVariantComponent<MAX_PACKED_SIZE>>(this));
+				}
+			}
 			// Creates DynamicDenseVector storage.
 			switch (properties.size()) {
 				case 0:
@@ -81,6 +188,15 @@ bool DynamicComponentInfo::static_get(const void *p_self, const DynamicComponent
 
 bool DynamicComponentInfo::static_set(void *p_self, const DynamicComponentInfo *p_info, const uint32_t p_index, const Variant &p_data) {
 	ERR_FAIL_COND_V_MSG(p_index >= p_info->properties.size(), false, "You can't set this data to this VariantComponent.");
+	if (p_info->is_packed()) {
+		ERR_FAIL_COND_V_MSG(p_info->properties[p_index].type != p_data.get_type(), false, "You can't set a variable with different type.");
+		uint8_t *ptr = static_get_packed_data(p_self, p_info) + p_info->packed_offsets[p_index];
+#define PACKED_SET(m_type)                                \
+	*reinterpret_cast<m_type *>(ptr) = p_data.operator m_type(); \
+	return true
+		PACKED_TYPE_SWITCH(p_data.get_type(), PACKED_SET, return false);
+#undef PACKED_SET
+	}
 	Variant *d = static_get_data(p_self, p_info);
 	ERR_FAIL_COND_V_MSG(d[p_index].get_type() != p_data.get_type(), false, "You can't set a variable with different type.");
 	d[p_index] = p_data;
@@ -89,6 +205,14 @@ bool DynamicComponentInfo::static_set(void *p_self, const DynamicComponentInfo *
 
 bool DynamicComponentInfo::static_get(const void *p_self, const DynamicComponentInfo *p_info, const uint32_t p_index, Variant &r_data) {
 	ERR_FAIL_COND_V_MSG(p_index >= p_info->properties.size(), false, "You can't set this data to this VariantComponent.");
+	if (p_info->is_packed()) {
+		const uint8_t *ptr = static_get_packed_data(p_self, p_info) + p_info->packed_offsets[p_index];
+#define PACKED_GET(m_type)                                   \
+	r_data = Variant(*reinterpret_cast<const m_type *>(ptr)); \
+	return true
+		PACKED_TYPE_SWITCH(p_info->properties[p_index].type, PACKED_GET, r_data = Variant(); return true);
+#undef PACKED_GET
+	}
 	r_data = static_get_data(p_self, p_info)[p_index];
 	return true;
 }
@@ -226,3 +350,27 @@ const Variant *DynamicComponentInfo::static_get_data(const void *p_self, const D
 	};
 	return data;
 }
+
+uint8_t *DynamicComponentInfo::static_get_packed_data(void *p_self, const DynamicComponentInfo *p_info) {
+	if (p_info->packed_size <= 16) {
+		return static_cast<PackedVariantComponent<16> *>(p_self)->data;
+	} else if (p_info->packed_size <= 32) {
+		return static_cast<PackedVariantComponent<32> *>(p_self)->data;
+	} else if (p_info->packed_size <= 64) {
+		return static_cast<PackedVariantComponent<64> *>(p_self)->data;
+	} else if (p_info->packed_size <= 128) {
+		return static_cast<PackedVariantComponent<128> *>(p_self)->data;
+	} else if (p_info->packed_size <= 256) {
+		return static_cast<PackedVariantComponent<256> *>(p_self)->data;
+	} else if (p_info->packed_size <= 512) {
+		return static_cast<PackedVariantComponent<512> *>(p_self)->data;
+	} else {
+		return static_cast<PackedVariantComponent<MAX_PACKED_SIZE> *>(p_self)->data;
+	}
+}
+
+const uint8_t *DynamicComponentInfo::static_get_packed_data(const void *p_self, const DynamicComponentInfo *p_info) {
+	return static_get_packed_data(const_cast<void *>(p_self), p_info);
+}
+
+#undef PACKED_TYPE_SWITCH
@@ -9,15 +9,45 @@ class DynamicComponentInfo {
 	uint32_t component_id = UINT32_MAX;
 	// Maps the property to the position
 	LocalVector<StringName> property_map;
+	OAHashMap<StringName, uint32_t> property_ids;
 	LocalVector<PropertyInfo> properties;
 	LocalVector<Variant> defaults;
 	StorageType storage_type = StorageType::NONE;
 
+	/// The bytes used by the packed properties, `0` when the properties are
+	/// stored as `Variant`s.
+	uint32_t packed_size = 0;
+	/// The offset of each property within the `PackedVariantComponent` data.
+	LocalVector<uint32_t> packed_offsets;
+
 	DynamicComponentInfo();
 
+	/// Called once the properties are set: if all the properties have a fixed
+	/// size type, computes the packed layout.
+	void update_layout();
+
 public:
+	/// The biggest packed component, beyond this size the properties are
+	/// stored as `Variant`s.
+	static constexpr uint32_t MAX_PACKED_SIZE = 1024;
+
+	/// Returns the bytes needed to store this type natively, or `-1` if this
+	/// type has a variable size (e.g. `String`) or can't be stored natively.
+	static int get_packed_type_size(Variant::Type p_type);
+
 	StorageBase *create_storage();
 
+	/// Returns `true` when the component is stored as a `PackedVariantComponent`.
+	bool is_packed() const {
+		return packed_size > 0;
+	}
+
+	/// Returns the offset of the property within the packed data, valid only
+	/// when `is_packed()`.
+	uint32_t get_packed_offset(uint32_t p_index) const {
+		return packed_offsets[p_index];
+	}
+
 	// TODO move all this to CPP
 
 	const LocalVector<PropertyInfo> *get_static_properties() const {
@@ -35,9 +65,9 @@ public:
 	}
 
 	uint32_t get_property_id(const StringName &p_name) const {
-		const int64_t i = property_map.find(p_name);
-		ERR_FAIL_COND_V_MSG(i == -1, UINT32_MAX, "The property " + p_name + " doesn't exists on this component " + ECS::get_component_name(component_id));
-		return i;
+		const uint32_t *i = property_ids.lookup_ptr(p_name);
+		ERR_FAIL_COND_V_MSG(i == nullptr, UINT32_MAX, "The property " + p_name + " doesn't exists on this component " + ECS::get_component_name(component_id));
+		return *i;
 	}
 
 	bool validate_type(uint32_t p_index, Variant::Type p_type) const {
@@ -55,6 +85,12 @@ public:
 
 	static Variant *static_get_data(void *p_self, const DynamicComponentInfo *p_info);
 	static const Variant *static_get_data(const void *p_self, const DynamicComponentInfo *p_info);
+
+	static uint8_t *static_get_packed_data(void *p_self, const DynamicComponentInfo *p_info);
+	static const uint8_t *static_get_packed_data(const void *p_self, const DynamicComponentInfo *p_info);
+
+	/// Writes the defaults into the packed data.
+	void init_packed_data(uint8_t *r_data) const;
 };
 
 /// The `ZeroVariantComponent` is a special type component designed for godot
@@ -151,3 +187,53 @@ void VariantComponent<SIZE>::__initialize(DynamicComponentInfo *p_info) {
 		data[i] = info->get_property_defaults()[i];
 	}
 }
+
+/// The `PackedVariantComponent` is used by the script components that have
+/// only fixed size properties (`int`, `float`, `Vector3`, `Transform3D`, ...):
+/// the properties are stored natively, at the offsets computed by the
+/// `DynamicComponentInfo`, so the component is compact and has nothing to
+/// reference count or destroy. `BYTES` is the capacity of the bucket.
+template <int BYTES>
+class PackedVariantComponent {
+	friend class DynamicComponentInfo;
+	DynamicComponentInfo *info = nullptr;
+	alignas(8) uint8_t data[BYTES];
+
+public:
+	static void _bind_methods() {}
+
+	PackedVariantComponent() = default;
+	PackedVariantComponent(const PackedVariantComponent &) = default;
+
+	void __initialize(DynamicComponentInfo *p_info) {
+#ifdef DEBUG_ENABLED
+		CRASH_COND_MSG(p_info == nullptr, "The component info can't be nullptr.");
+		CRASH_COND_MSG(p_info->is_packed() == false, "The PackedVariantComponent can't be initialized with a component info that is not packed.");
+#endif
+		info = p_info;
+		info->init_packed_data(data);
+	}
+
+public:
+	/* Common component functions used to expose component to GDScript. */
+	static bool set_by_name(void *p_self, const StringName &p_name, const Variant &p_data) {
+		PackedVariantComponent<BYTES> *self = static_cast<PackedVariantComponent<BYTES> *>(p_self);
+		ERR_FAIL_COND_V_MSG(self->info == nullptr, false, "PackedVariantComponent not initialized, you can't set the data yet: call __initialize().");
+		return DynamicComponentInfo::static_set(self, self->info, p_name, p_data);
+	}
+	static bool get_by_name(const void *p_self, const StringName &p_name, Variant &r_data) {
+		const PackedVariantComponent<BYTES> *self = static_cast<const PackedVariantComponent<BYTES> *>(p_self);
+		ERR_FAIL_COND_V_MSG(self->info == nullptr, false, "PackedVariantComponent not initialized, you can't set the data yet: call __initialize().");
+		return DynamicComponentInfo::static_get(self, self->info, p_name, r_data);
+	}
+	static bool set_by_index(void *p_self, const uint32_t p_index, const Variant &p_data) {
+		PackedVariantComponent<BYTES> *self = static_cast<PackedVariantComponent<BYTES> *>(p_self);
+		ERR_FAIL_COND_V_MSG(self->info == nullptr, false, "PackedVariantComponent not initialized, you can't set the data yet: call __initialize().");
+		return DynamicComponentInfo::static_set(self, self->info, p_index, p_data);
+	}
+	static bool get_by_index(const void *p_self, const uint32_t p_index, Variant &r_data) {
+		const PackedVariantComponent<BYTES> *self = static_cast<const PackedVariantComponent<BYTES> *>(p_self);
+		ERR_FAIL_COND_V_MSG(self->info == nullptr, false, "PackedVariantComponent not initialized, you can't set the data yet: call __initialize().");
+		return DynamicComponentInfo::static_get(self, self->info, p_index, r_data);
+	}
+};
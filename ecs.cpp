@@ -1,14 +1,17 @@
 
 #include "ecs.h"
 #include <core/config/project_settings.h>
+#include <core/debugger/engine_debugger.h>
 #include <core/io/dir_access.h>
 #include <modules/gdscript/gdscript_parser.h>
 
 #include "components/dynamic_component.h"
 #include "core/object/message_queue.h"
+#include "core/os/os.h"
 #include "modules/godot/databags/scene_tree_databag.h"
 #include "modules/godot/nodes/ecs_utilities.h"
 #include "modules/godot/nodes/ecs_world.h"
+#include "modules/godot/nodes/entity.h"
 #include "pipeline/pipeline.h"
 #include "pipeline/pipeline_commands.h"
 #include "scene/main/scene_tree.h"
@@ -144,6 +147,7 @@ void ECS::__static_destructor() {
 
 	events.reset();
 	events_info.reset();
+	EventEmitters::__static_destructor();
 
 	// Clear the system bundles static data.
 	system_bundles.reset();
@@ -225,6 +229,11 @@ bool ECS::is_component_dynamic(godex::component_id p_component_id) {
 	return components_info[p_component_id].dynamic_component_info != nullptr;
 }
 
+const DynamicComponentInfo *ECS::get_dynamic_component_info(godex::component_id p_component_id) {
+	ERR_FAIL_COND_V_MSG(verify_component_id(p_component_id) == false, nullptr, "The component " + itos(p_component_id) + " is invalid.");
+	return components_info[p_component_id].dynamic_component_info;
+}
+
 bool ECS::is_component_sharable(godex::component_id p_component_id) {
 	ERR_FAIL_COND_V_MSG(verify_component_id(p_component_id) == false, false, "The component " + itos(p_component_id) + " is invalid.");
 	return components_info[p_component_id].is_shareable;
@@ -235,6 +244,11 @@ bool ECS::storage_notify_release_write(godex::component_id p_component_id) {
 	return components_info[p_component_id].notify_release_write;
 }
 
+bool ECS::is_component_archetype(godex::component_id p_component_id) {
+	ERR_FAIL_COND_V_MSG(verify_component_id(p_component_id) == false, false, "The component " + itos(p_component_id) + " is invalid.");
+	return components_info[p_component_id].is_archetype;
+}
+
 const LocalVector<PropertyInfo> *ECS::component_get_static_properties(uint32_t p_component_id) {
 	ERR_FAIL_COND_V_MSG(verify_component_id(p_component_id) == false, nullptr, "The `component_id` is invalid: " + itos(p_component_id));
 	if (components_info[p_component_id].dynamic_component_info != nullptr) {
@@ -715,6 +729,25 @@ bool has_single_thread_only_databags(const SystemExeInfo &p_info) {
 			p_info.mutable_databags.has(SceneTreeDatabag::get_databag_id());
 }
 
+/// Returns true if at least one of these components is stored into an
+/// `ArchetypeStorage`.
+bool has_archetype_components(const RBSet<uint32_t> &p_components) {
+	for (RBSet<uint32_t>::Element *e = p_components.front(); e; e = e->next()) {
+		if (ECS::is_component_archetype(e->get())) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/// Returns true if the `System` accesses at least one component stored into an
+/// `ArchetypeStorage`.
+bool uses_archetypes(const SystemExeInfo &p_info) {
+	return has_archetype_components(p_info.immutable_components) ||
+			has_archetype_components(p_info.mutable_components) ||
+			has_archetype_components(p_info.mutable_components_storage);
+}
+
 /// Returns true if these two `Set`s have at least 1 ID in common.
 bool collides(const RBSet<uint32_t> &p_set_1, const RBSet<uint32_t> &p_set_2) {
 	for (RBSet<uint32_t>::Element *e = p_set_1.front(); e; e = e->next()) {
@@ -793,11 +826,41 @@ bool ECS::can_systems_run_in_parallel(godex::system_id p_system_a, godex::system
 		return false;
 	}
 
+	// Adding or removing a component stored into an `ArchetypeStorage` moves
+	// the rows of all the other archetype components, through the shared
+	// `ArchetypeRegistry`: it's a structural change of all these storages.
+	if (has_archetype_components(info_a.mutable_components_storage) && uses_archetypes(info_b)) {
+		// System A is moving the archetype rows System B is accessing.
+		return false;
+	}
+	if (has_archetype_components(info_b.mutable_components_storage) && uses_archetypes(info_a)) {
+		// System B is moving the archetype rows System A is accessing.
+		return false;
+	}
+
 	// Check the events
 	if (collides(info_a.events_emitters, info_b.events_emitters)) {
 		// System A is emitting the same event the System B is emitting.
 		return false;
 	}
+	if (collides(info_a.events_emitters, info_b.shared_events_emitters)) {
+		// System A is flushing the event the System B is emitting in parallel.
+		return false;
+	}
+	if (collides(info_b.events_emitters, info_a.shared_events_emitters)) {
+		// System B is flushing the event the System A is emitting in parallel.
+		return false;
+	}
+	// Note: the `System`s that emit the same event with the
+	// `SharedEventsEmitter` can run in parallel, each thread has its own buffer.
+	if (collides(info_a.shared_events_emitters, info_b.events_receivers)) {
+		// System A is emitting an event that system B is receiving.
+		return false;
+	}
+	if (collides(info_b.shared_events_emitters, info_a.events_receivers)) {
+		// System B is emitting an event that system A is receiving.
+		return false;
+	}
 	if (collides(info_a.events_emitters, info_b.events_receivers)) {
 		// System A is emitting an event that system B is receiving.
 		return false;
@@ -1042,7 +1105,9 @@ bool ECS::has_active_world_pipeline() const {
 void ECS::dispatch_active_world() {
 	if (likely(world_token.is_valid() && active_world_pipeline)) {
 		if (unlikely(ready == false)) {
-			// Ready.
+			// Ready: convert all the `Entity` nodes at once, so the instances
+			// of the same scene are inserted in batch.
+			EntityBase::create_scene_entities(active_world_node->get_tree()->get_root(), active_world);
 			active_world_node->get_tree()->get_root()->propagate_notification(NOTIFICATION_ECS_WORLD_READY);
 			ready = true;
 		}
@@ -1055,7 +1120,25 @@ void ECS::dispatch_active_world() {
 		dispatching = false;
 
 		active_world_node->post_process();
+
+		send_profiler_frame();
+	}
+}
+
+void ECS::send_profiler_frame() {
+	if (EngineDebugger::is_active() == false || active_world_pipeline->is_profiling_enabled() == false) {
+		return;
 	}
+
+	const uint64_t now = OS::get_singleton()->get_ticks_usec();
+	if (now - profiler_frame_sent_usec < PROFILER_FRAME_SEND_INTERVAL_USEC) {
+		return;
+	}
+	profiler_frame_sent_usec = now;
+
+	Array data;
+	data.push_back(PipelineECS::profiler_frame_to_dictionary(active_world_pipeline, 0));
+	EngineDebugger::get_singleton()->send_message("godex:profiler_frame", data);
 }
 
 void ECS::ecs_init() {
@@ -1118,6 +1201,7 @@ uint32_t ECS::register_or_update_script_component(
 	info = components_info[id].dynamic_component_info;
 
 	info->property_map.resize(p_properties.size());
+	info->property_ids.clear();
 	info->properties.resize(p_properties.size());
 	info->defaults.resize(p_properties.size());
 
@@ -1152,11 +1236,13 @@ uint32_t ECS::register_or_update_script_component(
 		}
 
 		info->property_map[i] = p_properties[i].property.name;
+		info->property_ids.set(p_properties[i].property.name, i);
 		info->properties[i] = p_properties[i].property;
 		info->defaults[i] = p_properties[i].default_value;
 	}
 
 	info->storage_type = p_storage_type;
+	info->update_layout();
 
 	// Extract the spawners.
 	components_info[id].spawners.clear();
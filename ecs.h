@@ -57,6 +57,8 @@ struct ComponentInfo {
 	bool notify_release_write = false;
 	bool is_shareable = false;
 	LocalVector<godex::spawner_id> spawners;
+	/// `true` when the component is stored into an `ArchetypeStorage`.
+	bool is_archetype = false;
 
 	DataAccessorFuncs accessor_funcs;
 };
@@ -200,8 +202,13 @@ private:
 	Pipeline *active_world_pipeline = nullptr;
 	Token world_token;
 	bool dispatching = false;
+	/// When the last profiled frame was sent to the editor.
+	uint64_t profiler_frame_sent_usec = 0;
 
 public:
+	/// The profiled frames are sent to the editor at most once per interval.
+	static constexpr uint64_t PROFILER_FRAME_SEND_INTERVAL_USEC = 500000;
+
 	/// Clear the internal memory before the complete shutdown.
 	static void __static_destructor();
 
@@ -238,8 +245,14 @@ public:
 	static godex::component_id get_component_id(StringName p_component_name);
 	static StringName get_component_name(godex::component_id p_component_id);
 	static bool is_component_dynamic(godex::component_id p_component_id);
+	/// Returns the info of the dynamic component, or `nullptr` when the
+	/// component is a native one.
+	static const DynamicComponentInfo *get_dynamic_component_info(godex::component_id p_component_id);
 	static bool is_component_sharable(godex::component_id p_component_id);
 	static bool storage_notify_release_write(godex::component_id p_component_id);
+	/// Returns `true` when the component is stored into an `ArchetypeStorage`:
+	/// adding or removing it moves the other archetype components too.
+	static bool is_component_archetype(godex::component_id p_component_id);
 
 	static const LocalVector<PropertyInfo> *component_get_static_properties(godex::component_id p_component_id);
 	static Variant get_component_property_default(godex::component_id p_component_id, StringName p_property_name);
@@ -559,6 +572,9 @@ public:
 
 private:
 	void dispatch_active_world();
+	/// Sends the last profiled frame of the active pipeline to the editor,
+	/// through the debugger: see `GodexDebuggerPlugin`.
+	void send_profiler_frame();
 	void ecs_init();
 };
 
@@ -588,6 +604,7 @@ void ECS::register_component(StorageBase *(*create_storage)()) {
 	bool notify_release_write = false;
 	bool shared_component_storage = false;
 	bool steady = false;
+	bool archetype = false;
 	{
 		// This storage wants to be notified once the write object is released?
 		StorageBase *s = create_storage();
@@ -599,6 +616,7 @@ void ECS::register_component(StorageBase *(*create_storage)()) {
 		}
 
 		steady = s->is_steady();
+		archetype = dynamic_cast<ArchetypeStorageBase *>(s) != nullptr;
 
 		delete s;
 	}
@@ -652,6 +670,7 @@ void ECS::register_component(StorageBase *(*create_storage)()) {
 					notify_release_write,
 					shared_component_storage,
 					tmp_spawners,
+					archetype,
 					DataAccessorFuncs{
 							C::get_static_properties,
 							C::get_property_list,
@@ -72,7 +72,21 @@ enum class StorageType {
 	BATCH_DENSE_VECTOR,
 };
 
+/// The `EntityID` is composed by the `Entity` index, used to index the storages,
+/// and the generation, incremented each time the index is reused: this allows
+/// to detect the stale `EntityID`s, see `World::is_entity_alive`.
+///
+/// The `EntityID` converts implicitly to its index, use `get_raw_id` to get the
+/// full ID (for example to pass it to a script). Comparing it, either with
+/// another `EntityID` or with a raw `uint32_t` ID, compares the full ID: so
+/// `entity != UINT32_MAX` is the same as `entity.is_valid()`.
 class EntityID {
+public:
+	static constexpr uint32_t INDEX_BITS = 24;
+	static constexpr uint32_t INDEX_MASK = (1 << INDEX_BITS) - 1;
+	static constexpr uint32_t GENERATION_MASK = UINT32_MAX >> INDEX_BITS;
+
+private:
 	uint32_t id = UINT32_MAX;
 
 public:
@@ -81,11 +95,14 @@ public:
 
 	EntityID(const EntityID &) = default;
 
-	EntityID(uint32_t p_index) :
-			id(p_index) {}
+	EntityID(uint32_t p_raw_id) :
+			id(p_raw_id) {}
 
-	EntityID(Variant p_index) :
-			id(p_index.operator unsigned int()) {}
+	EntityID(uint32_t p_index, uint32_t p_generation) :
+			id((p_index & INDEX_MASK) | ((p_generation & GENERATION_MASK) << INDEX_BITS)) {}
+
+	EntityID(Variant p_raw_id) :
+			id(p_raw_id.operator unsigned int()) {}
 
 	bool is_null() const {
 		return id == UINT32_MAX;
@@ -95,16 +112,36 @@ public:
 		return id != UINT32_MAX;
 	}
 
+	uint32_t get_index() const {
+		return id & INDEX_MASK;
+	}
+
+	uint32_t get_generation() const {
+		return id >> INDEX_BITS;
+	}
+
+	uint32_t get_raw_id() const {
+		return id;
+	}
+
 	bool operator==(const EntityID &p_other) const {
 		return id == p_other.id;
 	}
 
-	bool operator==(uint32_t p_naked_index) const {
-		return id == p_naked_index;
+	bool operator!=(const EntityID &p_other) const {
+		return id != p_other.id;
+	}
+
+	bool operator==(uint32_t p_raw_id) const {
+		return id == p_raw_id;
+	}
+
+	bool operator!=(uint32_t p_raw_id) const {
+		return id != p_raw_id;
 	}
 
 	operator uint32_t() const {
-		return id;
+		return id & INDEX_MASK;
 	}
 
 	operator Variant() const {
@@ -137,6 +174,10 @@ constexpr databag_id DATABAG_NONE = UINT32_MAX;
 typedef uint32_t event_id;
 constexpr event_id EVENT_NONE = UINT32_MAX;
 
+/// The interned name of an events emitter, see `EventEmitters`.
+typedef uint32_t emitter_id;
+constexpr emitter_id EMITTER_NONE = UINT32_MAX;
+
 typedef uint32_t system_id;
 constexpr system_id SYSTEM_NONE = UINT32_MAX;
 
@@ -3,7 +3,7 @@
 #include "../ecs.h"
 #include "../storage/event_storage.h"
 
-#define EVENT(m_class)                                                                \
+#define EVENT_INTERNAL(m_class, m_persistent)                                         \
 	ECSCLASS(m_class)                                                                 \
 	friend class World;                                                               \
                                                                                       \
@@ -26,7 +26,9 @@ public:
 private:                                                                              \
 	/* Storages */                                                                    \
 	static _FORCE_INLINE_ EventStorage<m_class> *create_storage() {                   \
-		return new EventStorage<m_class>;                                             \
+		EventStorage<m_class> *storage = new EventStorage<m_class>;                   \
+		storage->set_persistent(m_persistent);                                        \
+		return storage;                                                               \
 	}                                                                                 \
 	static _FORCE_INLINE_ void destroy_storage(EventStorage<m_class> *p_storage) {    \
 		delete p_storage;                                                             \
@@ -42,3 +44,11 @@ private:
                                                                                       \
 public:                                                                               \
 	m_class() = default;
+
+/// Register an event: the events are flushed each time the emitter runs.
+#define EVENT(m_class) EVENT_INTERNAL(m_class, false)
+
+/// Register an event that is kept until all the `EventsReceiver`s read it:
+/// each receiver gets every event exactly once, so it can run at a lower rate
+/// than the emitter (e.g. in another dispatcher) without losing events.
+#define PERSISTENT_EVENT(m_class) EVENT_INTERNAL(m_class, true)
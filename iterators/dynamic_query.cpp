@@ -1,7 +1,9 @@
 #include "dynamic_query.h"
 
+#include "../components/dynamic_component.h"
 #include "../ecs.h"
 #include "../modules/godot/nodes/ecs_world.h"
+#include "../pipeline/pipeline_profiler.h"
 
 using godex::DynamicQuery;
 
@@ -22,6 +24,12 @@ void DynamicQuery::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("next"), &DynamicQuery::next);
 
+	ClassDB::bind_method(D_METHOD("next_chunk", "max_count"), &DynamicQuery::next_chunk);
+	ClassDB::bind_method(D_METHOD("get_chunk_size"), &DynamicQuery::get_chunk_size);
+	ClassDB::bind_method(D_METHOD("get_chunk_entities"), &DynamicQuery::get_chunk_entities);
+	ClassDB::bind_method(D_METHOD("get_column", "component_index", "property"), &DynamicQuery::get_column);
+	ClassDB::bind_method(D_METHOD("set_column", "component_index", "property", "column"), &DynamicQuery::set_column);
+
 	ClassDB::bind_method(D_METHOD("has", "entity_index"), &DynamicQuery::script_has);
 	ClassDB::bind_method(D_METHOD("fetch", "entity_index"), &DynamicQuery::script_fetch);
 
@@ -170,6 +178,7 @@ void DynamicQuery::initiate_process(World *p_world) {
 	current_entity = EntityID();
 	iterator_index = 0;
 	entities.count = 0;
+	chunk.clear();
 
 	ERR_FAIL_COND(is_valid() == false);
 
@@ -229,10 +238,14 @@ void DynamicQuery::conclude_process(World *p_world) {
 		}
 	}
 
+	PipelineProfiler::count_entities(fetched_count);
+	fetched_count = 0;
+
 	// Clear any component reference.
 	storages.clear();
 	iterator_index = 0;
 	entities.count = 0;
+	chunk.clear();
 }
 
 void DynamicQuery::release_world(World *p_world) {
@@ -249,6 +262,7 @@ bool DynamicQuery::next() {
 
 		if (has(entity_id)) {
 			fetch(entity_id);
+			fetched_count += 1;
 			return true;
 		}
 	}
@@ -257,6 +271,247 @@ bool DynamicQuery::next() {
 	return false;
 }
 
+uint32_t DynamicQuery::next_chunk(uint32_t p_max_count) {
+	chunk.clear();
+	while (iterator_index < entities.count && chunk.size() < p_max_count) {
+		const EntityID entity_id = entities.entities[iterator_index];
+		iterator_index += 1;
+
+		if (has(entity_id)) {
+			chunk.push_back(entity_id);
+		}
+	}
+	fetched_count += chunk.size();
+	return chunk.size();
+}
+
+uint32_t DynamicQuery::get_chunk_size() const {
+	return chunk.size();
+}
+
+PackedInt32Array DynamicQuery::get_chunk_entities() const {
+	PackedInt32Array ret;
+	ret.resize(chunk.size());
+	int32_t *ptrw = ret.ptrw();
+	for (uint32_t i = 0; i < chunk.size(); i += 1) {
+		ptrw[i] = chunk[i].get_raw_id();
+	}
+	return ret;
+}
+
+uint32_t DynamicQuery::get_column_property(uint32_t p_element_index, const StringName &p_property) const {
+	ERR_FAIL_UNSIGNED_INDEX_V_MSG(p_element_index, elements.size(), UINT32_MAX, "The component index " + itos(p_element_index) + " is not part of this query.");
+	const LocalVector<PropertyInfo> *properties = ECS::component_get_static_properties(elements[p_element_index].id);
+	ERR_FAIL_COND_V(properties == nullptr, UINT32_MAX);
+	for (uint32_t i = 0; i < properties->size(); i += 1) {
+		if ((*properties)[i].name == p_property) {
+			return i;
+		}
+	}
+	ERR_FAIL_V_MSG(UINT32_MAX, "The component " + elements[p_element_index].name + " doesn't have the property " + p_property + ".");
+}
+
+const void *DynamicQuery::get_chunk_component(uint32_t p_element_index, uint32_t p_chunk_index) const {
+	const StorageBase *storage = storages[p_element_index];
+	if (storage == nullptr || storage->has(chunk[p_chunk_index]) == false) {
+		return nullptr;
+	}
+	return storage->get_ptr(chunk[p_chunk_index], space);
+}
+
+/// Returns the info of the component when its properties are packed, so the
+/// columns can copy the typed values without going through `Variant`.
+static const DynamicComponentInfo *get_packed_info(const godex::component_id p_component_id) {
+	const DynamicComponentInfo *info = ECS::get_dynamic_component_info(p_component_id);
+	return info != nullptr && info->is_packed() ? info : nullptr;
+}
+
+/// Returns the packed array type used for the columns of the property type,
+/// `Variant::ARRAY` when the type has no packed array.
+static Variant::Type get_column_type(Variant::Type p_property_type) {
+	switch (p_property_type) {
+		case Variant::INT:
+			return Variant::PACKED_INT64_ARRAY;
+		case Variant::FLOAT:
+			return Variant::PACKED_FLOAT64_ARRAY;
+		case Variant::STRING:
+			return Variant::PACKED_STRING_ARRAY;
+		case Variant::VECTOR2:
+			return Variant::PACKED_VECTOR2_ARRAY;
+		case Variant::VECTOR3:
+			return Variant::PACKED_VECTOR3_ARRAY;
+		case Variant::COLOR:
+			return Variant::PACKED_COLOR_ARRAY;
+		default:
+			return Variant::ARRAY;
+	}
+}
+
+template <class PackedArray, class T>
+static Variant read_column(const godex::component_id p_component_id, const uint32_t p_property, const Variant &p_default, const LocalVector<const void *> &p_components) {
+	PackedArray column;
+	column.resize(p_components.size());
+	T *ptrw = column.ptrw();
+	const T def = p_default;
+
+	const DynamicComponentInfo *packed = get_packed_info(p_component_id);
+	if (packed != nullptr) {
+		// The value is stored natively, copy it.
+		const uint32_t offset = packed->get_packed_offset(p_property);
+		for (uint32_t i = 0; i < p_components.size(); i += 1) {
+			if (p_components[i] != nullptr) {
+				memcpy(ptrw + i, DynamicComponentInfo::static_get_packed_data(p_components[i], packed) + offset, sizeof(T));
+			} else {
+				ptrw[i] = def;
+			}
+		}
+		return column;
+	}
+
+	Variant value;
+	for (uint32_t i = 0; i < p_components.size(); i += 1) {
+		if (p_components[i] != nullptr && ECS::unsafe_component_get_by_index(p_component_id, p_components[i], p_property, value)) {
+			ptrw[i] = value;
+		} else {
+			ptrw[i] = def;
+		}
+	}
+	return column;
+}
+
+template <class PackedArray, class T>
+static bool write_column(const godex::component_id p_component_id, const uint32_t p_property, const PackedArray &p_column, const LocalVector<void *> &p_components) {
+	ERR_FAIL_COND_V_MSG(p_column.size() != int(p_components.size()), false, "The column size " + itos(p_column.size()) + " is different from the chunk size " + itos(p_components.size()) + ".");
+	const T *ptr = p_column.ptr();
+
+	const DynamicComponentInfo *packed = get_packed_info(p_component_id);
+	if (packed != nullptr) {
+		// The value is stored natively, copy it.
+		const uint32_t offset = packed->get_packed_offset(p_property);
+		for (uint32_t i = 0; i < p_components.size(); i += 1) {
+			if (p_components[i] != nullptr) {
+				memcpy(DynamicComponentInfo::static_get_packed_data(p_components[i], packed) + offset, ptr + i, sizeof(T));
+			}
+		}
+		return true;
+	}
+
+	bool success = true;
+	for (uint32_t i = 0; i < p_components.size(); i += 1) {
+		if (p_components[i] != nullptr) {
+			success &= ECS::unsafe_component_set_by_index(p_component_id, p_components[i], p_property, ptr[i]);
+		}
+	}
+	ERR_FAIL_COND_V_MSG(success == false, false, "The column of the component " + ECS::get_component_name(p_component_id) + " was not fully written.");
+	return true;
+}
+
+static bool write_array_column(const godex::component_id p_component_id, const uint32_t p_property, const Array &p_column, const LocalVector<void *> &p_components) {
+	ERR_FAIL_COND_V_MSG(p_column.size() != int(p_components.size()), false, "The column size " + itos(p_column.size()) + " is different from the chunk size " + itos(p_components.size()) + ".");
+	bool success = true;
+	for (uint32_t i = 0; i < p_components.size(); i += 1) {
+		if (p_components[i] != nullptr) {
+			success &= ECS::unsafe_component_set_by_index(p_component_id, p_components[i], p_property, p_column[i]);
+		}
+	}
+	ERR_FAIL_COND_V_MSG(success == false, false, "The column of the component " + ECS::get_component_name(p_component_id) + " was not fully written.");
+	return true;
+}
+
+Variant DynamicQuery::get_column(uint32_t p_element_index, const StringName &p_property) const {
+	const uint32_t property = get_column_property(p_element_index, p_property);
+	ERR_FAIL_COND_V(property == UINT32_MAX, Variant());
+	ERR_FAIL_COND_V_MSG(elements[p_element_index].mode == WITHOUT_MODE, Variant(), "The component " + elements[p_element_index].name + " is excluded from this query.");
+
+	const godex::component_id id = elements[p_element_index].id;
+	const PropertyInfo &info = (*ECS::component_get_static_properties(id))[property];
+	const Variant def = ECS::get_component_property_default(id, p_property);
+
+	// Resolve the components once.
+	LocalVector<const void *> components;
+	components.resize(chunk.size());
+	for (uint32_t i = 0; i < chunk.size(); i += 1) {
+		components[i] = get_chunk_component(p_element_index, i);
+	}
+
+	switch (info.type) {
+		case Variant::INT:
+			return read_column<PackedInt64Array, int64_t>(id, property, def, components);
+		case Variant::FLOAT:
+			return read_column<PackedFloat64Array, double>(id, property, def, components);
+		case Variant::STRING:
+			return read_column<PackedStringArray, String>(id, property, def, components);
+		case Variant::VECTOR2:
+			return read_column<PackedVector2Array, Vector2>(id, property, def, components);
+		case Variant::VECTOR3:
+			return read_column<PackedVector3Array, Vector3>(id, property, def, components);
+		case Variant::COLOR:
+			return read_column<PackedColorArray, Color>(id, property, def, components);
+		default: {
+			Array column;
+			column.resize(components.size());
+			Variant value;
+			for (uint32_t i = 0; i < components.size(); i += 1) {
+				if (components[i] != nullptr && ECS::unsafe_component_get_by_index(id, components[i], property, value)) {
+					column[i] = value;
+				} else {
+					column[i] = def;
+				}
+			}
+			return column;
+		}
+	}
+}
+
+bool DynamicQuery::set_column(uint32_t p_element_index, const StringName &p_property, const Variant &p_column) {
+	const uint32_t property = get_column_property(p_element_index, p_property);
+	ERR_FAIL_COND_V(property == UINT32_MAX, false);
+	ERR_FAIL_COND_V_MSG(elements[p_element_index].mutability == false, false, "The component " + elements[p_element_index].name + " is not mutable.");
+	ERR_FAIL_COND_V_MSG(p_column.is_array() == false, false, "The column must be an array.");
+
+	const godex::component_id id = elements[p_element_index].id;
+	const PropertyInfo &info = (*ECS::component_get_static_properties(id))[property];
+
+	// Validate the column type once, before writing anything.
+	const Variant::Type column_type = get_column_type(info.type);
+	if (p_column.get_type() == Variant::ARRAY) {
+		if (info.type != Variant::NIL) {
+			const Array array = p_column;
+			for (int i = 0; i < array.size(); i += 1) {
+				ERR_FAIL_COND_V_MSG(array[i].get_type() != info.type, false, "The column element " + itos(i) + " is a " + Variant::get_type_name(array[i].get_type()) + " but the property " + p_property + " is a " + Variant::get_type_name(info.type) + ".");
+			}
+		}
+	} else if (info.type != Variant::NIL) {
+		ERR_FAIL_COND_V_MSG(p_column.get_type() != column_type, false, "The column is a " + Variant::get_type_name(p_column.get_type()) + " but the property " + p_property + " needs a " + Variant::get_type_name(column_type) + ".");
+	}
+
+	LocalVector<void *> components;
+	components.resize(chunk.size());
+	for (uint32_t i = 0; i < chunk.size(); i += 1) {
+		StorageBase *storage = storages[p_element_index];
+		// Taken using the mutable `get_ptr`, like `fetch` does for the mutable
+		// components.
+		components[i] = storage != nullptr && storage->has(chunk[i]) ? storage->get_ptr(chunk[i], space) : nullptr;
+	}
+
+	switch (p_column.get_type()) {
+		case Variant::PACKED_INT64_ARRAY:
+			return write_column<PackedInt64Array, int64_t>(id, property, p_column, components);
+		case Variant::PACKED_FLOAT64_ARRAY:
+			return write_column<PackedFloat64Array, double>(id, property, p_column, components);
+		case Variant::PACKED_STRING_ARRAY:
+			return write_column<PackedStringArray, String>(id, property, p_column, components);
+		case Variant::PACKED_VECTOR2_ARRAY:
+			return write_column<PackedVector2Array, Vector2>(id, property, p_column, components);
+		case Variant::PACKED_VECTOR3_ARRAY:
+			return write_column<PackedVector3Array, Vector3>(id, property, p_column, components);
+		case Variant::PACKED_COLOR_ARRAY:
+			return write_column<PackedColorArray, Color>(id, property, p_column, components);
+		default:
+			return write_array_column(id, property, p_column, components);
+	}
+}
+
 bool DynamicQuery::script_has(uint32_t p_id) const {
 	return has(p_id);
 }
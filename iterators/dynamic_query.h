@@ -47,6 +47,11 @@ class DynamicQuery : public GodexWorldFetcher {
 	uint32_t iterator_index = 0;
 	EntityID current_entity;
 	EntitiesBuffer entities = EntitiesBuffer(0, nullptr);
+	/// The `Entities` fetched during this process, reported to the
+	/// `PipelineProfiler` by `conclude_process`.
+	uint32_t fetched_count = 0;
+	/// The `Entities` collected by the last `next_chunk`.
+	LocalVector<EntityID> chunk;
 
 	static void _bind_methods();
 
@@ -95,6 +100,34 @@ public:
 	/// Advance entity
 	bool next();
 
+	// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Chunk
+
+	/// Collects up to `p_max_count` of the next `Entities`, so their components
+	/// can be read and written in bulk, using `get_column` and `set_column`.
+	/// Returns the `Entities` count of this chunk, `0` when nothing is left.
+	/// Shares the iterator with `next`.
+	uint32_t next_chunk(uint32_t p_max_count);
+	uint32_t get_chunk_size() const;
+	/// Returns the raw ids of the chunk `Entities`, generation included.
+	PackedInt32Array get_chunk_entities() const;
+
+	/// Returns the property `p_property` of the component `p_element_index` for
+	/// all the `Entities` of the chunk, as a packed array when the type allows
+	/// it (e.g. `PackedVector3Array`) or as an `Array`.
+	/// The `Entities` without this component get the property default.
+	Variant get_column(uint32_t p_element_index, const StringName &p_property) const;
+
+	/// Writes back the column, that must have the chunk size; the component
+	/// must be fetched mutable. The `Entities` without this component are
+	/// skipped. The column type is validated against the property type before
+	/// anything is written.
+	bool set_column(uint32_t p_element_index, const StringName &p_property, const Variant &p_column);
+
+private:
+	uint32_t get_column_property(uint32_t p_element_index, const StringName &p_property) const;
+	const void *get_chunk_component(uint32_t p_element_index, uint32_t p_chunk_index) const;
+
+public:
 	// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Random Access
 	bool script_has(uint32_t p_id) const;
 	bool has(EntityID p_id) const;
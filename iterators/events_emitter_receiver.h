@@ -5,13 +5,22 @@
 
 #define EMITTER(str) typestring_is(#str)
 
+/// Returns the interned id of the emitter `EMITTER(Name)`, resolved only once.
+template <typename EmitterName>
+godex::emitter_id get_emitter_id() {
+	static const godex::emitter_id id = EventEmitters::intern(String(EmitterName::data()));
+	return id;
+}
+
 /// Utility to emit an ECS event. This can be used by c++ systems:
 /// ```
 /// void my_emitter_system(EventsEmitter<MyEvent> &p_emitter){
 ///		p_emitter.emit("EmitterName1", MyEvent());
-///		p_emitter.emit("EmitterName2", MyEvent());
+///		p_emitter.emit<EMITTER(EmitterName2)>(MyEvent());
 /// }
 /// ```
+/// Prefer the `EMITTER` version: the emitter name is resolved at compile time,
+/// so emitting is just an array access.
 template <class E>
 class EventsEmitter {
 	EventStorage<E> *storage = nullptr;
@@ -30,6 +39,70 @@ public:
 	void emit(const String &p_emitter_name, const E &p_event) {
 		storage->add_event(p_emitter_name, p_event);
 	}
+
+	void emit(godex::emitter_id p_emitter, const E &p_event) {
+		storage->add_event(p_emitter, p_event);
+	}
+
+	template <typename EmitterName>
+	void emit(const E &p_event) {
+		storage->add_event(get_emitter_id<EmitterName>(), p_event);
+	}
+};
+
+/// Like the `EventsEmitter`, but many `System`s taking the same
+/// `SharedEventsEmitter<E>` can run in parallel within the same stage:
+/// ```
+/// void my_emitter_system(SharedEventsEmitter<MyEvent> &p_emitter){
+///		p_emitter.emit<EMITTER(EmitterName1)>(MyEvent());
+/// }
+/// ```
+/// Each thread appends its events to its own buffer; the buffers are merged at
+/// the end of the stage following the `System`s order within the stage, so the
+/// events order doesn't depend on the threads.
+/// The events are flushed once per stage, rather than per `System`.
+template <class E>
+class SharedEventsEmitter {
+	EventStorage<E> *storage = nullptr;
+	/// `true` when this emitter opened the shared emission, because the
+	/// `System` is not dispatched by a `Pipeline`.
+	bool owns_emission = false;
+
+public:
+	void initiate_process(World *p_world) {
+		storage = p_world->get_events_storage<E>();
+		if (storage->is_shared_emission_open() == false) {
+			ThreadPool *thread_pool = p_world->get_thread_pool();
+			storage->begin_shared_emission(thread_pool ? thread_pool->get_threads_count() + 1 : 1);
+			owns_emission = true;
+		}
+	}
+
+	void conclude_process(World *p_world) {
+		if (owns_emission) {
+			storage->end_shared_emission();
+			owns_emission = false;
+		}
+	}
+
+	void release_world() {
+		storage = nullptr;
+	}
+
+	void emit(const String &p_emitter_name, const E &p_event) {
+		const godex::emitter_id id = EventEmitters::get_id(p_emitter_name);
+		ERR_FAIL_COND_MSG(id == godex::EMITTER_NONE, String("The emitter `") + p_emitter_name + "` for the event `" + E::get_class_static() + "` doesn't exists. No systems are fetching from this emitter.");
+		storage->add_shared_event(id, p_event);
+	}
+
+	void emit(godex::emitter_id p_emitter, const E &p_event) {
+		storage->add_shared_event(p_emitter, p_event);
+	}
+
+	template <typename EmitterName>
+	void emit(const E &p_event) {
+		storage->add_shared_event(get_emitter_id<EmitterName>(), p_event);
+	}
 };
 
 /// Utility that allow to fetch the events from the world. You can even use it
@@ -41,14 +114,22 @@ public:
 ///		}
 /// }
 /// ```
+/// When the event is a `PERSISTENT_EVENT`, the receiver fetches only the
+/// events it didn't read yet, no matter how many times the emitter run since
+/// the last time; so it can run at a lower rate without losing events.
 template <class E, typename EmitterName>
 class EventsReceiver {
-	const LocalVector<E> *emitter_storage = nullptr;
+	EventStorage<E> *storage = nullptr;
+	/// Used only when the storage is persistent.
+	EventReader reader;
+
+	const E *events = nullptr;
+	uint32_t events_count = 0;
 
 public:
 	struct Iterator {
 	private:
-		const LocalVector<E> *emitter_storage = nullptr;
+		const E *events = nullptr;
 
 	public:
 		using iterator_category = std::forward_iterator_tag;
@@ -56,16 +137,12 @@ public:
 		using value_type = const E *;
 		uint32_t index = 0;
 
-		Iterator(const LocalVector<E> *p_emitter_storage, uint32_t p_index) :
-				emitter_storage(p_emitter_storage),
+		Iterator(const E *p_events, uint32_t p_index) :
+				events(p_events),
 				index(p_index) {}
 
-		bool is_valid() const {
-			return index < emitter_storage->size();
-		}
-
 		value_type operator*() const {
-			return emitter_storage->ptr() + index;
+			return events + index;
 		}
 
 		Iterator &operator++() {
@@ -84,30 +161,64 @@ public:
 	};
 
 public:
+	EventsReceiver() = default;
+	EventsReceiver(const EventsReceiver &) = delete;
+
+	~EventsReceiver() {
+		if (reader.attached) {
+			storage->remove_reader(&reader);
+		}
+	}
+
+	/// Attaches the read cursor, when the storage is persistent.
+	void prepare_world(World *p_world) {
+		storage = p_world->get_events_storage<E>();
+		if (storage != nullptr && storage->is_persistent()) {
+			storage->add_reader(&reader, get_emitter_id<EmitterName>());
+		}
+	}
+
 	void initiate_process(World *p_world) {
-		EventStorage<E> *storage = p_world->get_events_storage<E>();
-		if (storage != nullptr) {
-			emitter_storage = storage->get_events(get_emitter_name());
+		events = nullptr;
+		events_count = 0;
+		storage = p_world->get_events_storage<E>();
+		if (storage == nullptr) {
+			return;
+		}
+		if (reader.attached) {
+			events = storage->read(&reader, events_count);
+		} else {
+			const LocalVector<E> *emitter_events = storage->get_events(get_emitter_id<EmitterName>());
+			if (emitter_events != nullptr) {
+				events = emitter_events->ptr();
+				events_count = emitter_events->size();
+			}
 		}
 	}
 
 	void release_world() {
-		emitter_storage = nullptr;
+		events = nullptr;
+		events_count = 0;
 	}
 
 	static String get_emitter_name() {
 		return String(EmitterName::data());
 	}
 
+	/// Returns the number of events to fetch.
+	uint32_t size() const {
+		return events_count;
+	}
+
 	/// Returns the forward iterator to fetch the events.
 	Iterator begin() {
-		ERR_FAIL_COND_V_MSG(emitter_storage == nullptr, Iterator(emitter_storage, 0), "The emitter `" + E::get_class_static() + "::" + get_emitter_name() + "` storage doesn't exist.");
-		return Iterator(emitter_storage, 0);
+		ERR_FAIL_COND_V_MSG(storage == nullptr, Iterator(events, 0), "The emitter `" + E::get_class_static() + "::" + get_emitter_name() + "` storage doesn't exist.");
+		return Iterator(events, 0);
 	}
 
 	/// Used to know the last element of the `Iterator`.
 	Iterator end() {
-		ERR_FAIL_COND_V_MSG(emitter_storage == nullptr, Iterator(emitter_storage, 0), "The emitter `" + E::get_class_static() + "::" + get_emitter_name() + "` storage doesn't exist.");
-		return Iterator(emitter_storage, emitter_storage->size());
+		ERR_FAIL_COND_V_MSG(storage == nullptr, Iterator(events, 0), "The emitter `" + E::get_class_static() + "::" + get_emitter_name() + "` storage doesn't exist.");
+		return Iterator(events, events_count);
 	}
 };
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../pipeline/pipeline_profiler.h"
+#include "../storage/archetype_storage.h"
 #include "../storage/storage.h"
 #include "../systems/system.h"
 #include "../world/world.h"
@@ -498,6 +500,50 @@ constexpr fetch_element_type<S, 0, Cs...> get(const QueryResultTuple<Cs...> &tup
 	return get_impl<S>(tuple);
 }
 
+// ----------------------------------------------------------------- Storage Type
+
+template <class T>
+class DenseVectorStorage;
+
+/// The storage type declared by the component (using the `COMPONENT` macro),
+/// or `Storage<C>` if the component uses a custom storage.
+template <class C, class = void>
+struct component_storage_type {
+	using type = Storage<C>;
+};
+
+template <class C>
+struct component_storage_type<C, std::void_t<typename C::storage_type>> {
+	using type = typename C::storage_type;
+};
+
+template <class T>
+class TagStorage;
+
+/// `true` when the component is declared with an `ArchetypeStorage`.
+template <class C>
+struct is_archetype_component {
+	static constexpr bool value = std::is_same<typename component_storage_type<std::remove_const_t<C>>::type, ArchetypeStorage<std::remove_const_t<C>>>::value;
+};
+
+/// `true` when the component is declared with a `TagStorage`.
+template <class C>
+struct is_tag_component {
+	static constexpr bool value = std::is_same<typename component_storage_type<std::remove_const_t<C>>::type, TagStorage<std::remove_const_t<C>>>::value;
+};
+
+/// The first of the components `Cs` declared with a `TagStorage`, or `void`.
+/// The filtered components (like `Maybe<C>`) are not taken into account.
+template <class... Cs>
+struct first_tag_component {
+	using type = void;
+};
+
+template <class C, class... Cs>
+struct first_tag_component<C, Cs...> {
+	using type = std::conditional_t<is_tag_component<C>::value, std::remove_const_t<C>, typename first_tag_component<Cs...>::type>;
+};
+
 // --------------------------------------------------------------- Query Storages
 
 /// `QueryStorage` specialization with 0 template arguments.
@@ -525,6 +571,11 @@ struct QueryStorage {
 		// Nothing to fetch.
 	}
 
+	template <class... Qs>
+	void fetch_row(uint32_t p_archetype, uint32_t p_row, EntityID p_id, Space p_mode, QueryResultTuple<Qs...> &r_result) const {
+		// Nothing to fetch.
+	}
+
 	static void get_components(SystemExeInfo &r_info, const bool p_force_immutable = false) {}
 };
 
@@ -565,6 +616,12 @@ struct QueryStorage<I, EntityID, Cs...> : public QueryStorage<I + 1, Cs...> {
 		QueryStorage<I + 1, Cs...>::fetch(p_id, p_mode, r_result);
 	}
 
+	template <class... Qs>
+	void fetch_row(uint32_t p_archetype, uint32_t p_row, EntityID p_id, Space p_mode, QueryResultTuple<Qs...> &r_result) const {
+		set<I>(r_result, p_id);
+		QueryStorage<I + 1, Cs...>::fetch_row(p_archetype, p_row, p_id, p_mode, r_result);
+	}
+
 	static void get_components(SystemExeInfo &r_info, const bool p_force_immutable = false) {
 		QueryStorage<I + 1, Cs...>::get_components(r_info);
 	}
@@ -768,49 +825,89 @@ struct QueryStorage<I, Not<C>, Cs...> : public QueryStorage<I + 1, Cs...> {
 template <std::size_t I, class C, class... Cs>
 struct QueryStorage<I, Changed<C>, Cs...> : public QueryStorage<I + 1, Cs...> {
 	World *world = nullptr;
-	EntityList changed;
 	Storage<C> *storage = nullptr;
 
+	/// The changes with a tick greater than this are new for this query.
+	ChangeTick last_seen_tick = 0;
+	/// The range of ticks taken as changed by the current process.
+	ChangeTick from_tick = 0;
+	ChangeTick to_tick = 0;
+	/// The changes notified while the world notification is not active are
+	/// ignored: this is the range of ticks to ignore.
+	ChangeTick inactive_from_tick = 0;
+	ChangeTick inactive_to_tick = 0;
+	bool notification_active = true;
+
+	/// The changed `Entities`, collected by `initiate_process`.
+	LocalVector<EntityID> changed;
+
 	QueryStorage(World *p_world) :
 			QueryStorage<I + 1, Cs...>(p_world),
 			world(p_world) {
 		Storage<C> *s = p_world->get_storage<C>();
 		if (s) {
-			s->add_change_listener(&changed);
-		}
-	}
-	~QueryStorage() {
-		Storage<C> *s = world->get_storage<C>();
-		if (s) {
-			s->remove_change_listener(&changed);
+			// Only the changes notified from now on are taken.
+			last_seen_tick = s->advance_change_tick();
 		}
 	}
 
 	void initiate_process(World *p_world) {
 		QueryStorage<I + 1, Cs...>::initiate_process(p_world);
 		storage = p_world->get_storage<C>();
-		// Make sure this doesn't change at this point.
-		changed.freeze();
+		changed.clear();
+		if (storage) {
+			from_tick = MAX(last_seen_tick, storage->get_change_ticks().get_flushed_tick());
+			// The changes notified from now on are taken by the next process.
+			to_tick = storage->advance_change_tick();
+			if (notification_active == false) {
+				inactive_to_tick = to_tick;
+			}
+
+			storage->get_change_ticks().collect_changed(from_tick, to_tick, changed);
+			if (inactive_to_tick > inactive_from_tick) {
+				for (int64_t i = int64_t(changed.size()) - 1; i >= 0; i -= 1) {
+					if (is_changed(changed[i]) == false) {
+						changed.remove_at(i);
+					}
+				}
+			}
+		}
 	}
 
 	void conclude_process(World *p_world) {
 		QueryStorage<I + 1, Cs...>::conclude_process(p_world);
 		storage = nullptr;
-		// Unfreeze the list and clear it to listen on the new events.
-		changed.unfreeze();
 		changed.clear();
+
+		// Discard the changes notified during this process and listen on the
+		// new events.
+		Storage<C> *s = p_world->get_storage<C>();
+		if (s) {
+			last_seen_tick = s->advance_change_tick();
+		}
+		if (notification_active) {
+			inactive_from_tick = 0;
+			inactive_to_tick = 0;
+		}
 	}
 
 	void set_world_notification_active(bool p_active) {
 		QueryStorage<I + 1, Cs...>::set_world_notification_active(p_active);
+		if (notification_active == p_active) {
+			return;
+		}
+		notification_active = p_active;
 		Storage<C> *s = world->get_storage<C>();
-		if (s) {
-			if (p_active) {
-				s->add_change_listener(&changed);
-			} else {
-				s->remove_change_listener(&changed);
-			}
+		if (s == nullptr) {
+			return;
 		}
+		if (p_active) {
+			inactive_to_tick = s->advance_change_tick();
+		} else if (inactive_to_tick <= inactive_from_tick) {
+			inactive_from_tick = s->advance_change_tick();
+		}
+		// else: the notification is disabled again before this query is
+		// processed, so the ignored range is just extended.
 	}
 
 	constexpr static bool is_filter_derminant() {
@@ -825,7 +922,7 @@ struct QueryStorage<I, Changed<C>, Cs...> : public QueryStorage<I + 1, Cs...> {
 		if (unlikely(storage == nullptr)) {
 			return o_entities;
 		}
-		const EntitiesBuffer tmp_entities(changed.size(), changed.get_entities_ptr());
+		const EntitiesBuffer tmp_entities(changed.size(), changed.ptr());
 		return tmp_entities.count < o_entities.count ? tmp_entities : o_entities;
 	}
 
@@ -835,7 +932,15 @@ struct QueryStorage<I, Changed<C>, Cs...> : public QueryStorage<I + 1, Cs...> {
 			// immediately.
 			return false;
 		}
-		return changed.has(p_entity) && QueryStorage<I + 1, Cs...>::filter_satisfied(p_entity);
+		// The component may be gone after its change was stamped (e.g. the
+		// storage restored a fork), so it can't be fetched.
+		return is_changed(p_entity) && storage->has(p_entity) && QueryStorage<I + 1, Cs...>::filter_satisfied(p_entity);
+	}
+
+	_FORCE_INLINE_ bool is_changed(EntityID p_entity) const {
+		const ChangeTick tick = storage->get_change_ticks().get_tick(p_entity);
+		return tick > from_tick && tick <= to_tick &&
+				(tick <= inactive_from_tick || tick > inactive_to_tick);
 	}
 
 	bool can_fetch(EntityID p_entity) const {
@@ -1290,7 +1395,35 @@ struct QueryStorage<I, Join<C...>, Cs...> : QueryStorage<I + 1, Cs...> {
 /// `QueryStorage` no filter specialization.
 template <std::size_t I, class C, class... Cs>
 struct QueryStorage<I, C, Cs...> : QueryStorage<I + 1, Cs...> {
+	using DenseStorage = DenseVectorStorage<std::remove_const_t<C>>;
+	/// `true` when the component is declared with a `DenseVectorStorage`: in
+	/// that case, the storage is fetched without virtual calls.
+	static constexpr bool IS_DENSE = std::is_same<typename component_storage_type<std::remove_const_t<C>>::type, DenseStorage>::value;
+
+	using TagStorageType = TagStorage<std::remove_const_t<C>>;
+	/// `true` when the component is declared with a `TagStorage`: in that case
+	/// `has` is a bit lookup, without virtual calls.
+	static constexpr bool IS_TAG = is_tag_component<C>::value;
+	/// The next tag fetched by this query, if any: its bitset is intersected
+	/// with the one of this tag, to find the `Entities` to iterate.
+	using NextTag = typename first_tag_component<Cs...>::type;
+
 	Storage<C> *storage = nullptr;
+	/// Set only when `IS_DENSE` and the storage type matches.
+	DenseStorage *dense_storage = nullptr;
+	/// Set only when `IS_TAG` and the storage type matches.
+	TagStorageType *tag_storage = nullptr;
+
+	using ArchetypeStorageType = ArchetypeStorage<std::remove_const_t<C>>;
+	/// `true` when the component is declared with an `ArchetypeStorage`: in
+	/// that case, the archetype iteration reads the columns directly.
+	static constexpr bool IS_ARCHETYPE = is_archetype_component<C>::value;
+	/// Set only when `IS_ARCHETYPE` and the storage type matches.
+	ArchetypeStorageType *archetype_storage = nullptr;
+	/// The `Entities` that have both this tag and the `NextTag`, valid when
+	/// `has_tag_entities` is `true`.
+	LocalVector<EntityID> tag_entities;
+	bool has_tag_entities = false;
 
 	QueryStorage(World *p_world) :
 			QueryStorage<I + 1, Cs...>(p_world) {}
@@ -1298,11 +1431,33 @@ struct QueryStorage<I, C, Cs...> : QueryStorage<I + 1, Cs...> {
 	void initiate_process(World *p_world) {
 		QueryStorage<I + 1, Cs...>::initiate_process(p_world);
 		storage = p_world->get_storage<C>();
+		if constexpr (IS_DENSE) {
+			// Checked once here, so the inner loop doesn't need to.
+			dense_storage = dynamic_cast<DenseStorage *>(static_cast<StorageBase *>(storage));
+		}
+		if constexpr (IS_ARCHETYPE) {
+			archetype_storage = dynamic_cast<ArchetypeStorageType *>(static_cast<StorageBase *>(storage));
+		}
+		if constexpr (IS_TAG) {
+			tag_storage = dynamic_cast<TagStorageType *>(static_cast<StorageBase *>(storage));
+			if constexpr (std::is_void<NextTag>::value == false) {
+				const TagStorage<NextTag> *next_tag_storage = dynamic_cast<const TagStorage<NextTag> *>(p_world->get_storage(NextTag::get_component_id()));
+				if (tag_storage != nullptr && next_tag_storage != nullptr) {
+					tag_storage->intersect(*next_tag_storage, tag_entities);
+					has_tag_entities = true;
+				}
+			}
+		}
 	}
 
 	void conclude_process(World *p_world) {
 		QueryStorage<I + 1, Cs...>::conclude_process(p_world);
 		storage = nullptr;
+		dense_storage = nullptr;
+		tag_storage = nullptr;
+		archetype_storage = nullptr;
+		tag_entities.clear();
+		has_tag_entities = false;
 	}
 
 	void set_world_notification_active(bool p_active) {
@@ -1321,11 +1476,28 @@ struct QueryStorage<I, C, Cs...> : QueryStorage<I + 1, Cs...> {
 		if (unlikely(storage == nullptr)) {
 			return o_entities;
 		}
+		if constexpr (IS_TAG) {
+			if (has_tag_entities) {
+				const EntitiesBuffer tag_buffer(tag_entities.size(), tag_entities.ptr());
+				return tag_buffer.count < o_entities.count ? tag_buffer : o_entities;
+			}
+		}
 		const EntitiesBuffer tmp_entities = storage->get_stored_entities();
 		return tmp_entities.count < o_entities.count ? tmp_entities : o_entities;
 	}
 
 	bool filter_satisfied(EntityID p_entity) const {
+		if constexpr (IS_DENSE) {
+			if (likely(dense_storage != nullptr)) {
+				return dense_storage->has(p_entity) && QueryStorage<I + 1, Cs...>::filter_satisfied(p_entity);
+			}
+		}
+		if constexpr (IS_TAG) {
+			if (likely(tag_storage != nullptr)) {
+				// Just a bit lookup.
+				return tag_storage->has(p_entity) && QueryStorage<I + 1, Cs...>::filter_satisfied(p_entity);
+			}
+		}
 		if (unlikely(storage == nullptr)) {
 			// This is a required field, since there is no storage this can end
 			// immediately.
@@ -1345,6 +1517,31 @@ struct QueryStorage<I, C, Cs...> : QueryStorage<I + 1, Cs...> {
 		CRASH_COND_MSG(storage == nullptr, "The storage" + String(typeid(Storage<C>).name()) + " is null.");
 #endif
 
+		if constexpr (IS_DENSE) {
+			if (likely(dense_storage != nullptr)) {
+				// Non virtual fetch.
+				if constexpr (std::is_const<C>::value) {
+					set<I>(r_result, const_cast<const DenseStorage *>(dense_storage)->get(p_id, p_mode));
+				} else {
+					set<I>(r_result, dense_storage->get(p_id, p_mode));
+				}
+				QueryStorage<I + 1, Cs...>::fetch(p_id, p_mode, r_result);
+				return;
+			}
+		}
+		if constexpr (IS_TAG) {
+			if (likely(tag_storage != nullptr)) {
+				// Non virtual fetch.
+				if constexpr (std::is_const<C>::value) {
+					set<I>(r_result, const_cast<const TagStorageType *>(tag_storage)->get(p_id, p_mode));
+				} else {
+					set<I>(r_result, tag_storage->get(p_id, p_mode));
+				}
+				QueryStorage<I + 1, Cs...>::fetch(p_id, p_mode, r_result);
+				return;
+			}
+		}
+
 		// Set the `Component` inside th tuple.
 		if constexpr (std::is_const<C>::value) {
 			set<I>(r_result, const_cast<const Storage<C> *>(storage)->get(p_id, p_mode));
@@ -1356,6 +1553,33 @@ struct QueryStorage<I, C, Cs...> : QueryStorage<I + 1, Cs...> {
 		QueryStorage<I + 1, Cs...>::fetch(p_id, p_mode, r_result);
 	}
 
+	/// Fetches the component at `p_row` of the archetype `p_archetype`, used
+	/// by the archetype iteration: the component is read from the column, so
+	/// no `Entity` -> location lookup is needed.
+	template <class... Qs>
+	void fetch_row(uint32_t p_archetype, uint32_t p_row, EntityID p_id, Space p_mode, QueryResultTuple<Qs...> &r_result) const {
+		if constexpr (IS_ARCHETYPE) {
+			if (likely(archetype_storage != nullptr)) {
+				if constexpr (std::is_const<C>::value) {
+					set<I>(r_result, const_cast<const ArchetypeStorageType *>(archetype_storage)->get_column_ptr(p_archetype) + p_row);
+				} else {
+					archetype_storage->notify_changed(p_id);
+					set<I>(r_result, archetype_storage->get_column_ptr(p_archetype) + p_row);
+				}
+				QueryStorage<I + 1, Cs...>::fetch_row(p_archetype, p_row, p_id, p_mode, r_result);
+				return;
+			}
+		}
+
+		// The storage type is not known at compile time.
+		if constexpr (std::is_const<C>::value) {
+			set<I>(r_result, const_cast<const Storage<C> *>(storage)->get(p_id, p_mode));
+		} else {
+			set<I>(r_result, storage->get(p_id, p_mode));
+		}
+		QueryStorage<I + 1, Cs...>::fetch_row(p_archetype, p_row, p_id, p_mode, r_result);
+	}
+
 	auto get_inner_storage() const {
 		return storage;
 	}
@@ -1370,6 +1594,40 @@ struct QueryStorage<I, C, Cs...> : QueryStorage<I + 1, Cs...> {
 	}
 };
 
+// ------------------------------------------------------------ Archetype Utility
+
+/// `true` when `C` is a filter, like `Maybe<C>` or `Changed<C>`.
+template <class C>
+struct is_query_filter : std::false_type {};
+
+template <class C>
+struct is_query_filter<Not<C>> : std::true_type {};
+
+template <class C>
+struct is_query_filter<Create<C>> : std::true_type {};
+
+template <class C>
+struct is_query_filter<Maybe<C>> : std::true_type {};
+
+template <class C>
+struct is_query_filter<Changed<C>> : std::true_type {};
+
+template <class C>
+struct is_query_filter<Batch<C>> : std::true_type {};
+
+template <class... C>
+struct is_query_filter<Any<C...>> : std::true_type {};
+
+template <class... C>
+struct is_query_filter<Join<C...>> : std::true_type {};
+
+template <class C>
+void query_push_component_id(LocalVector<godex::component_id> &r_components) {
+	if constexpr (std::is_same<C, EntityID>::value == false) {
+		r_components.push_back(std::remove_const_t<C>::get_component_id());
+	}
+}
+
 /// This is the fastest `Query`.
 /// Using the variadic template, it's build at compile time. Since the
 /// components must be known at compile time, this query can't by used by
@@ -1381,17 +1639,72 @@ class Query {
 
 	/// List of entities to check.
 	EntitiesBuffer entities = EntitiesBuffer(0, nullptr);
+	/// The `Entities` fetched during this process, reported to the
+	/// `PipelineProfiler` by `conclude_process`.
+	uint32_t fetched_count = 0;
 
 	// Storages
 	QueryStorage<0, Cs...> q;
 
+	World *world = nullptr;
+	/// The storages this query writes, that buffer the changes during
+	/// `par_for_each`.
+	LocalVector<godex::component_id> mutable_components;
+	/// `false` when this query creates components, or writes a storage that
+	/// can't be mutated by many threads: `par_for_each` runs in single thread.
+	bool can_write_in_parallel = true;
+
+	/// `true` when the `Query` has no filters: when all its components are stored
+	/// using `ArchetypeStorage` it can iterate the archetypes directly.
+	static constexpr bool CAN_ITERATE_ARCHETYPES = (is_query_filter<Cs>::value || ...) == false;
+
+	/// The sorted components, used to find the matching archetypes.
+	LocalVector<godex::component_id> archetype_components;
+	/// The archetypes that have all the `archetype_components`.
+	LocalVector<uint32_t> matching_archetypes;
+	/// The archetypes already checked, since the archetypes are never removed
+	/// only the new ones are checked.
+	uint32_t checked_archetypes_count = 0;
+	/// When `true`, the `Iterator` iterates the `archetype_entities` that
+	/// satisfy the query: so no need to check the filters.
+	bool archetype_iteration = false;
+	LocalVector<EntitiesBuffer> archetype_entities;
+	/// The archetype of each `archetype_entities` segment.
+	LocalVector<uint32_t> archetype_ids;
+
+	template <class F>
+	struct ParallelForEachData {
+		Query<Cs...> *query;
+		F *func;
+		uint32_t chunk_size;
+		/// The `Entities` fetched by all the tasks.
+		SafeNumeric<uint32_t> fetched;
+	};
+
 public:
+	/// The default amount of `Entities` processed by a single task of
+	/// `par_for_each`.
+	static constexpr uint32_t PARALLEL_CHUNK_SIZE = 1024;
+
 	Query(World *p_world) :
-			q(p_world) {
+			q(p_world), world(p_world) {
+		SystemExeInfo info;
+		get_components(info);
+		for (const RBSet<uint32_t>::Element *e = info.mutable_components.front(); e; e = e->next()) {
+			mutable_components.push_back(e->get());
+		}
+		// `Create` needs to insert into the storage.
+		can_write_in_parallel = info.mutable_components_storage.is_empty();
+
+		if constexpr (CAN_ITERATE_ARCHETYPES) {
+			(query_push_component_id<Cs>(archetype_components), ...);
+			archetype_components.sort();
+		}
 	}
 
 	void initiate_process(World *p_world) {
 		m_space = LOCAL;
+		fetched_count = 0;
 		q.initiate_process(p_world);
 
 		// Prepare the query:
@@ -1402,10 +1715,18 @@ public:
 			entities.count = 0;
 			ERR_PRINT("This query is not valid, you are using only non determinant fileters (like `Not` and `Maybe`).");
 		}
+
+		archetype_iteration = false;
+		if constexpr (CAN_ITERATE_ARCHETYPES) {
+			prepare_archetype_iteration(p_world);
+		}
 	}
 
 	void conclude_process(World *p_world) {
 		q.conclude_process(p_world);
+		// Counted once per process, so the iteration doesn't pay for it.
+		PipelineProfiler::count_entities(fetched_count);
+		fetched_count = 0;
 	}
 
 	void set_world_notification_active(bool p_active) {
@@ -1417,8 +1738,8 @@ public:
 		using difference_type = std::ptrdiff_t;
 		using value_type = QueryResultTuple<Cs...>;
 
-		Iterator(Query<Cs...> *p_query, const EntityID *p_entity) :
-				query(p_query), entity(p_entity) {}
+		Iterator(Query<Cs...> *p_query, const EntityID *p_entity, uint32_t p_segment = 0) :
+				query(p_query), entity(p_entity), segment(p_segment) {}
 
 		bool is_valid() const {
 			return *this != query->end();
@@ -1429,13 +1750,22 @@ public:
 		}
 
 		value_type operator*() const {
+			query->fetched_count += 1;
 			QueryResultTuple<Cs...> result;
+			if constexpr (CAN_ITERATE_ARCHETYPES) {
+				if (query->archetype_iteration) {
+					// The row is the position of the `Entity` into its archetype.
+					const uint32_t row = entity - query->archetype_entities[segment].entities;
+					query->q.fetch_row(query->archetype_ids[segment], row, *entity, query->m_space, result);
+					return result;
+				}
+			}
 			query->q.fetch(*entity, query->m_space, result);
 			return result;
 		}
 
 		Iterator &operator++() {
-			entity = query->next_valid_entity(entity);
+			entity = query->next_valid_entity(entity, segment);
 			return *this;
 		}
 
@@ -1451,6 +1781,8 @@ public:
 	private:
 		Query<Cs...> *query;
 		const EntityID *entity;
+		/// The archetype being iterated, used only by the archetype iteration.
+		uint32_t segment;
 	};
 
 	/// Allow to specify the space you want to fetch the data, you can use this
@@ -1478,6 +1810,15 @@ public:
 	/// }
 	/// ```
 	Iterator begin() {
+		if (archetype_iteration) {
+			// The empty archetypes are never added, and all the entities
+			// satisfy the query.
+			if (archetype_entities.size() > 0) {
+				return Iterator(this, archetype_entities[0].entities, 0);
+			}
+			return end();
+		}
+
 		// Returns the next available Entity.
 		if (entities.count > 0) {
 			if (q.filter_satisfied(*entities.entities) == false) {
@@ -1489,6 +1830,9 @@ public:
 
 	/// Used to know the last element of the `Iterator`.
 	Iterator end() {
+		if (archetype_iteration) {
+			return Iterator(this, nullptr, archetype_entities.size());
+		}
 		return Iterator(this, entities.entities + entities.count);
 	}
 
@@ -1517,6 +1861,71 @@ public:
 		return result;
 	}
 
+	/// Executes `p_func` for each `Entity` that meets the requirements of this
+	/// `Query`. The entities are split in chunks of `p_chunk_size`, processed in
+	/// parallel by the workers of the `Pipeline` that is dispatching the world.
+	/// ```
+	/// query.par_for_each([](auto p_components) {
+	/// 	auto [transform, velocity] = p_components;
+	/// 	transform->origin += velocity->linear;
+	/// });
+	/// ```
+	/// Since `p_func` is executed concurrently, it must only modify the fetched
+	/// components. The changes are buffered per thread and merged before this
+	/// function returns, so `Changed` works as usual.
+	///
+	/// Runs in single thread when no worker is available (for example, when
+	/// this `System` is running in parallel with other systems), or when the
+	/// query creates components or mutates a shared storage.
+	template <class F>
+	void par_for_each(F p_func, uint32_t p_chunk_size = PARALLEL_CHUNK_SIZE) {
+		ERR_FAIL_COND_MSG(p_chunk_size == 0, "The chunk size can't be 0.");
+
+		ThreadPool *thread_pool = world == nullptr ? nullptr : world->get_thread_pool();
+		const uint32_t chunks_count = (entities.count + p_chunk_size - 1) / p_chunk_size;
+
+		bool parallel = can_write_in_parallel &&
+						chunks_count > 1 &&
+						thread_pool != nullptr &&
+						thread_pool->get_threads_count() > 0 &&
+						ThreadPool::is_executing_task() == false;
+
+		for (uint32_t i = 0; parallel && i < mutable_components.size(); i += 1) {
+			const StorageBase *storage = world->get_storage(mutable_components[i]);
+			parallel = storage == nullptr || storage->is_parallel_write_safe();
+		}
+
+		if (parallel == false) {
+			for (Iterator it = begin(); it != end(); ++it) {
+				p_func(*it);
+			}
+			return;
+		}
+
+		// Buffer the changes, so the storages can be written by all the threads.
+		for (uint32_t i = 0; i < mutable_components.size(); i += 1) {
+			StorageBase *storage = world->get_storage(mutable_components[i]);
+			if (storage) {
+				storage->begin_parallel_changes(thread_pool->get_threads_count() + 1);
+			}
+		}
+
+		ParallelForEachData<F> data;
+		data.query = this;
+		data.func = &p_func;
+		data.chunk_size = p_chunk_size;
+		thread_pool->run(par_for_each_chunk<F>, &data, chunks_count);
+		fetched_count += data.fetched.get();
+
+		// Merge the changes.
+		for (uint32_t i = 0; i < mutable_components.size(); i += 1) {
+			StorageBase *storage = world->get_storage(mutable_components[i]);
+			if (storage) {
+				storage->end_parallel_changes();
+			}
+		}
+	}
+
 	/// Counts the Entities that meets the requirements of this `Query`.
 	/// IMPORTANT: Don't use this function to create C like loop: instead rely
 	/// on the iterator.
@@ -1533,6 +1942,71 @@ public:
 	}
 
 private:
+	template <class F>
+	static void par_for_each_chunk(void *p_user_data, uint32_t p_chunk_index) {
+		ParallelForEachData<F> *data = static_cast<ParallelForEachData<F> *>(p_user_data);
+		Query<Cs...> *query = data->query;
+
+		const uint32_t from = p_chunk_index * data->chunk_size;
+		const uint32_t to = MIN(from + data->chunk_size, query->entities.count);
+		uint32_t fetched = 0;
+		for (uint32_t i = from; i < to; i += 1) {
+			const EntityID entity = query->entities.entities[i];
+			if (query->q.filter_satisfied(entity)) {
+				QueryResultTuple<Cs...> result;
+				query->q.fetch(entity, query->m_space, result);
+				(*data->func)(result);
+				fetched += 1;
+			}
+		}
+		data->fetched.add(fetched);
+	}
+
+	void prepare_archetype_iteration(World *p_world) {
+		const ArchetypeRegistry *registry = p_world->get_archetype_registry();
+		if (registry == nullptr || archetype_components.size() == 0) {
+			return;
+		}
+
+		for (uint32_t i = 0; i < archetype_components.size(); i += 1) {
+			if (registry->has_storage(archetype_components[i]) == false) {
+				// This component is not stored in an `ArchetypeStorage`.
+				return;
+			}
+		}
+
+		// Check the new archetypes.
+		for (; checked_archetypes_count < registry->get_archetypes_count(); checked_archetypes_count += 1) {
+			if (registry->get_archetype(checked_archetypes_count)->has_components(archetype_components)) {
+				matching_archetypes.push_back(checked_archetypes_count);
+			}
+		}
+
+		archetype_entities.clear();
+		archetype_ids.clear();
+		for (uint32_t i = 0; i < matching_archetypes.size(); i += 1) {
+			const LocalVector<EntityID> &archetype = registry->get_archetype(matching_archetypes[i])->entities;
+			if (archetype.size() > 0) {
+				archetype_entities.push_back(EntitiesBuffer(archetype.size(), archetype.ptr()));
+				archetype_ids.push_back(matching_archetypes[i]);
+			}
+		}
+		archetype_iteration = true;
+	}
+
+	const EntityID *next_valid_entity(const EntityID *p_current, uint32_t &r_segment) {
+		if (archetype_iteration) {
+			const EntityID *next = p_current + 1;
+			if (next == (archetype_entities[r_segment].entities + archetype_entities[r_segment].count)) {
+				// Move to the next archetype.
+				r_segment += 1;
+				next = r_segment < archetype_entities.size() ? archetype_entities[r_segment].entities : nullptr;
+			}
+			return next;
+		}
+		return next_valid_entity(p_current);
+	}
+
 	const EntityID *next_valid_entity(const EntityID *p_current) {
 		const EntityID *next = p_current + 1;
 
@@ -20,3 +20,23 @@ bool GodexBtCollisionDispatcher::needsResponse(const btCollisionObject *body0, c
 	}
 	return btCollisionDispatcher::needsResponse(body0, body1);
 }
+
+btPersistentManifold *GodexBtCollisionDispatcher::getNewManifold(const btCollisionObject *body0, const btCollisionObject *body1) {
+	MutexLock lock(mutex);
+	return btCollisionDispatcher::getNewManifold(body0, body1);
+}
+
+void GodexBtCollisionDispatcher::releaseManifold(btPersistentManifold *manifold) {
+	MutexLock lock(mutex);
+	btCollisionDispatcher::releaseManifold(manifold);
+}
+
+void *GodexBtCollisionDispatcher::allocateCollisionAlgorithm(int size) {
+	MutexLock lock(mutex);
+	return btCollisionDispatcher::allocateCollisionAlgorithm(size);
+}
+
+void GodexBtCollisionDispatcher::freeCollisionAlgorithm(void *ptr) {
+	MutexLock lock(mutex);
+	btCollisionDispatcher::freeCollisionAlgorithm(ptr);
+}
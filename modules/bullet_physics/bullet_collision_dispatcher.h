@@ -1,11 +1,24 @@
 #pragma once
 
+#include "core/os/mutex.h"
 #include <btBulletDynamicsCommon.h>
 
 /// This class is required to implement custom collision behaviour in the narrowphase
+///
+/// The queries (like `contactTest`) can be executed by many threads at the same
+/// time on the same space: the functions that allocate or release the
+/// algorithms and the manifolds are guarded by a mutex.
 class GodexBtCollisionDispatcher : public btCollisionDispatcher {
+	Mutex mutex;
+
 public:
 	GodexBtCollisionDispatcher(btCollisionConfiguration *collisionConfiguration);
 	virtual bool needsCollision(const btCollisionObject *body0, const btCollisionObject *body1);
 	virtual bool needsResponse(const btCollisionObject *body0, const btCollisionObject *body1);
+
+	virtual btPersistentManifold *getNewManifold(const btCollisionObject *body0, const btCollisionObject *body1);
+	virtual void releaseManifold(btPersistentManifold *manifold);
+
+	virtual void *allocateCollisionAlgorithm(int size);
+	virtual void freeCollisionAlgorithm(void *ptr);
 };
@@ -1,10 +1,11 @@
 #include "components_area.h"
 
+#include "../../storage/event_storage.h"
 #include "collision_object_bullet.h"
 
 void BtArea::_bind_methods() {
-	ECS_BIND_PROPERTY(BtArea, PropertyInfo(Variant::STRING, "enter_emitter_name", (PropertyHint)godex::PROPERTY_HINT_ECS_EVENT_EMITTER, "OverlapStart"), enter_emitter_name);
-	ECS_BIND_PROPERTY(BtArea, PropertyInfo(Variant::STRING, "exit_emitter_name", (PropertyHint)godex::PROPERTY_HINT_ECS_EVENT_EMITTER, "OverlapEnd"), exit_emitter_name);
+	ECS_BIND_PROPERTY_FUNC(BtArea, PropertyInfo(Variant::STRING, "enter_emitter_name", (PropertyHint)godex::PROPERTY_HINT_ECS_EVENT_EMITTER, "OverlapStart"), set_enter_emitter_name, get_enter_emitter_name);
+	ECS_BIND_PROPERTY_FUNC(BtArea, PropertyInfo(Variant::STRING, "exit_emitter_name", (PropertyHint)godex::PROPERTY_HINT_ECS_EVENT_EMITTER, "OverlapEnd"), set_exit_emitter_name, get_exit_emitter_name);
 	ECS_BIND_PROPERTY_FUNC(BtArea, PropertyInfo(Variant::INT, "layer", PROPERTY_HINT_LAYERS_3D_PHYSICS), set_layer, get_layer);
 	ECS_BIND_PROPERTY_FUNC(BtArea, PropertyInfo(Variant::INT, "mask", PROPERTY_HINT_LAYERS_3D_PHYSICS), set_mask, get_mask);
 }
@@ -57,6 +58,32 @@ uint32_t BtArea::get_mask() const {
 	return mask;
 }
 
+void BtArea::set_enter_emitter_name(const String &p_name) {
+	enter_emitter_name = p_name;
+	enter_emitter_id = p_name.is_empty() ? godex::EMITTER_NONE : EventEmitters::intern(p_name);
+}
+
+const String &BtArea::get_enter_emitter_name() const {
+	return enter_emitter_name;
+}
+
+godex::emitter_id BtArea::get_enter_emitter_id() const {
+	return enter_emitter_id;
+}
+
+void BtArea::set_exit_emitter_name(const String &p_name) {
+	exit_emitter_name = p_name;
+	exit_emitter_id = p_name.is_empty() ? godex::EMITTER_NONE : EventEmitters::intern(p_name);
+}
+
+const String &BtArea::get_exit_emitter_name() const {
+	return exit_emitter_name;
+}
+
+godex::emitter_id BtArea::get_exit_emitter_id() const {
+	return exit_emitter_id;
+}
+
 bool BtArea::need_body_reload() const {
 	return reload_flags & RELOAD_FLAGS_BODY;
 }
@@ -78,21 +105,24 @@ const btCollisionShape *BtArea::get_shape() const {
 	return ghost.getCollisionShape();
 }
 
-void BtArea::add_new_overlap(btCollisionObject *p_object, int p_detect_frame, uint32_t p_index) {
-	overlaps.push_back({ p_detect_frame, p_object });
-	SWAP(overlaps[overlaps.size() - 1], overlaps[p_index]);
+uint32_t BtArea::add_new_overlap(EntityID p_entity, int p_detect_frame, bool p_overlapping) {
+	const uint32_t index = overlaps.size();
+	overlaps.push_back({ p_detect_frame, p_entity, p_overlapping });
+	overlaps_index.set(p_entity.get_raw_id(), index);
+	return index;
 }
 
-void BtArea::mark_still_overlapping(uint32_t p_overlap_index, int p_detect_frame) {
-	overlaps[p_overlap_index].detect_frame = p_detect_frame;
+uint32_t BtArea::find_overlap(EntityID p_entity) const {
+	const uint32_t *index = overlaps_index.lookup_ptr(p_entity.get_raw_id());
+	return index == nullptr ? UINT32_MAX : *index;
 }
 
-uint32_t BtArea::find_overlapping_object(btCollisionObject *p_col_obj, uint32_t p_search_from) {
-	for (uint32_t i = p_search_from; i < overlaps.size(); i += 1) {
-		if (overlaps[i].object == p_col_obj) {
-			SWAP(overlaps[p_search_from], overlaps[i]);
-			return p_search_from;
-		}
+void BtArea::remove_overlap(uint32_t p_index) {
+	overlaps_index.remove(overlaps[p_index].entity.get_raw_id());
+	const uint32_t last = overlaps.size() - 1;
+	if (p_index != last) {
+		overlaps[p_index] = overlaps[last];
+		overlaps_index.set(overlaps[p_index].entity.get_raw_id(), p_index);
 	}
-	return UINT32_MAX;
+	overlaps.resize(last);
 }
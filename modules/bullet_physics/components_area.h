@@ -3,12 +3,19 @@
 #include "../../components/component.h"
 #include "../../storage/steady_storage.h"
 #include "bt_def_type.h"
+#include "core/templates/oa_hash_map.h"
 #include <BulletCollision/CollisionDispatch/btGhostObject.h>
 
+/// The state of a pair `BtArea` - object, as returned by the broadphase.
+/// The pair is tracked even when the shapes don't overlap, so the narrowphase
+/// check is skipped until one of the two moves.
 struct Overlap {
-	// Used to know if this object is Still overlapped or not.
+	// Used to know if this pair is still returned by the broadphase.
 	int detect_frame;
-	btCollisionObject *object;
+	// The `Entity` of the other object.
+	EntityID entity;
+	// `true` when the two shapes overlap.
+	bool overlapping;
 };
 
 struct BtArea {
@@ -27,12 +34,17 @@ private:
 
 	uint32_t reload_flags = 0;
 
-public:
 	String enter_emitter_name;
 	String exit_emitter_name;
+	/// The interned emitter names, so emitting doesn't need to look them up.
+	godex::emitter_id enter_emitter_id = godex::EMITTER_NONE;
+	godex::emitter_id exit_emitter_id = godex::EMITTER_NONE;
 
-	/// List of overlapping objects.
+public:
+	/// List of the objects in the area broadphase.
 	LocalVector<Overlap> overlaps;
+	/// Maps the `Entity` raw id to the index into `overlaps`.
+	OAHashMap<uint32_t, uint32_t> overlaps_index;
 
 	/// The current space this Area is. Do not modify this.
 	BtSpaceIndex __current_space = BT_SPACE_NONE;
@@ -57,6 +69,16 @@ public:
 	void set_mask(uint32_t p_mask);
 	uint32_t get_mask() const;
 
+	void set_enter_emitter_name(const String &p_name);
+	const String &get_enter_emitter_name() const;
+	/// `EMITTER_NONE` when no enter emitter is set.
+	godex::emitter_id get_enter_emitter_id() const;
+
+	void set_exit_emitter_name(const String &p_name);
+	const String &get_exit_emitter_name() const;
+	/// `EMITTER_NONE` when no exit emitter is set.
+	godex::emitter_id get_exit_emitter_id() const;
+
 	bool need_body_reload() const;
 	void reload_body(BtSpaceIndex p_index);
 
@@ -64,17 +86,12 @@ public:
 	btCollisionShape *get_shape();
 	const btCollisionShape *get_shape() const;
 
-	/// Add new overlap.
-	/// You can pass the position at which the Overlap is added in the array.
-	/// The position may change
-	void add_new_overlap(btCollisionObject *p_object, int p_detect_frame, uint32_t p_index = 0);
+	/// Add new overlap and returns its index.
+	uint32_t add_new_overlap(EntityID p_entity, int p_detect_frame, bool p_overlapping);
 
-	/// Mark the overlap as still overlapping.
-	void mark_still_overlapping(uint32_t p_overlap_index, int p_detect_frame);
+	/// Find the overlap of this `Entity` and returns its index, or `UINT32_MAX`.
+	uint32_t find_overlap(EntityID p_entity) const;
 
-	/// Find the overlapping object and returns its index.
-	/// This function re-organizes the list of overlapping objects so to speedup
-	/// the search.
-	/// Note: after call this function any previous Index is no more valid.
-	uint32_t find_overlapping_object(btCollisionObject *p_coll_obj, uint32_t p_search_from);
+	/// Removes the overlap at this index. The last overlap takes its place.
+	void remove_overlap(uint32_t p_index);
 };
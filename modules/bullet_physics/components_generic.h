@@ -6,7 +6,7 @@
 #include "components_area.h"
 
 struct Force {
-	COMPONENT_BATCH(Force, DenseVector, -1)
+	COMPONENT_BATCH_ARENA(Force, DenseVector)
 
 	static void _bind_methods();
 	static void _get_storage_config(Dictionary &r_config);
@@ -16,7 +16,7 @@ struct Force {
 };
 
 struct Torque {
-	COMPONENT_BATCH(Torque, DenseVector, -1)
+	COMPONENT_BATCH_ARENA(Torque, DenseVector)
 
 	static void _bind_methods();
 	static void _get_storage_config(Dictionary &r_config);
@@ -25,7 +25,7 @@ struct Torque {
 };
 
 struct Impulse {
-	COMPONENT_BATCH(Impulse, DenseVector, -1)
+	COMPONENT_BATCH_ARENA(Impulse, DenseVector)
 
 	static void _bind_methods();
 	static void _get_storage_config(Dictionary &r_config);
@@ -35,7 +35,7 @@ struct Impulse {
 };
 
 struct TorqueImpulse {
-	COMPONENT_BATCH(TorqueImpulse, DenseVector, -1)
+	COMPONENT_BATCH_ARENA(TorqueImpulse, DenseVector)
 
 	static void _bind_methods();
 	static void _get_storage_config(Dictionary &r_config);
@@ -26,10 +26,15 @@ void on_post_tick_callback(btDynamicsWorld *p_dynamics_world, btScalar p_delta)
 	// BtWorld *space = static_cast<BtWorld *>(p_dynamics_world->getWorldUserInfo());
 }
 
+void BtPhysicsSpaces::_bind_methods() {
+	ECS_BIND_PROPERTY(BtPhysicsSpaces, PropertyInfo(Variant::BOOL, "parallel_mode"), parallel_mode);
+}
+
 BtPhysicsSpaces::BtPhysicsSpaces() {
 	// Always init the space 0, which is the default one.
 	init_space(BT_SPACE_0, GLOBAL_DEF("physics/3d/active_soft_world", true));
 	CRASH_COND_MSG(is_space_initialized(BT_SPACE_0) == false, "At this point the space 0 is expected to be initialized.");
+	parallel_mode = GLOBAL_DEF("physics/3d/parallel_mode", false);
 }
 
 BtPhysicsSpaces::~BtPhysicsSpaces() {
@@ -39,6 +44,14 @@ BtPhysicsSpaces::~BtPhysicsSpaces() {
 	}
 }
 
+void BtPhysicsSpaces::set_parallel_mode(bool p_parallel) {
+	parallel_mode = p_parallel;
+}
+
+bool BtPhysicsSpaces::get_parallel_mode() const {
+	return parallel_mode;
+}
+
 bool BtPhysicsSpaces::is_space_initialized(BtSpaceIndex p_id) const {
 	return spaces[p_id].broadphase != nullptr;
 }
@@ -60,19 +60,31 @@ public:
 /// You can specify to which `Space` an entity has to stay by using the
 /// optional `BtSpaceMarker`. When the `BtSpaceMarker` is not used the `Entity`
 /// is put to the main default world (ID 0).
+///
+/// When `parallel_mode` is enabled (`physics/3d/parallel_mode`), the spaces are
+/// stepped concurrently and the `BtPawn` sweeps run on the worker threads.
 class BtPhysicsSpaces : public godex::Databag {
 	DATABAG(BtPhysicsSpaces)
 
+	static void _bind_methods();
+
 public:
 	btEmptyShape empty_shape;
 
 private:
 	BtSpace spaces[BT_SPACE_MAX];
 
+	/// When `true` the spaces are stepped concurrently and the `BtPawn`
+	/// motions are computed by many threads.
+	bool parallel_mode = false;
+
 public:
 	BtPhysicsSpaces();
 	~BtPhysicsSpaces();
 
+	void set_parallel_mode(bool p_parallel);
+	bool get_parallel_mode() const;
+
 	/// Returns `true` if the space is initialized.
 	bool is_space_initialized(BtSpaceIndex p_id) const;
 
@@ -1,5 +1,6 @@
 #include "systems_base.h"
 
+#include "../../utils/thread_pool.h"
 #include "bullet_types_converter.h"
 #include "overlap_check.h"
 #include "utilities.h"
@@ -68,7 +69,7 @@ void bt_config_body(
 				body->get_body()->setUserIndex2(space_index);
 
 				// Set the EntityID
-				body->get_body()->setUserIndex3(entity);
+				body->get_body()->setUserIndex3(entity.get_raw_id());
 
 				// Mark as moved
 				space->moved_bodies.insert(entity);
@@ -123,7 +124,7 @@ void bt_config_area(
 				area->get_ghost()->setUserIndex2(space_index);
 
 				// Set the EntityID
-				area->get_ghost()->setUserIndex3(entity);
+				area->get_ghost()->setUserIndex3(entity.get_raw_id());
 
 				// Mark as moved.
 				space->moved_bodies.insert(entity);
@@ -391,9 +392,24 @@ void bt_apply_forces(
 	p_torque_inpulses->clear();
 }
 
+struct SpacesStepData {
+	BtSpace *spaces[BT_SPACE_MAX];
+	real_t physics_delta;
+};
+
+static void step_space(void *p_user_data, uint32_t p_task_index) {
+	const SpacesStepData *data = static_cast<const SpacesStepData *>(p_user_data);
+	// Step bullet physics.
+	data->spaces[p_task_index]->get_dynamics_world()->stepSimulation(
+			data->physics_delta,
+			0,
+			0);
+}
+
 void bt_spaces_step(
 		BtPhysicsSpaces *p_spaces,
 		const FrameTime *p_iterator_info,
+		const World *p_world,
 		// TODO this is not used, though we need it just to be sure they are not
 		// touched by anything else.
 		Storage<BtRigidBody> *,
@@ -406,22 +422,29 @@ void bt_spaces_step(
 		// Storage<BtWorldMargin> *, Not used.
 		Storage<BtConvex> *,
 		Storage<BtTrimesh> *) {
-	const real_t physics_delta = p_iterator_info->get_physics_delta();
+	SpacesStepData data;
+	data.physics_delta = p_iterator_info->get_physics_delta();
 
-	// TODO consider to create a system for each space? So it has much more control.
+	uint32_t spaces_count = 0;
 	for (uint32_t i = 0; i < BtSpaceIndex::BT_SPACE_MAX; i += 1) {
-		BtSpaceIndex w_i = (BtSpaceIndex)i;
-
-		if (p_spaces->get_space(w_i)->get_dispatcher() == nullptr) {
+		BtSpace *space = p_spaces->get_space((BtSpaceIndex)i);
+		if (space->get_dispatcher() == nullptr) {
 			// This space is disabled.
 			continue;
 		}
+		data.spaces[spaces_count] = space;
+		spaces_count += 1;
+	}
 
-		// Step bullet physics.
-		p_spaces->get_space(w_i)->get_dynamics_world()->stepSimulation(
-				physics_delta,
-				0,
-				0);
+	// The spaces don't share any mutable data, so each one can be stepped by
+	// a different thread.
+	ThreadPool *thread_pool = p_world->get_thread_pool();
+	if (p_spaces->get_parallel_mode() && spaces_count > 1 && thread_pool != nullptr) {
+		thread_pool->run(step_space, &data, spaces_count);
+	} else {
+		for (uint32_t i = 0; i < spaces_count; i += 1) {
+			step_space(&data, i);
+		}
 	}
 }
 
@@ -436,7 +459,7 @@ void bt_overlap_check(
 	p_cache->area_check_frame_counter %= 100;
 	const int frame_id = p_cache->area_check_frame_counter;
 
-	LocalVector<btCollisionObject *> new_overlaps;
+	LocalVector<EntityID> new_overlaps;
 
 	for (auto [entity, area] : p_query) {
 		if (unlikely(area->__current_space == BT_SPACE_NONE)) {
@@ -447,8 +470,6 @@ void bt_overlap_check(
 		btAlignedObjectArray<btCollisionObject *> &aabb_overlap =
 				area->get_ghost()->getOverlappingPairs();
 
-		uint32_t last_found_overlapped_index = 0;
-
 		// This area moved?
 		const bool area_is_move =
 				p_spaces->get_space(area->__current_space)->moved_bodies.has(entity);
@@ -456,98 +477,99 @@ void bt_overlap_check(
 		const btTransform area_transform = area->get_transform() /* X (TODO area scale) */;
 
 		for (int i = 0; i < aabb_overlap.size(); i += 1) {
-			// TODO Check if transform changed, if not this overlap is still valid
-			// we don't need to check it.
-
-			// Check if this collider is already overlapping.
-			const uint32_t overlap_index = area->find_overlapping_object(
-					aabb_overlap[i],
-					last_found_overlapped_index);
-
-			// This object moved?
-			const bool aabb_overlap_is_moved =
-					p_spaces->get_space(static_cast<BtSpaceIndex>(aabb_overlap[i]->getUserIndex2()))
-							->moved_bodies.has(aabb_overlap[i]->getUserIndex3());
-
-			bool overlapping = false;
-
-			if (overlap_index == UINT32_MAX || area_is_move || aabb_overlap_is_moved) {
-				// Extract the other object transform.
-				btTransform aabb_overlap_transform;
-				if (aabb_overlap[i]->getInternalType() == btCollisionObject::CO_RIGID_BODY) {
-					// This is a rigidbody, extrac the transform from the motion_state
-					static_cast<btRigidBody *>(aabb_overlap[i])->getMotionState()->getWorldTransform(aabb_overlap_transform);
-				} else {
+			const EntityID other_entity = aabb_overlap[i]->getUserIndex3();
+
+			// Check if this pair is already known.
+			uint32_t overlap_index = area->find_overlap(other_entity);
+
+			if (overlap_index != UINT32_MAX && area_is_move == false) {
+				// This object moved?
+				const bool aabb_overlap_is_moved =
+						p_spaces->get_space(static_cast<BtSpaceIndex>(aabb_overlap[i]->getUserIndex2()))
+								->moved_bodies.has(other_entity);
+
+				if (aabb_overlap_is_moved == false) {
+					// Nothing moved, so the overlap state didn't change:
+					// skip the collision check.
+					area->overlaps[overlap_index].detect_frame = frame_id;
+					continue;
+				}
+			}
+
+			// Extract the other object transform.
+			btTransform aabb_overlap_transform;
+			if (aabb_overlap[i]->getInternalType() == btCollisionObject::CO_RIGID_BODY) {
+				// This is a rigidbody, extrac the transform from the motion_state
+				static_cast<btRigidBody *>(aabb_overlap[i])->getMotionState()->getWorldTransform(aabb_overlap_transform);
+			} else {
 #ifdef DEBUG_ENABLED
-					CRASH_COND_MSG(aabb_overlap[i]->getInternalType() != btCollisionObject::CO_GHOST_OBJECT, "Here we expect an area, if you are adding a new type, make sure to update this System.");
+				CRASH_COND_MSG(aabb_overlap[i]->getInternalType() != btCollisionObject::CO_GHOST_OBJECT, "Here we expect an area, if you are adding a new type, make sure to update this System.");
 #endif
-					// This is an area, extract normally.
-					aabb_overlap_transform = static_cast<btGhostObject *>(aabb_overlap[i])->getWorldTransform();
-				}
+				// This is an area, extract normally.
+				aabb_overlap_transform = static_cast<btGhostObject *>(aabb_overlap[i])->getWorldTransform();
+			}
 
-				// aabb_overlap_transform TODO multiply the scale.
+			// aabb_overlap_transform TODO multiply the scale.
 
-				// Collision check is required, do it.
-				OverlappingFunc func = OverlapCheck::find_algorithm(
-						area->get_shape()->getShapeType(),
-						aabb_overlap[i]->getCollisionShape()->getShapeType());
-				ERR_CONTINUE_MSG(func == nullptr, "No Overlap check Algorithm for this shape pair. Shape A type `" + itos(area->get_shape()->getShapeType()) + "` Shape B type `" + itos(aabb_overlap[i]->getCollisionShape()->getShapeType()) + "`");
+			// Collision check is required, do it.
+			OverlappingFunc func = OverlapCheck::find_algorithm(
+					area->get_shape()->getShapeType(),
+					aabb_overlap[i]->getCollisionShape()->getShapeType());
+			ERR_CONTINUE_MSG(func == nullptr, "No Overlap check Algorithm for this shape pair. Shape A type `" + itos(area->get_shape()->getShapeType()) + "` Shape B type `" + itos(aabb_overlap[i]->getCollisionShape()->getShapeType()) + "`");
 
-				overlapping = func(
-						area->get_shape(),
-						area_transform,
-						aabb_overlap[i]->getCollisionShape(),
-						aabb_overlap_transform);
-			} else {
-				// This object was overlapping and its transform didn't change,
-				// skip the collision check.
-				overlapping = true;
+			const bool overlapping = func(
+					area->get_shape(),
+					area_transform,
+					aabb_overlap[i]->getCollisionShape(),
+					aabb_overlap_transform);
+
+			if (overlap_index == UINT32_MAX) {
+				// This is a new pair.
+				overlap_index = area->add_new_overlap(other_entity, frame_id, false);
 			}
 
-			if (overlapping) {
-				if (overlap_index == UINT32_MAX) {
-					// This is a new overlap
-					area->add_new_overlap(
-							aabb_overlap[i],
-							frame_id,
-							last_found_overlapped_index);
-
-					// We can increment this by one, so the next overlap can ignore this.
-					last_found_overlapped_index += 1;
-					new_overlaps.push_back(aabb_overlap[i]);
-
-				} else {
-					// This is a known overlap
-					area->mark_still_overlapping(overlap_index, frame_id);
-					last_found_overlapped_index += overlap_index;
+			Overlap &overlap = area->overlaps[overlap_index];
+			overlap.detect_frame = frame_id;
+
+			if (overlapping && overlap.overlapping == false) {
+				// This is a new overlap.
+				overlap.overlapping = true;
+				new_overlaps.push_back(other_entity);
+
+			} else if (overlapping == false && overlap.overlapping) {
+				// This object is no more overlapping.
+				overlap.overlapping = false;
+				if (area->get_exit_emitter_id() != godex::EMITTER_NONE) {
+					OverlapEnd e;
+					e.area = entity;
+					e.other_body = other_entity;
+					p_exit_event_emitter.emit(area->get_exit_emitter_id(), e);
 				}
 			}
 		}
 
 		for (int i = int(area->overlaps.size()) - 1; i >= 0; i -= 1) {
 			if (area->overlaps[i].detect_frame != frame_id) {
-				// This object is no more overlapping
+				// This object is no more in the area broadphase.
 
-				if (area->exit_emitter_name.is_empty() == false) {
-					const EntityID other_entity = area->overlaps[i].object->getUserIndex3();
+				if (area->overlaps[i].overlapping && area->get_exit_emitter_id() != godex::EMITTER_NONE) {
 					OverlapEnd e;
 					e.area = entity;
-					e.other_body = other_entity;
-					p_exit_event_emitter.emit(area->exit_emitter_name, e);
+					e.other_body = area->overlaps[i].entity;
+					p_exit_event_emitter.emit(area->get_exit_emitter_id(), e);
 				}
 
 				// Remove the object.
-				area->overlaps.remove_at_unordered(i);
+				area->remove_overlap(i);
 			}
 		}
 
-		if (area->enter_emitter_name.is_empty() == false) {
+		if (area->get_enter_emitter_id() != godex::EMITTER_NONE) {
 			for (uint32_t i = 0; i < new_overlaps.size(); i += 1) {
-				const EntityID other_entity = new_overlaps[i]->getUserIndex3();
 				OverlapStart e;
 				e.area = entity;
-				e.other_body = other_entity;
-				p_enter_event_emitter.emit(area->enter_emitter_name, e);
+				e.other_body = new_overlaps[i];
+				p_enter_event_emitter.emit(area->get_enter_emitter_id(), e);
 			}
 		}
 
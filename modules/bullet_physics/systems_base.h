@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../../databags/frame_time.h"
+#include "../../world/world.h"
 #include "../godot/components/interpolated_transform_component.h"
 #include "../godot/components/transform_component.h"
 #include "components_area.h"
@@ -117,9 +118,12 @@ void bt_apply_forces(
 
 // TODO Body remove from `Entity`
 
+/// Steps the physics spaces. When the `BtPhysicsSpaces::parallel_mode` is
+/// enabled, the spaces are stepped concurrently using the `World` workers.
 void bt_spaces_step(
 		BtPhysicsSpaces *p_spaces,
 		const FrameTime *p_iterator_info,
+		const World *p_world,
 		// TODO this is not used, though we need it just to be sure they are not
 		// touched by anything else.
 		Storage<BtRigidBody> *,
@@ -134,6 +138,9 @@ void bt_spaces_step(
 		Storage<BtTrimesh> *);
 
 /// Perform the Areas overlap check.
+/// Each area remembers the state of every broadphase pair, so the narrowphase
+/// check runs only for the new pairs and for the pairs where one side moved.
+/// `OverlapStart` and `OverlapEnd` are emitted only when the state changes.
 void bt_overlap_check(
 		const BtPhysicsSpaces *p_spaces,
 		BtCache *p_cache,
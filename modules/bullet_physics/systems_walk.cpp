@@ -1,5 +1,6 @@
 #include "systems_walk.h"
 
+#include "../../utils/thread_pool.h"
 #include "bullet_types_converter.h"
 #include "collision_queries.h"
 #include <BulletCollision/BroadphaseCollision/btBroadphaseProxy.h>
@@ -351,67 +352,136 @@ StrafingResult move(
 	};
 }
 
+/// The motion of a single `BtPawn`, computed in three steps:
+/// `pawn_walk_prepare`, `pawn_walk_move` and `pawn_walk_apply`.
+/// Only `pawn_walk_move` can run in parallel, since it doesn't write the
+/// physics space.
+struct PawnWalk {
+	BtRigidBody *body;
+	BtPawn *pawn;
+	BtSpace *space;
+	btMatrix3x3 ground_dir;
+	btVector3 offset;
+	btVector3 position;
+	btVector3 motion;
+};
+
+bool pawn_walk_prepare(
+		const FrameTime *frame_time,
+		BtPhysicsSpaces *p_spaces,
+		BtRigidBody *body,
+		BtStreamedShape *shape,
+		BtPawn *pawn,
+		PawnWalk &r_walk) {
+	if (pawn->disabled) {
+		return false;
+	}
+	ERR_FAIL_COND_V_MSG(body->get_body_mode() != BtRigidBody::RIGID_MODE_KINEMATIC, false, "The mode of this body is not KINEMATIC");
+	ERR_FAIL_COND_V_MSG(body->__current_space == BtSpaceIndex::BT_SPACE_NONE, false, "Thid body is not in world, skip.");
+
+	PawnShape &pawn_shape = pawn->stances[pawn->current_stance];
+
+	// Set the correct shape to the body.
+	shape->shape = &pawn_shape.main_shape;
+	body->set_shape(shape->shape);
+
+	r_walk.body = body;
+	r_walk.pawn = pawn;
+	r_walk.space = p_spaces->get_space(body->__current_space);
+
+	// Convert the ground dir
+	G_TO_B(pawn->ground_direction, r_walk.ground_dir);
+
+	// Compute the forces
+	pawn->velocity += pawn->external_forces * frame_time->physics_delta /* x inverse_mass */;
+	pawn->external_forces.setZero();
+
+	// Calculate the motion on this frame.
+	r_walk.motion = pawn->velocity * frame_time->physics_delta;
+
+	G_TO_B(pawn_shape.offset, r_walk.offset);
+	r_walk.position = body->get_transform().getOrigin();
+
+	r_walk.position += r_walk.offset;
+	return true;
+}
+
+void pawn_walk_move(PawnWalk &r_walk) {
+	// Execute the motion
+	const StrafingResult strafing_res = move(
+			r_walk.space,
+			r_walk.body,
+			r_walk.pawn->stances[r_walk.pawn->current_stance],
+			r_walk.ground_dir,
+			r_walk.position,
+			r_walk.motion,
+			r_walk.pawn->step_height,
+			r_walk.pawn->snap_to_ground);
+
+	// From now on, `motion` is the motion done.
+	r_walk.motion = strafing_res.motion;
+}
+
+void pawn_walk_apply(
+		const FrameTime *frame_time,
+		PawnWalk &p_walk) {
+	BtPawn *pawn = p_walk.pawn;
+
+	// Adjust the speed depending on the motion done,
+	btVector3 motion_velocity = p_walk.motion / frame_time->physics_delta;
+	// This algorithm make sure to never speed up a particular axis.
+	motion_velocity[0] = pawn->velocity[0] > 0.0 ? MIN(pawn->velocity[0], motion_velocity[0]) : MAX(pawn->velocity[0], motion_velocity[0]);
+	motion_velocity[1] = pawn->velocity[1] > 0.0 ? MIN(pawn->velocity[1], motion_velocity[1]) : MAX(pawn->velocity[1], motion_velocity[1]);
+	motion_velocity[2] = pawn->velocity[2] > 0.0 ? MIN(pawn->velocity[2], motion_velocity[2]) : MAX(pawn->velocity[2], motion_velocity[2]);
+	pawn->velocity = pawn->velocity.lerp(motion_velocity, pawn->on_impact_speed_change_factor); // TODO make this frame independent.
+
+	const btVector3 position = p_walk.position - p_walk.offset;
+
+	// Set the new position
+	btTransform t = p_walk.body->get_transform();
+	t.setOrigin(position);
+	p_walk.body->set_transform(t, true);
+}
+
+void pawn_walk_move_task(void *p_user_data, uint32_t p_task_index) {
+	LocalVector<PawnWalk> *walks = static_cast<LocalVector<PawnWalk> *>(p_user_data);
+	pawn_walk_move((*walks)[p_task_index]);
+}
+
 void bt_pawn_walk(
 		const FrameTime *frame_time,
+		const World *p_world,
 		BtPhysicsSpaces *p_spaces,
 		Query<
 				BtRigidBody,
 				BtStreamedShape,
 				BtPawn> &p_query) {
+	ThreadPool *thread_pool = p_world->get_thread_pool();
+	if (p_spaces->get_parallel_mode() == false || thread_pool == nullptr) {
+		// Each pawn is moved and written back before moving the next one.
+		PawnWalk walk;
+		for (auto [body, shape, pawn] : p_query.space(GLOBAL)) {
+			if (pawn_walk_prepare(frame_time, p_spaces, body, shape, pawn, walk)) {
+				pawn_walk_move(walk);
+				pawn_walk_apply(frame_time, walk);
+			}
+		}
+		return;
+	}
+
+	// The sweeps only read the spaces, so all the pawns can be moved at the same
+	// time; the bodies are written back once all the motions are computed.
+	LocalVector<PawnWalk> walks;
 	for (auto [body, shape, pawn] : p_query.space(GLOBAL)) {
-		if (pawn->disabled) {
-			continue;
+		walks.resize(walks.size() + 1);
+		if (pawn_walk_prepare(frame_time, p_spaces, body, shape, pawn, walks[walks.size() - 1]) == false) {
+			walks.resize(walks.size() - 1);
 		}
-		ERR_CONTINUE_MSG(body->get_body_mode() != BtRigidBody::RIGID_MODE_KINEMATIC, "The mode of this body is not KINEMATIC");
-		ERR_CONTINUE_MSG(body->__current_space == BtSpaceIndex::BT_SPACE_NONE, "Thid body is not in world, skip.");
-
-		PawnShape &pawn_shape = pawn->stances[pawn->current_stance];
-
-		// Set the correct shape to the body.
-		shape->shape = &pawn_shape.main_shape;
-		body->set_shape(shape->shape);
-
-		// Convert the ground dir
-		btMatrix3x3 ground_dir;
-		G_TO_B(pawn->ground_direction, ground_dir);
-
-		// Compute the forces
-		pawn->velocity += pawn->external_forces * frame_time->physics_delta /* x inverse_mass */;
-		pawn->external_forces.setZero();
-
-		// Calculate the motion on this frame.
-		btVector3 motion = pawn->velocity * frame_time->physics_delta;
-
-		btVector3 offset;
-		G_TO_B(pawn_shape.offset, offset);
-		btVector3 position = body->get_transform().getOrigin();
-
-		position += offset;
-
-		// Execute the motion
-		const StrafingResult strafing_res = move(
-				p_spaces->get_space(body->__current_space),
-				body,
-				pawn_shape,
-				ground_dir,
-				position,
-				motion,
-				pawn->step_height,
-				pawn->snap_to_ground);
-
-		// Adjust the speed depending on the motion done,
-		btVector3 motion_velocity = strafing_res.motion / frame_time->physics_delta;
-		// This algorithm make sure to never speed up a particular axis.
-		motion_velocity[0] = pawn->velocity[0] > 0.0 ? MIN(pawn->velocity[0], motion_velocity[0]) : MAX(pawn->velocity[0], motion_velocity[0]);
-		motion_velocity[1] = pawn->velocity[1] > 0.0 ? MIN(pawn->velocity[1], motion_velocity[1]) : MAX(pawn->velocity[1], motion_velocity[1]);
-		motion_velocity[2] = pawn->velocity[2] > 0.0 ? MIN(pawn->velocity[2], motion_velocity[2]) : MAX(pawn->velocity[2], motion_velocity[2]);
-		pawn->velocity = pawn->velocity.lerp(motion_velocity, pawn->on_impact_speed_change_factor); // TODO make this frame independent.
-
-		position -= offset;
-
-		// Set the new position
-		btTransform t = body->get_transform();
-		t.setOrigin(position);
-		body->set_transform(t, true);
+	}
+
+	thread_pool->run(pawn_walk_move_task, &walks, walks.size());
+
+	for (uint32_t i = 0; i < walks.size(); i += 1) {
+		pawn_walk_apply(frame_time, walks[i]);
 	}
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../../databags/frame_time.h"
+#include "../../world/world.h"
 #include "../godot/components/transform_component.h"
 #include "components_generic.h"
 #include "components_pawn.h"
@@ -8,7 +9,11 @@
 #include "databag_space.h"
 #include "shape_base.h"
 
+/// Moves the `BtPawn`s. When the `BtPhysicsSpaces::parallel_mode` is enabled
+/// the motion sweeps are executed by the `World` workers, and the new
+/// positions are written back to the `BtRigidBody` once all the pawns moved.
 void bt_pawn_walk(
 		const FrameTime *frame_time,
+		const World *p_world,
 		BtPhysicsSpaces *p_spaces, // TODO can this be const?
 		Query<BtRigidBody, BtStreamedShape, BtPawn> &p_query);
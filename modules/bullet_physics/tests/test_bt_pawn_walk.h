@@ -0,0 +1,98 @@
+#ifndef TEST_BT_PAWN_WALK_H
+#define TEST_BT_PAWN_WALK_H
+
+#include "tests/test_macros.h"
+
+#include "../../../ecs.h"
+#include "../../../pipeline/pipeline.h"
+#include "../../../pipeline/pipeline_builder.h"
+#include "../bullet_types_converter.h"
+#include "../systems_base.h"
+#include "../systems_walk.h"
+
+namespace godex_bt_pawn_walk_tests {
+
+static constexpr uint32_t PAWNS_COUNT = 32;
+static constexpr uint32_t FRAMES_COUNT = 30;
+
+/// Moves `PAWNS_COUNT` pawns, far from each other, for `FRAMES_COUNT` frames;
+/// then returns their positions.
+void walk_pawns(Pipeline &p_pipeline, bool p_parallel_mode, LocalVector<Vector3> &r_positions) {
+	World world;
+	Token token = p_pipeline.prepare_world(&world);
+	p_pipeline.set_active(token, true);
+
+	world.get_databag<FrameTime>()->set_physics_delta(1.0 / 60.0);
+	world.get_databag<BtPhysicsSpaces>()->set_parallel_mode(p_parallel_mode);
+
+	LocalVector<EntityID> pawns;
+	for (uint32_t i = 0; i < PAWNS_COUNT; i += 1) {
+		BtRigidBody body;
+		body.set_body_mode(BtRigidBody::RIGID_MODE_KINEMATIC);
+		btTransform transform;
+		transform.setIdentity();
+		transform.setOrigin(btVector3(real_t(i) * 10.0, 0.0, 0.0));
+		body.set_transform(transform, false);
+
+		BtPawn pawn;
+		pawn.set_velocity(Vector3(0.0, 0.0, 1.0 + real_t(i % 4)));
+
+		pawns.push_back(world
+								.create_entity()
+								.with(body)
+								.with(BtStreamedShape())
+								.with(pawn));
+	}
+
+	for (uint32_t f = 0; f < FRAMES_COUNT; f += 1) {
+		p_pipeline.dispatch(token);
+	}
+
+	r_positions.clear();
+	Storage<BtRigidBody> *storage = world.get_storage<BtRigidBody>();
+	for (uint32_t i = 0; i < pawns.size(); i += 1) {
+		Vector3 position;
+		B_TO_G(storage->get(pawns[i])->get_transform().getOrigin(), position);
+		r_positions.push_back(position);
+	}
+
+	p_pipeline.set_active(token, false);
+}
+
+TEST_CASE("[Modules][Bullet] The pawns walk the same in parallel and serial mode.") {
+	ECS::register_system(bt_config_body, "TestBtConfigBody")
+			.before("TestBtPawnWalk");
+	ECS::register_system(bt_pawn_walk, "TestBtPawnWalk")
+			.before("TestBtSpacesStep");
+	ECS::register_system(bt_spaces_step, "TestBtSpacesStep");
+
+	PipelineBuilder pipeline_builder;
+	pipeline_builder.add_system("TestBtConfigBody");
+	pipeline_builder.add_system("TestBtPawnWalk");
+	pipeline_builder.add_system("TestBtSpacesStep");
+
+	Pipeline pipeline;
+	pipeline_builder.build(pipeline);
+	CHECK(pipeline.is_ready());
+
+	LocalVector<Vector3> serial_positions;
+	walk_pawns(pipeline, false, serial_positions);
+
+	LocalVector<Vector3> parallel_positions;
+	walk_pawns(pipeline, true, parallel_positions);
+
+	CHECK(serial_positions.size() == PAWNS_COUNT);
+	CHECK(parallel_positions.size() == PAWNS_COUNT);
+	for (uint32_t i = 0; i < PAWNS_COUNT; i += 1) {
+		// The pawns moved.
+		CHECK(serial_positions[i].z > 0.0);
+		CHECK(ABS(serial_positions[i].x - real_t(i) * 10.0) <= CMP_EPSILON);
+
+		// The pawns don't interact, so running the sweeps in parallel must
+		// produce the same motion.
+		CHECK(serial_positions[i].is_equal_approx(parallel_positions[i]));
+	}
+}
+} // namespace godex_bt_pawn_walk_tests
+
+#endif // TEST_BT_PAWN_WALK_H
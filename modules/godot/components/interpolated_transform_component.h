@@ -13,3 +13,5 @@ class InterpolatedTransformComponent {
 	Transform3D previous_transform;
 	Transform3D current_transform;
 };
+
+SNAPSHOT_RAW_LAYOUT(InterpolatedTransformComponent)
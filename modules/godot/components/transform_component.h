@@ -38,3 +38,5 @@ class TransformComponent : public Transform3D {
 			const TransformComponent &p_parent_global,
 			TransformComponent &r_local);
 };
+
+SNAPSHOT_RAW_LAYOUT(TransformComponent)
@@ -1038,7 +1038,17 @@ Color get_bg_color_by_deepness(int p_deep) {
 	return color;
 }
 
-void pipeline_dispatcher_view_update(DispatcherPipelineView *p_view, Ref<ExecutionGraph::Dispatcher> p_dispatcher, int p_deepness) {
+/// Returns the system name, with the time it took on the last profiled frame.
+String pipeline_system_view_name(godex::system_id p_id, const Dictionary &p_systems_time) {
+	const StringName name = ECS::get_system_name(p_id);
+	if (p_systems_time.has(name) == false) {
+		return name;
+	}
+	const double time_msec = double(uint64_t(p_systems_time[name])) / 1000.0;
+	return String(name) + " (" + String::num(time_msec, 3) + " ms)";
+}
+
+void pipeline_dispatcher_view_update(DispatcherPipelineView *p_view, Ref<ExecutionGraph::Dispatcher> p_dispatcher, int p_deepness, const Dictionary &p_systems_time) {
 	uint32_t stage_id = 0;
 	const List<ExecutionGraph::StageNode> &stages = p_dispatcher->stages;
 	for (const List<ExecutionGraph::StageNode>::Element *e = stages.front(); e; e = e->next(), stage_id += 1) {
@@ -1048,14 +1058,14 @@ void pipeline_dispatcher_view_update(DispatcherPipelineView *p_view, Ref<Executi
 			if (e->get().systems[i]->sub_dispatcher.is_valid()) {
 				// This system is a sub duspatcher.
 				DispatcherPipelineView *sub_view = stage_view->add_sub_dispatcher();
-				sub_view->set_dispatcher_name(ECS::get_system_name(e->get().systems[i]->id));
+				sub_view->set_dispatcher_name(pipeline_system_view_name(e->get().systems[i]->id, p_systems_time));
 				sub_view->set_bg_color(get_bg_color_by_deepness(p_deepness + 1));
-				pipeline_dispatcher_view_update(sub_view, e->get().systems[i]->sub_dispatcher, p_deepness + 1);
+				pipeline_dispatcher_view_update(sub_view, e->get().systems[i]->sub_dispatcher, p_deepness + 1, p_systems_time);
 
 			} else {
 				// This is a standard system
 				SystemView *system_view = stage_view->add_system();
-				system_view->set_name(ECS::get_system_name(e->get().systems[i]->id));
+				system_view->set_name(pipeline_system_view_name(e->get().systems[i]->id, p_systems_time));
 				system_view->set_bg_color(get_bg_color_by_deepness(p_deepness + 1));
 			}
 		}
@@ -1081,12 +1091,32 @@ void EditorWorldECS::pipeline_view_update() {
 		return;
 	}
 
+	// When the running game profiles its pipeline, show the time of the last
+	// frame it sent.
+	Dictionary systems_time;
+	if (profiler_frame.has("systems")) {
+		const Array systems = profiler_frame["systems"];
+		for (int i = 0; i < systems.size(); i += 1) {
+			const Dictionary system = systems[i];
+			systems_time[system["name"]] = system["time_usec"];
+		}
+	}
+
 	int deepness = 0;
 	DispatcherPipelineView *view = pipeline_view_add_dispatcher();
-	view->set_dispatcher_name("Main");
+	if (profiler_frame.has("time_usec")) {
+		view->set_dispatcher_name("Main (" + String::num(double(uint64_t(profiler_frame["time_usec"])) / 1000.0, 3) + " ms)");
+	} else {
+		view->set_dispatcher_name("Main");
+	}
 	view->set_bg_color(get_bg_color_by_deepness(deepness));
 
-	pipeline_dispatcher_view_update(view, main_dispatcher, deepness);
+	pipeline_dispatcher_view_update(view, main_dispatcher, deepness, systems_time);
+}
+
+void EditorWorldECS::set_profiler_frame(const Dictionary &p_frame) {
+	profiler_frame = p_frame;
+	pipeline_view_update();
 }
 
 void EditorWorldECS::pipeline_system_bundle_remove(const StringName &p_name) {
@@ -1356,14 +1386,37 @@ void EditorWorldECS::pipeline_view_clear() {
 	}
 }
 
+GodexDebuggerPlugin::GodexDebuggerPlugin(EditorWorldECS *p_ecs_editor) :
+		ecs_editor(p_ecs_editor) {}
+
+bool GodexDebuggerPlugin::has_capture(const String &p_capture) const {
+	return p_capture == "godex";
+}
+
+bool GodexDebuggerPlugin::capture(const String &p_message, const Array &p_data, int p_session) {
+	if (p_message == "godex:profiler_frame") {
+		ERR_FAIL_COND_V(p_data.size() != 1, false);
+		if (ecs_editor) {
+			ecs_editor->set_profiler_frame(p_data[0]);
+		}
+		return true;
+	}
+	return false;
+}
+
 WorldECSEditorPlugin::WorldECSEditorPlugin(EditorNode *p_node) :
 		editor(p_node) {
 	ecs_editor = memnew(EditorWorldECS(p_node));
 	editor->get_main_screen_control()->add_child(ecs_editor);
 	ecs_editor->hide_editor();
+
+	debugger_plugin = Ref<GodexDebuggerPlugin>(memnew(GodexDebuggerPlugin(ecs_editor)));
+	add_debugger_plugin(debugger_plugin);
 }
 
 WorldECSEditorPlugin::~WorldECSEditorPlugin() {
+	remove_debugger_plugin(debugger_plugin);
+	debugger_plugin.unref();
 	editor->get_main_screen_control()->remove_child(ecs_editor);
 	memdelete(ecs_editor);
 	ecs_editor = nullptr;
@@ -2,6 +2,7 @@
 #define EDITORWORLDECS_H
 
 #include "editor/editor_plugin.h"
+#include "editor/plugins/editor_debugger_plugin.h"
 #include "scene/gui/dialogs.h"
 #include "scene/gui/line_edit.h"
 #include "scene/gui/margin_container.h"
@@ -160,6 +161,10 @@ class EditorWorldECS : public PanelContainer {
 	Tree *components_tree = nullptr;
 	LineEdit *component_name_le = nullptr;
 
+	/// The last frame profiled by the running game, in the format of
+	/// `PipelineECS::get_profiler_frame`.
+	Dictionary profiler_frame;
+
 public:
 	EditorWorldECS(EditorNode *p_editor);
 
@@ -184,6 +189,7 @@ public:
 	void pipeline_features_update();
 	void pipeline_errors_warnings_update();
 	void pipeline_view_update();
+	void set_profiler_frame(const Dictionary &p_frame);
 
 	void pipeline_system_bundle_remove(const StringName &p_name);
 	void pipeline_system_remove(const StringName &p_name);
@@ -213,6 +219,20 @@ protected:
 	static void remove_node_and_reparent_children(Node *p_node);
 };
 
+/// Receives the frames profiled by the running game, sent by
+/// `ECS::send_profiler_frame`, and shows them on the pipeline view.
+class GodexDebuggerPlugin : public EditorDebuggerPlugin {
+	GDCLASS(GodexDebuggerPlugin, EditorDebuggerPlugin);
+
+	EditorWorldECS *ecs_editor = nullptr;
+
+public:
+	GodexDebuggerPlugin(EditorWorldECS *p_ecs_editor = nullptr);
+
+	virtual bool has_capture(const String &p_capture) const override;
+	virtual bool capture(const String &p_message, const Array &p_data, int p_session) override;
+};
+
 class WorldECSEditorPlugin : public EditorPlugin {
 	GDCLASS(WorldECSEditorPlugin, EditorPlugin);
 
@@ -222,6 +242,7 @@ class WorldECSEditorPlugin : public EditorPlugin {
 	EditorNode *editor = nullptr;
 	EditorWorldECS *ecs_editor = nullptr;
 	WorldECS *world_ecs = nullptr;
+	Ref<GodexDebuggerPlugin> debugger_plugin;
 
 public:
 	WorldECSEditorPlugin(EditorNode *p_node);
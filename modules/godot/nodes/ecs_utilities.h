@@ -145,6 +145,8 @@ class StaticComponentDepot : public ComponentDepot {
 
 public:
 	godex::component_id get_component_id() const { return component_id; }
+	/// The typed component data, as created by `ECS::new_component`.
+	const void *get_component() const { return component; }
 
 	virtual ~StaticComponentDepot();
 
@@ -23,6 +23,12 @@ void PipelineECS::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_systems_name"), &PipelineECS::get_systems_name);
 	ClassDB::bind_method(D_METHOD("set_system_bundles", "systems_name"), &PipelineECS::set_system_bundles);
 	ClassDB::bind_method(D_METHOD("get_system_bundles"), &PipelineECS::get_system_bundles);
+	ClassDB::bind_method(D_METHOD("set_threads_count", "count"), &PipelineECS::set_threads_count);
+	ClassDB::bind_method(D_METHOD("get_threads_count"), &PipelineECS::get_threads_count);
+	ClassDB::bind_method(D_METHOD("set_profiling_enabled", "enabled"), &PipelineECS::set_profiling_enabled);
+	ClassDB::bind_method(D_METHOD("is_profiling_enabled"), &PipelineECS::is_profiling_enabled);
+	ClassDB::bind_method(D_METHOD("get_profiler_frames_count"), &PipelineECS::get_profiler_frames_count);
+	ClassDB::bind_method(D_METHOD("get_profiler_frame", "frames_ago"), &PipelineECS::get_profiler_frame, DEFVAL(0));
 
 	ClassDB::bind_method(D_METHOD("add_system_bundle", "system_bundle"), &PipelineECS::add_system_bundle);
 	ClassDB::bind_method(D_METHOD("remove_system_bundle", "system_bundle"), &PipelineECS::remove_system_bundle);
@@ -32,6 +38,8 @@ void PipelineECS::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "pipeline_name"), "set_pipeline_name", "get_pipeline_name");
 	ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "system_bundles"), "set_system_bundles", "get_system_bundles");
 	ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "systems_name"), "set_systems_name", "get_systems_name");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "threads_count", PROPERTY_HINT_RANGE, "-1,256,1"), "set_threads_count", "get_threads_count");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "profiling_enabled"), "set_profiling_enabled", "is_profiling_enabled");
 }
 
 PipelineECS::PipelineECS() {
@@ -85,6 +93,76 @@ Vector<StringName> PipelineECS::get_system_bundles() {
 	return system_bundles;
 }
 
+void PipelineECS::set_threads_count(int p_count) {
+	ERR_FAIL_COND_MSG(p_count == 0 || p_count < -1, "The threads count must be `-1` or greater than `0`.");
+	threads_count = p_count;
+	if (pipeline) {
+		pipeline->set_threads_count(threads_count);
+	}
+}
+
+int PipelineECS::get_threads_count() const {
+	return threads_count;
+}
+
+void PipelineECS::set_profiling_enabled(bool p_enabled) {
+	profiling_enabled = p_enabled;
+	if (pipeline) {
+		pipeline->set_profiling_enabled(profiling_enabled);
+	}
+}
+
+bool PipelineECS::is_profiling_enabled() const {
+	return profiling_enabled;
+}
+
+int PipelineECS::get_profiler_frames_count() const {
+	if (pipeline == nullptr) {
+		return 0;
+	}
+	return pipeline->get_profiler().get_frames_count();
+}
+
+Dictionary PipelineECS::get_profiler_frame(int p_frames_ago) const {
+	ERR_FAIL_COND_V_MSG(p_frames_ago < 0, Dictionary(), "The frames ago can't be negative.");
+	if (pipeline == nullptr) {
+		return Dictionary();
+	}
+	return profiler_frame_to_dictionary(pipeline, p_frames_ago);
+}
+
+Dictionary PipelineECS::profiler_frame_to_dictionary(const Pipeline *p_pipeline, uint32_t p_frames_ago) {
+	FrameProfile frame;
+	if (p_pipeline->get_profiler().get_frame(p_frames_ago, frame) == false) {
+		return Dictionary();
+	}
+
+	Array stages;
+	stages.resize(frame.stages_time_usec.size());
+	for (uint32_t i = 0; i < frame.stages_time_usec.size(); i += 1) {
+		stages[i] = frame.stages_time_usec[i];
+	}
+
+	Array systems;
+	systems.resize(frame.systems.size());
+	for (uint32_t i = 0; i < frame.systems.size(); i += 1) {
+		const godex::system_id id = p_pipeline->get_system_at_index(i);
+		Dictionary system;
+		system["name"] = id == godex::SYSTEM_NONE ? StringName() : ECS::get_system_name(id);
+		system["time_usec"] = frame.systems[i].time_usec;
+		system["calls"] = frame.systems[i].calls;
+		system["entities"] = frame.systems[i].entities;
+		systems[i] = system;
+	}
+
+	Dictionary ret;
+	ret["frame"] = frame.frame;
+	ret["time_usec"] = frame.time_usec;
+	ret["stages"] = stages;
+	ret["systems"] = systems;
+	return ret;
+}
+
 void PipelineECS::add_system_bundle(const StringName &p_bundle_name) {
 	ERR_FAIL_COND_MSG(system_bundles.find(p_bundle_name) != -1, "This bundle: " + p_bundle_name + " is already in the world.");
 	system_bundles.push_back(p_bundle_name);
@@ -146,6 +224,8 @@ Pipeline *PipelineECS::get_pipeline() {
 	// Build the pipeline.
 	pipeline = memnew(Pipeline);
 	PipelineBuilder::build_pipeline(system_bundles, systems_name, pipeline);
+	pipeline->set_threads_count(threads_count);
+	pipeline->set_profiling_enabled(profiling_enabled);
 
 	return pipeline;
 }
@@ -206,6 +286,14 @@ void WorldECS::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("destroy_entity", "entity_id"), &WorldECS::destroy_entity);
 
 	ClassDB::bind_method(D_METHOD("create_entity_from_prefab", "entity_node"), &WorldECS::create_entity_from_prefab);
+	ClassDB::bind_method(D_METHOD("create_entities_from_prefab", "entity_node", "count"), &WorldECS::create_entities_from_prefab);
+
+	ClassDB::bind_method(D_METHOD("save_snapshot", "path"), &WorldECS::save_snapshot);
+	ClassDB::bind_method(D_METHOD("load_snapshot", "path"), &WorldECS::load_snapshot);
+
+	ClassDB::bind_method(D_METHOD("fork"), &WorldECS::fork);
+	ClassDB::bind_method(D_METHOD("restore_fork", "fork_id"), &WorldECS::restore_fork);
+	ClassDB::bind_method(D_METHOD("release_fork", "fork_id"), &WorldECS::release_fork);
 
 	ClassDB::bind_method(D_METHOD("add_component_by_name", "entity_id", "component_name", "data"), &WorldECS::add_component_by_name);
 	ClassDB::bind_method(D_METHOD("add_component", "entity_id", "component_id", "data"), &WorldECS::add_component);
@@ -626,7 +714,7 @@ void WorldECS::unactive_world() {
 
 uint32_t WorldECS::create_entity() {
 	CRASH_COND_MSG(world == nullptr, "The world is never nullptr.");
-	return world->create_entity_index();
+	return world->create_entity_index().get_raw_id();
 }
 
 void WorldECS::destroy_entity(uint32_t p_entity_id) {
@@ -637,10 +725,61 @@ void WorldECS::destroy_entity(uint32_t p_entity_id) {
 uint32_t WorldECS::create_entity_from_prefab(Object *p_entity) {
 	CRASH_COND_MSG(world == nullptr, "The world is never nullptr.");
 
-	const Entity3D *entity = cast_to<Entity3D>(p_entity);
-	ERR_FAIL_COND_V_MSG(entity == nullptr, UINT32_MAX, "The passed object is not an `Entity` `Node`.");
+	const Entity3D *entity_3d = cast_to<Entity3D>(p_entity);
+	if (entity_3d != nullptr) {
+		return entity_3d->_create_entity(world).get_raw_id();
+	}
+	const Entity2D *entity_2d = cast_to<Entity2D>(p_entity);
+	ERR_FAIL_COND_V_MSG(entity_2d == nullptr, UINT32_MAX, "The passed object is not an `Entity` `Node`.");
+
+	return entity_2d->_create_entity(world).get_raw_id();
+}
+
+PackedInt32Array WorldECS::create_entities_from_prefab(Object *p_entity, uint32_t p_count) {
+	CRASH_COND_MSG(world == nullptr, "The world is never nullptr.");
+
+	PackedInt32Array ret;
+	LocalVector<EntityID> entities;
+	const Entity3D *entity_3d = cast_to<Entity3D>(p_entity);
+	if (entity_3d != nullptr) {
+		entity_3d->_create_entities(world, p_count, entities);
+	} else {
+		const Entity2D *entity_2d = cast_to<Entity2D>(p_entity);
+		ERR_FAIL_COND_V_MSG(entity_2d == nullptr, ret, "The passed object is not an `Entity` `Node`.");
+		entity_2d->_create_entities(world, p_count, entities);
+	}
+
+	ret.resize(entities.size());
+	int32_t *ptr = ret.ptrw();
+	for (uint32_t i = 0; i < entities.size(); i += 1) {
+		ptr[i] = entities[i].get_raw_id();
+	}
+	return ret;
+}
+
+Error WorldECS::save_snapshot(const String &p_path) const {
+	CRASH_COND_MSG(world == nullptr, "The world is never nullptr.");
+	return world->save_snapshot_to_file(p_path);
+}
+
+Error WorldECS::load_snapshot(const String &p_path) {
+	CRASH_COND_MSG(world == nullptr, "The world is never nullptr.");
+	return world->load_snapshot_from_file(p_path);
+}
 
-	return entity->_create_entity(world);
+uint32_t WorldECS::fork() {
+	CRASH_COND_MSG(world == nullptr, "The world is never nullptr.");
+	return world->fork();
+}
+
+Error WorldECS::restore_fork(uint32_t p_fork_id) {
+	CRASH_COND_MSG(world == nullptr, "The world is never nullptr.");
+	return world->restore_fork(p_fork_id);
+}
+
+void WorldECS::release_fork(uint32_t p_fork_id) {
+	CRASH_COND_MSG(world == nullptr, "The world is never nullptr.");
+	world->release_fork(p_fork_id);
 }
 
 void WorldECS::add_component_by_name(uint32_t entity_id, const StringName &p_component_name, const Dictionary &p_data) {
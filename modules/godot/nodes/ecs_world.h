@@ -24,6 +24,12 @@ class PipelineECS : public Resource {
 	Vector<StringName> systems_name;
 	Vector<StringName> system_bundles;
 
+	/// Threads used to dispatch this pipeline, `-1` uses all the cores.
+	int threads_count = -1;
+
+	/// When `true` the pipeline records the stats of each dispatch.
+	bool profiling_enabled = false;
+
 	// This is just a cache value so to avoid rebuild the pipeline each time
 	// it's activated.
 	Pipeline *pipeline = nullptr;
@@ -49,6 +55,25 @@ public:
 	void set_system_bundles(Vector<StringName> p_system_bundles);
 	Vector<StringName> get_system_bundles();
 
+	void set_threads_count(int p_count);
+	int get_threads_count() const;
+
+	void set_profiling_enabled(bool p_enabled);
+	bool is_profiling_enabled() const;
+
+	/// Returns the number of frames recorded by the profiler so far.
+	int get_profiler_frames_count() const;
+
+	/// Returns the stats of the frame dispatched `p_frames_ago` frames ago, `0`
+	/// being the last one, in this format:
+	/// {"frame": 10, "time_usec": 1200,
+	///  "stages": [time_usec, ...],
+	///  "systems": [{"name": "SystemName", "time_usec": 100, "calls": 1, "entities": 30}, ...]}
+	/// Returns an empty `Dictionary` when the frame is not available.
+	Dictionary get_profiler_frame(int p_frames_ago = 0) const;
+	/// Same as `get_profiler_frame`, for any `Pipeline`.
+	static Dictionary profiler_frame_to_dictionary(const Pipeline *p_pipeline, uint32_t p_frames_ago);
+
 	/// Insert a new system bundle into the world.
 	void add_system_bundle(const StringName &p_bundle_name);
 
@@ -158,6 +183,22 @@ public:
 
 	/// Creates an entity coping the components from the given `Entity`.
 	uint32_t create_entity_from_prefab(Object *p_entity);
+	/// Creates `p_count` entities coping the components from the given
+	/// `Entity`. The `Entity` is converted only once, then its components are
+	/// inserted in batch to the other entities.
+	PackedInt32Array create_entities_from_prefab(Object *p_entity, uint32_t p_count);
+
+	/// Stores the entities and their components into a binary snapshot file.
+	Error save_snapshot(const String &p_path) const;
+	/// Restores the snapshot file into this world, that must have no entities.
+	Error load_snapshot(const String &p_path);
+
+	/// Forks the world, so it can be rolled back later: see `World::fork`.
+	uint32_t fork();
+	/// Rolls back the world to the given fork.
+	Error restore_fork(uint32_t p_fork_id);
+	/// Drops the given fork and the older ones.
+	void release_fork(uint32_t p_fork_id);
 
 	void add_component_by_name(uint32_t entity_id, const StringName &p_component_name, const Dictionary &p_data);
 	void add_component(uint32_t entity_id, uint32_t p_component_id, const Dictionary &p_data);
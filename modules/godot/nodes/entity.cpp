@@ -13,6 +13,174 @@ EntityBase *EntityBase::get_node_entity_base(Node *p_node) {
 	return &entity_3d->get_internal_entity_base();
 }
 
+/// Scene path -> the resolved components, shared by the scene instances.
+static OAHashMap<String, LocalVector<EntityBase::BakedComponent>> baked_scenes;
+
+/// Returns `true` when the depot stores the typed component data.
+static bool is_static_depot(const Ref<ComponentDepot> &p_depot) {
+	return dynamic_cast<const StaticComponentDepot *>(p_depot.ptr()) != nullptr;
+}
+
+/// Returns `true` when `p_baked` resolves exactly the components of
+/// `p_components`, stored in the same kind of depot.
+static bool baked_components_match(const LocalVector<EntityBase::BakedComponent> &p_baked, const OAHashMap<StringName, Ref<ComponentDepot>> &p_components) {
+	uint32_t count = 0;
+	for (OAHashMap<StringName, Ref<ComponentDepot>>::Iterator it = p_components.iter();
+			it.valid;
+			it = p_components.next_iter(it)) {
+		if (it.value->is_valid()) {
+			count += 1;
+		}
+	}
+	if (count != p_baked.size()) {
+		return false;
+	}
+	for (uint32_t i = 0; i < p_baked.size(); i += 1) {
+		const Ref<ComponentDepot> *depot = p_components.lookup_ptr(p_baked[i].name);
+		if (depot == nullptr || depot->is_null() || is_static_depot(*depot) != p_baked[i].is_static) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/// Resolves the components into `r_baked`. Returns `false` if a component is
+/// not registered yet (likely an unloaded script): it's skipped.
+static bool bake_components(const OAHashMap<StringName, Ref<ComponentDepot>> &p_components, LocalVector<EntityBase::BakedComponent> &r_baked) {
+	r_baked.clear();
+	bool complete = true;
+	for (OAHashMap<StringName, Ref<ComponentDepot>>::Iterator it = p_components.iter();
+			it.valid;
+			it = p_components.next_iter(it)) {
+		if (it.value->is_null()) {
+			continue;
+		}
+
+		const godex::component_id component_id = ECS::get_component_id(*it.key);
+		if (component_id == godex::COMPONENT_NONE) {
+			ERR_PRINT("The component " + String(*it.key) + " doesn't exist.");
+			complete = false;
+			continue;
+		}
+
+		EntityBase::BakedComponent baked;
+		baked.name = *it.key;
+		baked.component_id = component_id;
+		baked.is_shared = ECS::is_component_sharable(component_id);
+		baked.is_transform = (*it.key) == SNAME("TransformComponent");
+		baked.is_static = is_static_depot(*it.value);
+		r_baked.push_back(baked);
+	}
+	return complete;
+}
+
+const LocalVector<EntityBase::BakedComponent> &EntityBase::get_baked_components(const String &p_scene_path, LocalVector<BakedComponent> &r_scratch) const {
+	if (p_scene_path.is_empty()) {
+		// Not instanced from a scene, nothing to share.
+		bake_components(components_data, r_scratch);
+		return r_scratch;
+	}
+
+	const LocalVector<BakedComponent> *baked = baked_scenes.lookup_ptr(p_scene_path);
+	if (baked != nullptr && baked_components_match(*baked, components_data)) {
+		return *baked;
+	}
+
+	// Not baked yet, or this instance (or the scene) changed its components:
+	// bake it again, the next instances share it.
+	if (bake_components(components_data, r_scratch)) {
+		baked_scenes.set(p_scene_path, r_scratch);
+	}
+	return r_scratch;
+}
+
+void EntityBase::clear_baked_scenes() {
+	baked_scenes.clear();
+}
+
+/// Collects the nodes of the `Entities` not yet created, in tree order.
+static void collect_scene_entities(Node *p_node, LocalVector<EntityInternal<Entity3D> *> &r_entities_3d, LocalVector<EntityInternal<Entity2D> *> &r_entities_2d) {
+	Entity3D *entity_3d = Object::cast_to<Entity3D>(p_node);
+	if (entity_3d != nullptr) {
+		if (entity_3d->get_internal_entity().entity_id.is_null()) {
+			r_entities_3d.push_back(&entity_3d->get_internal_entity());
+		}
+	} else {
+		Entity2D *entity_2d = Object::cast_to<Entity2D>(p_node);
+		if (entity_2d != nullptr && entity_2d->get_internal_entity().entity_id.is_null()) {
+			r_entities_2d.push_back(&entity_2d->get_internal_entity());
+		}
+	}
+
+	for (int i = 0; i < p_node->get_child_count(); i += 1) {
+		collect_scene_entities(p_node->get_child(i), r_entities_3d, r_entities_2d);
+	}
+}
+
+/// Creates the `Entities` of `p_nodes`: the consecutive nodes instanced from
+/// the same scene, having the same components, are converted in one batch.
+template <class C>
+static void create_entities_batched(World *p_world, const LocalVector<EntityInternal<C> *> &p_nodes) {
+	// Group the nodes by scene, so the instances of a scene are consecutive.
+	OAHashMap<String, LocalVector<EntityInternal<C> *>> scenes;
+	for (uint32_t i = 0; i < p_nodes.size(); i += 1) {
+		const String path = p_nodes[i]->owner->get_scene_file_path();
+		LocalVector<EntityInternal<C> *> *scene = scenes.lookup_ptr(path);
+		if (scene == nullptr) {
+			scenes.set(path, LocalVector<EntityInternal<C> *>());
+			scene = scenes.lookup_ptr(path);
+		}
+		scene->push_back(p_nodes[i]);
+	}
+
+	LocalVector<EntityBase::BakedComponent> scratch;
+	LocalVector<EntityBase::BakedComponent> baked;
+	LocalVector<EntityID> entities;
+	for (typename OAHashMap<String, LocalVector<EntityInternal<C> *>>::Iterator it = scenes.iter();
+			it.valid;
+			it = scenes.next_iter(it)) {
+		const LocalVector<EntityInternal<C> *> &scene = *it.value;
+
+		uint32_t begin = 0;
+		while (begin < scene.size()) {
+			// Copy it, the next bake may change the shared one.
+			baked = scene[begin]->get_baked_components(*it.key, scratch);
+
+			uint32_t end = begin + 1;
+			while (end < scene.size() && baked_components_match(baked, scene[end]->components_data)) {
+				end += 1;
+			}
+
+			entities.clear();
+			EntityInternal<C>::_create_entities_batch(p_world, scene.ptr() + begin, end - begin, baked, entities);
+			for (uint32_t i = begin; i < end; i += 1) {
+				scene[i]->entity_id = entities[i - begin];
+			}
+			begin = end;
+		}
+	}
+}
+
+void EntityBase::create_scene_entities(Node *p_root, World *p_world) {
+	ERR_FAIL_COND(p_root == nullptr);
+	ERR_FAIL_COND(p_world == nullptr);
+
+	LocalVector<EntityInternal<Entity3D> *> entities_3d;
+	LocalVector<EntityInternal<Entity2D> *> entities_2d;
+	collect_scene_entities(p_root, entities_3d, entities_2d);
+
+	create_entities_batched(p_world, entities_3d);
+	create_entities_batched(p_world, entities_2d);
+
+	// All the `Entities` exist: now notify them, in tree order.
+	for (uint32_t i = 0; i < entities_3d.size(); i += 1) {
+		entities_3d[i]->_notify_entity_created();
+	}
+	for (uint32_t i = 0; i < entities_2d.size(); i += 1) {
+		entities_2d[i]->_notify_entity_created();
+	}
+}
+
 void EntityBase::add_child(EntityID p_entity_id) {
 	ERR_FAIL_COND_MSG(entity_id.is_null(), "The entity_id is not supposed to be null.");
 	ERR_FAIL_COND_MSG(p_entity_id.is_null(), "The passed entity_id is not supposed to be null.");
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../components/transform_component.h"
 #include "core/templates/list.h"
 #include "core/templates/local_vector.h"
 #include "ecs_world.h"
@@ -40,11 +41,36 @@ struct EntityBase {
 	OAHashMap<StringName, Ref<ComponentGizmoData>> gizmo_data;
 #endif
 
+	/// The conversion data of a single component, resolved once.
+	struct BakedComponent {
+		StringName name;
+		godex::component_id component_id = godex::COMPONENT_NONE;
+		bool is_shared = false;
+		bool is_transform = false;
+		/// The data is stored typed by a `StaticComponentDepot`, so it's
+		/// inserted without passing through a `Dictionary`.
+		bool is_static = false;
+	};
+
 	EntityID entity_id;
 	OAHashMap<StringName, Ref<ComponentDepot>> components_data;
 
 	EntityBase *get_node_entity_base(Node *p_node);
 
+	/// Returns the resolved components of this `Entity`. The components of
+	/// the `Entities` instanced from the same scene (`p_scene_path`) are
+	/// resolved once and shared, so loading a level with many instances of a
+	/// prefab doesn't resolve each `Entity` again. `r_scratch` is used when
+	/// nothing can be shared.
+	const LocalVector<BakedComponent> &get_baked_components(const String &p_scene_path, LocalVector<BakedComponent> &r_scratch) const;
+	/// Releases the components resolved for the scenes.
+	static void clear_baked_scenes();
+
+	/// Creates the `Entities` of all the `Entity3D` and `Entity2D` nodes under
+	/// `p_root` that don't have one yet. The nodes instanced from the same
+	/// scene are converted together, inserting each component in batch.
+	static void create_scene_entities(Node *p_root, World *p_world);
+
 	void add_child(EntityID p_entity_id);
 	void remove_child(EntityID p_entity_id);
 };
@@ -84,7 +110,16 @@ struct EntityInternal : public EntityBase {
 	void solve_parenting_with_parent();
 
 	void create_entity();
+	/// Assigns the `NodePath` to the created `Entity` and notifies the nodes.
+	void _notify_entity_created();
 	EntityID _create_entity(World *p_world) const;
+	/// Creates an `Entity` for each of the `p_count` nodes, appended to
+	/// `r_entities`. All the nodes must have the `p_baked` components: the
+	/// data of each component is inserted in batch.
+	static void _create_entities_batch(World *p_world, const EntityInternal<C> *const *p_nodes, uint32_t p_count, const LocalVector<BakedComponent> &p_baked, LocalVector<EntityID> &r_entities);
+	/// Creates `p_count` `Entities` out of this one, using batched inserts
+	/// for all the `Entities` after the first.
+	void _create_entities(World *p_world, uint32_t p_count, LocalVector<EntityID> &r_entities) const;
 	void destroy_entity();
 	void notify_property_list_changed();
 
@@ -175,7 +210,7 @@ public:
 		entity._notification(p_what);
 	}
 
-	uint32_t script_get_entity_id() const { return entity.entity_id; }
+	uint32_t script_get_entity_id() const { return entity.entity_id.get_raw_id(); }
 	EntityID get_entity_id() const { return entity.entity_id; }
 
 	void add_component(const StringName &p_component_name, const Dictionary &p_values) {
@@ -222,6 +257,10 @@ public:
 		return entity._create_entity(p_world);
 	}
 
+	void _create_entities(World *p_world, uint32_t p_count, LocalVector<EntityID> &r_entities) const {
+		entity._create_entities(p_world, p_count, r_entities);
+	}
+
 	void destroy_entity() {
 		entity.destroy_entity();
 	}
@@ -297,7 +336,7 @@ public:
 		entity._notification(p_what);
 	}
 
-	uint32_t script_get_entity_id() const { return entity.entity_id; }
+	uint32_t script_get_entity_id() const { return entity.entity_id.get_raw_id(); }
 	EntityID get_entity_id() const { return entity.entity_id; }
 
 	void add_component(const StringName &p_component_name, const Dictionary &p_values) {
@@ -344,6 +383,10 @@ public:
 		return entity._create_entity(p_world);
 	}
 
+	void _create_entities(World *p_world, uint32_t p_count, LocalVector<EntityID> &r_entities) const {
+		entity._create_entities(p_world, p_count, r_entities);
+	}
+
 	void destroy_entity() {
 		entity.destroy_entity();
 	}
@@ -476,10 +519,8 @@ void EntityInternal<C>::_notification(int p_what) {
 			// This happens always after `READY` and differently from
 			// `NOTIFICATION_READY` it's not propagated in reverse: so the
 			// parent at this point is always initialized.
-#ifdef TOOLS_ENABLED
-			// At this point the entity is never created.
-			CRASH_COND(entity_id.is_null() == false);
-#endif
+			// The `Entity` is usually already created in batch by
+			// `EntityBase::create_scene_entities`, so this does nothing.
 			create_entity();
 			// Solving backward because this call is executed first on the parent
 			// later on the childs.
@@ -752,11 +793,17 @@ void EntityInternal<C>::create_entity() {
 		// It's safe dereference command because this function is always called
 		// when the world is not dispatching.
 		entity_id = _create_entity(ECS::get_singleton()->get_active_world());
-		if (get_reference_by_nodepath()) {
-			ECS::get_singleton()->get_active_world()->assign_nodepath_to_entity(
-					entity_id,
-					owner->get_path());
-		}
+	}
+
+	_notify_entity_created();
+}
+
+template <class C>
+void EntityInternal<C>::_notify_entity_created() {
+	if (entity_id.is_null() == false && get_reference_by_nodepath()) {
+		ECS::get_singleton()->get_active_world()->assign_nodepath_to_entity(
+				entity_id,
+				owner->get_path());
 	}
 
 	owner->propagate_notification(ECS::NOTIFICATION_ECS_ENTITY_CREATED);
@@ -766,49 +813,95 @@ template <class C>
 EntityID EntityInternal<C>::_create_entity(World *p_world) const {
 	EntityID id;
 	if (p_world) {
-		id = p_world->create_entity();
-
-		const bool try_set_global =
-				Object::cast_to<Entity3D>(owner) != nullptr &&
-				owner->get_parent() != nullptr &&
-				Object::cast_to<Entity3D>(owner->get_parent()) == nullptr;
-
-		for (OAHashMap<StringName, Ref<ComponentDepot>>::Iterator it = components_data.iter();
-				it.valid;
-				it = components_data.next_iter(it)) {
-			const uint32_t component_id = ECS::get_component_id(*it.key);
-			ERR_CONTINUE(component_id == godex::COMPONENT_NONE);
-
-			if (it.value->is_valid()) {
-				if (ECS::is_component_sharable(component_id)) {
-					Ref<SharedComponentResource> shared = (*it.value)->get(SNAME("resource"));
-					if (shared.is_valid()) {
-						godex::SID sid = shared->get_sid(p_world);
-						p_world->add_shared_component(id, component_id, sid);
-					}
+		LocalVector<BakedComponent> scratch;
+		const LocalVector<BakedComponent> &baked_components = get_baked_components(owner->get_scene_file_path(), scratch);
+
+		const EntityInternal<C> *node = this;
+		LocalVector<EntityID> entities;
+		_create_entities_batch(p_world, &node, 1, baked_components, entities);
+		if (entities.size() == 1) {
+			id = entities[0];
+		}
+	}
+	return id;
+}
+
+template <class C>
+void EntityInternal<C>::_create_entities_batch(World *p_world, const EntityInternal<C> *const *p_nodes, uint32_t p_count, const LocalVector<BakedComponent> &p_baked, LocalVector<EntityID> &r_entities) {
+	const uint32_t start = r_entities.size();
+	p_world->create_entities(p_count, r_entities);
+	ERR_FAIL_COND_MSG(r_entities.size() - start != p_count, "The maximum number of `Entities` is reached.");
+	const EntityID *entities = r_entities.ptr() + start;
+
+	// The global transforms must outlive the batched insert, and this is
+	// reserved so the pointers to them stay valid.
+	LocalVector<TransformComponent> global_transforms;
+	LocalVector<const void *> data;
+	data.resize(p_count);
+
+	for (uint32_t c = 0; c < p_baked.size(); c += 1) {
+		const BakedComponent &baked = p_baked[c];
+
+		if (baked.is_static) {
+			if (baked.is_transform) {
+				global_transforms.reserve(p_count);
+			}
+			for (uint32_t i = 0; i < p_count; i += 1) {
+				const EntityInternal<C> *node = p_nodes[i];
+				const bool set_global =
+						baked.is_transform &&
+						Object::cast_to<Entity3D>(node->owner) != nullptr &&
+						node->owner->get_parent() != nullptr &&
+						Object::cast_to<Entity3D>(node->owner->get_parent()) == nullptr;
+
+				if (set_global) {
+					// This is an hack to set the global transform (ignoring the
+					// TransformComponent) when the Entity is parented of a Node3D:
+					// In this way the Entity transform we set on the editor, is always
+					// respected.
+					global_transforms.push_back(TransformComponent(((const Entity3D *)node->owner)->get_global_transform()));
+					data[i] = &global_transforms[global_transforms.size() - 1];
 				} else {
-					if (try_set_global && (*it.key) == SNAME("TransformComponent")) {
-						// This is an hack to set the global transform (ignoring the
-						// TransformComponent) when the Entity is parented of a Node3D:
-						// In this way the Entity transform we set on the editor, is always
-						// respected.
-						Dictionary data;
-						data["transform"] = ((const Entity3D *)owner)->get_global_transform();
-						p_world->add_component(
-								id,
-								component_id,
-								data);
-					} else {
-						p_world->add_component(
-								id,
-								component_id,
-								(*it.value)->get_properties_data());
-					}
+					const StaticComponentDepot *depot = static_cast<const StaticComponentDepot *>(node->components_data.lookup_ptr(baked.name)->ptr());
+					data[i] = depot->get_component();
+				}
+			}
+			p_world->add_component_batch(entities, p_count, baked.component_id, data.ptr());
+
+		} else if (baked.is_shared) {
+			for (uint32_t i = 0; i < p_count; i += 1) {
+				const Dictionary shared_data = (*p_nodes[i]->components_data.lookup_ptr(baked.name))->get_properties_data();
+				Ref<SharedComponentResource> shared = shared_data[SNAME("resource")];
+				if (shared.is_valid()) {
+					godex::SID sid = shared->get_sid(p_world);
+					p_world->add_shared_component(entities[i], baked.component_id, sid);
 				}
 			}
+
+		} else {
+			// The script components store their data into a `Dictionary`.
+			for (uint32_t i = 0; i < p_count; i += 1) {
+				p_world->add_component(
+						entities[i],
+						baked.component_id,
+						(*p_nodes[i]->components_data.lookup_ptr(baked.name))->get_properties_data());
+			}
 		}
 	}
-	return id;
+}
+
+template <class C>
+void EntityInternal<C>::_create_entities(World *p_world, uint32_t p_count, LocalVector<EntityID> &r_entities) const {
+	ERR_FAIL_COND(p_world == nullptr);
+	if (p_count == 0) {
+		return;
+	}
+
+	// Only the first `Entity` goes through the component conversion, all the
+	// others copy its components, storage by storage.
+	const EntityID prototype = _create_entity(p_world);
+	r_entities.push_back(prototype);
+	p_world->create_entities(p_count - 1, prototype, r_entities);
 }
 
 template <class C>
@@ -168,6 +168,7 @@ void uninitialize_godot_module(ModuleInitializationLevel p_level) {
 			ScriptEcs::get_singleton()->reset_editor_default_component_properties();
 		}
 		memdelete(ScriptEcs::get_singleton());
+		EntityBase::clear_baked_scenes();
 	} else if (p_level == MODULE_INITIALIZATION_LEVEL_EDITOR) {
 		if (Engine::get_singleton()->is_editor_hint()) {
 			ScriptEcs::get_singleton()->reset_editor_default_component_properties();
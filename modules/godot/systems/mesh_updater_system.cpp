@@ -49,14 +49,20 @@ void interpolates_transform(
 	// notifications, otherwise triggered by this system.
 	p_pipeline_commands->set_active_system(SNAME("BtTeleportBodies"), false);
 
-	for (auto [transform, interpolated_transform] : p_query) {
+	const real_t fraction = p_frame_time->get_physics_interpolation_fraction();
+	const real_t delta = p_frame_time->get_physics_delta();
+
+	// Each entity is independent: split the work between the workers.
+	p_query.par_for_each([fraction, delta](auto p_components) {
+		auto [transform, interpolated_transform] = p_components;
+
 		transform->origin = hermite_interpolate(
-				p_frame_time->get_physics_interpolation_fraction(),
+				fraction,
 				interpolated_transform->previous_transform.origin,
 				interpolated_transform->current_transform.origin,
 				interpolated_transform->previous_linear_velocity,
 				interpolated_transform->current_linear_velocity,
-				p_frame_time->get_physics_delta());
+				delta);
 
 		// TODO Exist a better way of interpolate two Matrix?
 		const Vector3 start_scale = interpolated_transform->previous_transform.basis.get_scale();
@@ -68,11 +74,11 @@ void interpolates_transform(
 		transform->basis.set_quaternion_scale(
 				start_rotation.slerp(
 						end_rotation,
-						p_frame_time->get_physics_interpolation_fraction()),
+						fraction),
 				start_scale.lerp(
 						end_scale,
-						p_frame_time->get_physics_interpolation_fraction()));
-	}
+						fraction));
+	});
 
 	// Enable the system again, so it can receive notifications.
 	p_pipeline_commands->set_active_system(SNAME("BtTeleportBodies"), true);
@@ -3,8 +3,18 @@
 #include "../ecs.h"
 #include "../storage/hierarchical_storage.h"
 #include "../world/world.h"
+#include "core/os/os.h"
 #include "pipeline_commands.h"
 
+/// Data shared by the threads that are dispatching the same stage.
+struct StageDispatchData {
+	const ExecutionSystemData *systems;
+	uint8_t *const *system_data_ptrs;
+	World *world;
+	/// `nullptr` when the profiling is disabled.
+	PipelineProfiler *profiler;
+};
+
 Pipeline::Pipeline() {}
 
 bool Pipeline::is_ready() const {
@@ -24,6 +34,7 @@ void Pipeline::reset() {
 	ready = false;
 	temporary_systems.clear();
 	dispatchers.clear();
+	profiler.clear();
 
 	// Deallocate any valid token.
 	for (uint32_t i = 0; i < worlds.size(); i += 1) {
@@ -34,6 +45,46 @@ void Pipeline::reset() {
 	}
 }
 
+void Pipeline::set_threads_count(int p_count) {
+	ERR_FAIL_COND_MSG(p_count == 0 || p_count < -1, "The threads count must be `-1` or greater than `0`.");
+	if (threads_count == p_count) {
+		return;
+	}
+	threads_count = p_count;
+	thread_pool_dirty = true;
+}
+
+int Pipeline::get_threads_count() const {
+	return threads_count;
+}
+
+void Pipeline::update_thread_pool() {
+	if (likely(thread_pool_dirty == false)) {
+		return;
+	}
+	thread_pool_dirty = false;
+
+	const int count = threads_count == -1 ? OS::get_singleton()->get_processor_count() : threads_count;
+	// The dispatching thread is not part of the pool.
+	thread_pool.set_threads_count(MAX(count - 1, 0));
+}
+
+void Pipeline::set_profiling_enabled(bool p_enabled) {
+	profiling_enabled = p_enabled;
+}
+
+bool Pipeline::is_profiling_enabled() const {
+	return profiling_enabled;
+}
+
+PipelineProfiler &Pipeline::get_profiler() {
+	return profiler;
+}
+
+const PipelineProfiler &Pipeline::get_profiler() const {
+	return profiler;
+}
+
 Token Pipeline::get_token(World *p_world) {
 	Token token;
 
@@ -210,6 +261,10 @@ void Pipeline::create_used_storage(const SystemExeInfo &p_info, World *p_world)
 		p_world->create_events_storage(e->get());
 	}
 
+	for (const RBSet<uint32_t>::Element *e = p_info.shared_events_emitters.front(); e; e = e->next()) {
+		p_world->create_events_storage(e->get());
+	}
+
 	for (
 			OAHashMap<uint32_t, RBSet<String>>::Iterator it = p_info.events_receivers.iter();
 			it.valid;
@@ -318,8 +373,12 @@ void Pipeline::dispatch(Token p_token) {
 	World *world = worlds[p_token.index].world;
 	ERR_FAIL_COND_MSG(world->is_dispatching_in_progress, "Dispatching is already in progress for this world. Only one pipeline is allowed to be dispatched on a world.");
 
+	// Make sure the workers are ready.
+	update_thread_pool();
+
 	// Prepare the world for dispatching.
 	world->is_dispatching_in_progress = true;
+	world->thread_pool = &thread_pool;
 	PipelineCommands *pipeline_commands = world->get_databag<PipelineCommands>();
 #ifdef DEBUG_ENABLED
 	CRASH_COND_MSG(pipeline_commands == nullptr, "The PipelineCommands is never expected to be nullptr, since this class make sure to add it on this world.");
@@ -327,8 +386,14 @@ void Pipeline::dispatch(Token p_token) {
 	pipeline_commands->world_data = worlds.ptr() + p_token.index;
 	pipeline_commands->pipeline = this;
 
+	if (profiling_enabled) {
+		profiler.begin_frame();
+	}
+
 	Hierarchy *hierarchy = static_cast<Hierarchy *>(world->get_storage<Child>());
 	if (hierarchy) {
+		// Allow the hierarchical storages to propagate the changes in parallel.
+		hierarchy->set_thread_pool(&thread_pool);
 		// Flush the hierarchy.
 		hierarchy->flush_hierarchy_changes();
 	}
@@ -338,6 +403,9 @@ void Pipeline::dispatch(Token p_token) {
 		if (worlds[p_token.index].temporary_systems[i].exec_func(
 					worlds[p_token.index].temporary_systems[i].system_data,
 					world)) {
+			// Apply its commands before its `CommandBuffer` is destroyed.
+			world->flush_command_buffers();
+
 			// This system is done, deallocate.
 			uint8_t *mem = worlds[p_token.index].temporary_systems[i].system_data;
 			ECS::system_delete_placement_system_data(worlds[p_token.index].temporary_systems[i].id, mem);
@@ -347,6 +415,8 @@ void Pipeline::dispatch(Token p_token) {
 		}
 	}
 
+	world->flush_command_buffers();
+
 	dispatch_sub_dispatcher(p_token, 0);
 
 	// TODO remove this, in favour of the new mechanism
@@ -357,9 +427,18 @@ void Pipeline::dispatch(Token p_token) {
 		}
 	}
 
+	if (profiler.is_recording()) {
+		profiler.end_frame();
+	}
+
+	if (hierarchy) {
+		hierarchy->set_thread_pool(nullptr);
+	}
+
 	// Release the world dispatching.
 	pipeline_commands->world_data = nullptr;
 	pipeline_commands->pipeline = nullptr;
+	world->thread_pool = nullptr;
 	world->is_dispatching_in_progress = false;
 }
 
@@ -370,24 +449,89 @@ void Pipeline::dispatch_sub_dispatcher(Token p_token, int p_dispatcher_index) {
 	const LocalVector<uint8_t *> &system_data_ptrs = worlds[p_token.index].system_data;
 	const DispatcherData &dispatcher = dispatchers[p_dispatcher_index];
 
+	// Only set when this frame is being profiled.
+	PipelineProfiler *stage_profiler = profiler.is_recording() ? &profiler : nullptr;
+	const uint32_t first_stage_index = stage_profiler ? get_stage_index(p_dispatcher_index, 0) : 0;
+
 	// Dispatch the `Stage`s.
 	for (uint32_t stage_i = 0; stage_i < dispatcher.exec_stages.size(); stage_i += 1) {
-		// TODO execute in multuple thread.
-		for (uint32_t i = 0; i < dispatcher.exec_stages[stage_i].systems.size(); i += 1) {
-			const uint32_t index = dispatcher.exec_stages[stage_i].systems[i].index;
-			dispatcher.exec_stages[stage_i].systems[i].exe(
-					system_data_ptrs[index],
-					world);
+		const ExecutionStageData &stage = dispatcher.exec_stages[stage_i];
+		const uint64_t stage_begin_usec = stage_profiler ? OS::get_singleton()->get_ticks_usec() : 0;
+
+		// Open the per thread buffers of the events emitted in parallel.
+		for (uint32_t e = 0; e < stage.shared_events.size(); e += 1) {
+			world->get_events_storage(stage.shared_events[e])->begin_shared_emission(thread_pool.get_threads_count() + 1);
+		}
+
+		if (stage.systems.size() == 1) {
+			// Nothing to split, execute it right away.
+			execute_system(
+					stage.systems[0],
+					system_data_ptrs[stage.systems[0].index],
+					world,
+					stage_profiler);
+		} else {
+			// The systems of a stage can run in parallel, fan them out to the
+			// workers; this returns once all of them are done.
+			StageDispatchData data;
+			data.systems = stage.systems.ptr();
+			data.system_data_ptrs = system_data_ptrs.ptr();
+			data.world = world;
+			data.profiler = stage_profiler;
+			thread_pool.run(dispatch_stage_system, &data, stage.systems.size());
 		}
 
 		// TODO move this inside the DataFetcher instead?
 		// Notify the `System` released the storage for this stage.
-		for (uint32_t f = 0; f < dispatcher.exec_stages[stage_i].notify_list_release_write.size(); f += 1) {
-			world->get_storage(dispatcher.exec_stages[stage_i].notify_list_release_write[f])->on_system_release();
+		for (uint32_t f = 0; f < stage.notify_list_release_write.size(); f += 1) {
+			world->get_storage(stage.notify_list_release_write[f])->on_system_release();
+		}
+
+		// Make the events emitted in parallel available to the next stages.
+		for (uint32_t e = 0; e < stage.shared_events.size(); e += 1) {
+			world->get_events_storage(stage.shared_events[e])->end_shared_emission();
+		}
+
+		if (p_dispatcher_index == 0) {
+			// Apply the structural changes recorded during this stage. A sub
+			// dispatcher may run in parallel with other systems of the outer
+			// stage, so its changes are applied once the outer stage is done.
+			world->flush_command_buffers();
+		}
+
+		if (stage_profiler) {
+			stage_profiler->add_stage_time(
+					first_stage_index + stage_i,
+					OS::get_singleton()->get_ticks_usec() - stage_begin_usec);
 		}
 	}
 }
 
+void Pipeline::dispatch_stage_system(void *p_user_data, uint32_t p_index) {
+	const StageDispatchData *data = static_cast<const StageDispatchData *>(p_user_data);
+	const ExecutionSystemData &system = data->systems[p_index];
+	execute_system(system, data->system_data_ptrs[system.index], data->world, data->profiler);
+}
+
+void Pipeline::execute_system(const ExecutionSystemData &p_system, uint8_t *p_system_data, World *p_world, PipelineProfiler *p_profiler) {
+	if (p_profiler == nullptr) {
+		p_system.exe(p_system_data, p_world);
+		return;
+	}
+
+	// The counter is never reset, so the `Entities` counted by the nested
+	// sub dispatchers are included too.
+	const uint64_t entities_begin = PipelineProfiler::get_entities_counter();
+	const uint64_t begin_usec = OS::get_singleton()->get_ticks_usec();
+
+	p_system.exe(p_system_data, p_world);
+
+	p_profiler->add_system_time(
+			p_system.index,
+			OS::get_singleton()->get_ticks_usec() - begin_usec,
+			PipelineProfiler::get_entities_counter() - entities_begin);
+}
+
 int Pipeline::get_system_stage(godex::system_id p_system, int p_start_from_dispatcher) const {
 	ERR_FAIL_INDEX_V_MSG(p_start_from_dispatcher, int(dispatchers.size()), -1, "The dispatcher " + itos(p_start_from_dispatcher) + " doesn't exists in this pipeline.");
 
@@ -421,3 +565,44 @@ int Pipeline::get_system_dispatcher(godex::system_id p_system) const {
 	}
 	return -1;
 }
+
+uint32_t Pipeline::get_stages_count() const {
+	uint32_t count = 0;
+	for (uint32_t dispatcher_i = 0; dispatcher_i < dispatchers.size(); dispatcher_i += 1) {
+		count += dispatchers[dispatcher_i].exec_stages.size();
+	}
+	return count;
+}
+
+uint32_t Pipeline::get_stage_index(int p_dispatcher_index, uint32_t p_stage) const {
+	uint32_t index = p_stage;
+	for (int dispatcher_i = 0; dispatcher_i < p_dispatcher_index; dispatcher_i += 1) {
+		index += dispatchers[dispatcher_i].exec_stages.size();
+	}
+	return index;
+}
+
+uint32_t Pipeline::get_systems_count() const {
+	uint32_t count = 0;
+	for (uint32_t dispatcher_i = 0; dispatcher_i < dispatchers.size(); dispatcher_i += 1) {
+		const DispatcherData &dispatcher = dispatchers[dispatcher_i];
+		for (uint32_t stage_i = 0; stage_i < dispatcher.exec_stages.size(); stage_i += 1) {
+			count += dispatcher.exec_stages[stage_i].systems.size();
+		}
+	}
+	return count;
+}
+
+godex::system_id Pipeline::get_system_at_index(uint32_t p_index) const {
+	for (uint32_t dispatcher_i = 0; dispatcher_i < dispatchers.size(); dispatcher_i += 1) {
+		const DispatcherData &dispatcher = dispatchers[dispatcher_i];
+		for (uint32_t stage_i = 0; stage_i < dispatcher.exec_stages.size(); stage_i += 1) {
+			for (uint32_t i = 0; i < dispatcher.exec_stages[stage_i].systems.size(); i += 1) {
+				if (dispatcher.exec_stages[stage_i].systems[i].index == p_index) {
+					return dispatcher.exec_stages[stage_i].systems[i].id;
+				}
+			}
+		}
+	}
+	return godex::SYSTEM_NONE;
+}
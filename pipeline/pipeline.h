@@ -2,6 +2,8 @@
 
 #include "../ecs.h"
 #include "../systems/system.h"
+#include "../utils/thread_pool.h"
+#include "pipeline_profiler.h"
 #include "core/templates/local_vector.h"
 
 class World;
@@ -29,6 +31,10 @@ struct ExecutionStageData {
 
 	/// Storages that want to be notified at the end of the `System` execution.
 	LocalVector<godex::component_id> notify_list_release_write;
+
+	/// Events emitted using the `SharedEventsEmitter` during this stage: the
+	/// per thread buffers are opened before the stage and merged right after.
+	LocalVector<godex::event_id> shared_events;
 };
 
 struct DispatcherData {
@@ -67,6 +73,17 @@ private:
 	/// List of worlds ready to be dispatched by this pipeline.
 	LocalVector<WorldData> worlds;
 
+	/// The number of threads used to dispatch this pipeline, the dispatching
+	/// thread included. `-1` means: use all the available cores.
+	int threads_count = -1;
+	/// When `true` the workers are (re)created on the next dispatch.
+	bool thread_pool_dirty = true;
+	ThreadPool thread_pool;
+
+	/// When `true`, the stats of each dispatch are recorded into the `profiler`.
+	bool profiling_enabled = false;
+	PipelineProfiler profiler;
+
 public:
 	Pipeline();
 
@@ -80,6 +97,20 @@ public:
 	/// Reset the pipeline.
 	void reset();
 
+	/// Set the number of threads used to dispatch the systems that can run in
+	/// parallel, the dispatching thread included. `1` dispatches all the
+	/// systems on the calling thread; `-1` uses all the available cores.
+	void set_threads_count(int p_count);
+	int get_threads_count() const;
+
+	/// Enable the profiler to record the time spent by each stage and `System`,
+	/// on each dispatch.
+	void set_profiling_enabled(bool p_enabled);
+	bool is_profiling_enabled() const;
+
+	PipelineProfiler &get_profiler();
+	const PipelineProfiler &get_profiler() const;
+
 	Token get_token(World *p_world);
 
 	/// Prepare the world to be safely dispatched, returns a token to use to
@@ -102,6 +133,9 @@ public:
 
 private:
 	void dispatch_sub_dispatcher(Token p_token, int p_dispatcher_idex);
+	void update_thread_pool();
+	static void dispatch_stage_system(void *p_user_data, uint32_t p_index);
+	static void execute_system(const ExecutionSystemData &p_system, uint8_t *p_system_data, World *p_world, PipelineProfiler *p_profiler);
 
 public:
 	/// Returns the stage index, or -1 if the system is not in pipeline.
@@ -109,4 +143,18 @@ public:
 
 	/// Returns the dispatcher id for this system.
 	int get_system_dispatcher(godex::system_id p_system) const;
+
+	/// Returns the stages count of all the dispatchers.
+	uint32_t get_stages_count() const;
+
+	/// Returns the index of the stage, counting the stages of all the
+	/// dispatchers in order; this is how the profiler indexes the stages.
+	uint32_t get_stage_index(int p_dispatcher_index, uint32_t p_stage) const;
+
+	/// Returns the systems count of all the dispatchers.
+	uint32_t get_systems_count() const;
+
+	/// Returns the `System` at this index within the pipeline; this is how the
+	/// profiler indexes the systems.
+	godex::system_id get_system_at_index(uint32_t p_index) const;
 };
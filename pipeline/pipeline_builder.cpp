@@ -344,6 +344,11 @@ void PipelineBuilder::build_pipeline(
 							}
 						}
 					}
+					for (const RBSet<uint32_t>::Element *e = stage->get().systems[i]->info.shared_events_emitters.front(); e; e = e->next()) {
+						if (r_pipeline->dispatchers[dispatcher_index].exec_stages[stage_index].shared_events.find(e->get()) == -1) {
+							r_pipeline->dispatchers[dispatcher_index].exec_stages[stage_index].shared_events.push_back(e->get());
+						}
+					}
 				}
 			}
 
@@ -375,6 +380,9 @@ void PipelineBuilder::build_pipeline(
 		}
 	}
 
+	// The profiler memory is allocated once here, never while dispatching.
+	r_pipeline->profiler.set_layout(r_pipeline->get_stages_count(), r_pipeline->get_systems_count());
+
 	r_pipeline->ready = true;
 
 	// Build done
@@ -0,0 +1,174 @@
+#include "pipeline_profiler.h"
+
+#include "core/os/os.h"
+
+thread_local uint64_t PipelineProfiler::entities_counter = 0;
+
+PipelineProfiler::PipelineProfiler() {
+	set_history_size(DEFAULT_HISTORY_SIZE);
+}
+
+PipelineProfiler::~PipelineProfiler() {
+	free_slots();
+}
+
+void PipelineProfiler::set_history_size(uint32_t p_size) {
+	ERR_FAIL_COND_MSG(p_size == 0, "The profiler needs to keep at least one frame.");
+	ERR_FAIL_COND_MSG(writing != UINT32_MAX, "The history size can't be changed while the frame is recorded.");
+
+	history_size = p_size;
+	allocate_slots();
+}
+
+uint32_t PipelineProfiler::get_history_size() const {
+	return history_size;
+}
+
+void PipelineProfiler::set_layout(uint32_t p_stages_count, uint32_t p_systems_count) {
+	ERR_FAIL_COND_MSG(writing != UINT32_MAX, "The layout can't be changed while the frame is recorded.");
+	if (stages_count == p_stages_count && systems_count == p_systems_count) {
+		// Nothing changed, keep the history.
+		return;
+	}
+
+	stages_count = p_stages_count;
+	systems_count = p_systems_count;
+	allocate_slots();
+}
+
+uint64_t PipelineProfiler::get_frames_count() const {
+	return frames_count.get();
+}
+
+bool PipelineProfiler::get_frame(uint32_t p_frames_ago, FrameProfile &r_frame) const {
+	const uint64_t count = frames_count.get();
+	if (p_frames_ago >= count || p_frames_ago >= history_size) {
+		return false;
+	}
+
+	const uint64_t frame = count - 1 - p_frames_ago;
+	const uint32_t slot_index = frame % history_size;
+	const Slot &slot = slots[slot_index];
+
+	const uint64_t sequence = slot.sequence.get();
+	if (sequence & 1) {
+		// This slot is being overwritten.
+		return false;
+	}
+
+	r_frame.frame = slot.frame;
+	r_frame.time_usec = slot.time_usec;
+
+	// The slot memory never moves, so it's safe to copy it even if it's being
+	// overwritten: in that case the sequence changes, and the frame is
+	// discarded.
+	r_frame.stages_time_usec.resize(stages_count);
+	const uint64_t *stages = stages_time_usec + (slot_index * stages_count);
+	for (uint32_t i = 0; i < stages_count; i += 1) {
+		r_frame.stages_time_usec[i] = stages[i];
+	}
+	r_frame.systems.resize(systems_count);
+	const SystemProfile *slot_systems = systems + (slot_index * systems_count);
+	for (uint32_t i = 0; i < systems_count; i += 1) {
+		r_frame.systems[i] = slot_systems[i];
+	}
+
+	// Make sure the slot was not overwritten while it was copied.
+	return slot.sequence.get() == sequence && r_frame.frame == frame;
+}
+
+void PipelineProfiler::clear() {
+	ERR_FAIL_COND_MSG(writing != UINT32_MAX, "The profiler can't be cleared while the frame is recorded.");
+	frames_count.set(0);
+}
+
+void PipelineProfiler::begin_frame() {
+	const uint64_t frame = frames_count.get();
+	writing = frame % history_size;
+	Slot &slot = slots[writing];
+
+	// Odd: the readers will discard this slot until it's done.
+	slot.sequence.increment();
+
+	slot.frame = frame;
+	slot.time_usec = 0;
+	uint64_t *stages = stages_time_usec + (writing * stages_count);
+	for (uint32_t i = 0; i < stages_count; i += 1) {
+		stages[i] = 0;
+	}
+	SystemProfile *slot_systems = systems + (writing * systems_count);
+	for (uint32_t i = 0; i < systems_count; i += 1) {
+		slot_systems[i] = SystemProfile();
+	}
+
+	frame_begin_usec = OS::get_singleton()->get_ticks_usec();
+}
+
+bool PipelineProfiler::is_recording() const {
+	return writing != UINT32_MAX;
+}
+
+void PipelineProfiler::add_stage_time(uint32_t p_stage_index, uint64_t p_time_usec) {
+#ifdef DEBUG_ENABLED
+	CRASH_COND_MSG(writing == UINT32_MAX, "The frame is not being recorded.");
+#endif
+	ERR_FAIL_UNSIGNED_INDEX(p_stage_index, stages_count);
+	stages_time_usec[writing * stages_count + p_stage_index] += p_time_usec;
+}
+
+void PipelineProfiler::add_system_time(uint32_t p_system_index, uint64_t p_time_usec, uint64_t p_entities) {
+#ifdef DEBUG_ENABLED
+	CRASH_COND_MSG(writing == UINT32_MAX, "The frame is not being recorded.");
+#endif
+	ERR_FAIL_UNSIGNED_INDEX(p_system_index, systems_count);
+	SystemProfile &profile = systems[writing * systems_count + p_system_index];
+	profile.time_usec += p_time_usec;
+	profile.calls += 1;
+	profile.entities += p_entities;
+}
+
+void PipelineProfiler::end_frame() {
+#ifdef DEBUG_ENABLED
+	CRASH_COND_MSG(writing == UINT32_MAX, "The frame is not being recorded.");
+#endif
+	Slot &slot = slots[writing];
+	slot.time_usec = OS::get_singleton()->get_ticks_usec() - frame_begin_usec;
+
+	// Even: the slot is readable again.
+	slot.sequence.increment();
+	writing = UINT32_MAX;
+
+	// Publish the frame.
+	frames_count.increment();
+}
+
+uint64_t PipelineProfiler::get_entities_counter() {
+	return entities_counter;
+}
+
+void PipelineProfiler::allocate_slots() {
+	free_slots();
+	slots = memnew_arr(Slot, history_size);
+	if (stages_count > 0) {
+		stages_time_usec = memnew_arr(uint64_t, history_size * stages_count);
+	}
+	if (systems_count > 0) {
+		systems = memnew_arr(SystemProfile, history_size * systems_count);
+	}
+	frames_count.set(0);
+}
+
+void PipelineProfiler::free_slots() {
+	if (slots) {
+		memdelete_arr(slots);
+		slots = nullptr;
+	}
+	if (stages_time_usec) {
+		memdelete_arr(stages_time_usec);
+		stages_time_usec = nullptr;
+	}
+	if (systems) {
+		memdelete_arr(systems);
+		systems = nullptr;
+	}
+}
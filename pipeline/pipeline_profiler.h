@@ -0,0 +1,113 @@
+#pragma once
+
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+
+/// The stats of a `System` during a frame.
+struct SystemProfile {
+	uint64_t time_usec = 0;
+	/// How many times the `System` run: a `System` of a sub dispatcher may run
+	/// many times per frame.
+	uint32_t calls = 0;
+	/// The `Entities` fetched by the iteration of the `Query`s of the `System`.
+	uint64_t entities = 0;
+};
+
+/// The stats of a `Pipeline` dispatch.
+struct FrameProfile {
+	uint64_t frame = 0;
+	uint64_t time_usec = 0;
+	/// The time spent by each stage, indexed as returned by `Pipeline::get_stage_index`.
+	LocalVector<uint64_t> stages_time_usec;
+	/// Indexed by the `System` index within the `Pipeline`.
+	LocalVector<SystemProfile> systems;
+};
+
+/// Keeps the stats of the last `history_size` frames dispatched by a
+/// `Pipeline`, in a ring buffer.
+///
+/// The frame is written only by the dispatching thread (each `System` writes
+/// only its own slot), while it can be read from any thread without locks:
+/// each slot has a sequence number, odd while it's written, so the reader can
+/// detect and discard a frame overwritten while it was reading it.
+///
+/// The memory of all the slots is allocated by `set_history_size` and
+/// `set_layout`, and never moves while recording: a reader that races with the
+/// writer may copy stale values, that are discarded, but never reads freed
+/// memory.
+class PipelineProfiler {
+	struct Slot {
+		SafeNumeric<uint64_t> sequence;
+		uint64_t frame = 0;
+		uint64_t time_usec = 0;
+	};
+
+	Slot *slots = nullptr;
+	/// `history_size * stages_count` times, the stages of the slot `i` start
+	/// at `i * stages_count`.
+	uint64_t *stages_time_usec = nullptr;
+	/// `history_size * systems_count` profiles, the systems of the slot `i`
+	/// start at `i * systems_count`.
+	SystemProfile *systems = nullptr;
+	uint32_t history_size = 0;
+	uint32_t stages_count = 0;
+	uint32_t systems_count = 0;
+	/// The frames written so far, the last one is `frames_count - 1`.
+	SafeNumeric<uint64_t> frames_count;
+
+	/// The slot index being written, or `UINT32_MAX`.
+	uint32_t writing = UINT32_MAX;
+	uint64_t frame_begin_usec = 0;
+
+	/// The `Entities` counted by the `Query`s executed on this thread.
+	static thread_local uint64_t entities_counter;
+
+public:
+	static constexpr uint32_t DEFAULT_HISTORY_SIZE = 120;
+
+	PipelineProfiler();
+	~PipelineProfiler();
+
+	/// Changes the amount of frames kept, the current history is cleared.
+	/// Can't be called while the `Pipeline` is dispatching, nor while the
+	/// frames are read.
+	void set_history_size(uint32_t p_size);
+	uint32_t get_history_size() const;
+
+	/// Sets the amount of stages and `System`s recorded for each frame, the
+	/// current history is cleared. Set by the `PipelineBuilder`, with the same
+	/// constraints of `set_history_size`.
+	void set_layout(uint32_t p_stages_count, uint32_t p_systems_count);
+
+	/// Returns the total number of frames recorded so far.
+	uint64_t get_frames_count() const;
+
+	/// Copies the stats of the frame dispatched `p_frames_ago` frames ago, `0`
+	/// being the last one. Returns `false` if the frame is not in the history.
+	bool get_frame(uint32_t p_frames_ago, FrameProfile &r_frame) const;
+
+	void clear();
+
+	// ~~ Used by the `Pipeline` ~~
+
+	void begin_frame();
+	/// Returns `true` between `begin_frame` and `end_frame`.
+	bool is_recording() const;
+	void add_stage_time(uint32_t p_stage_index, uint64_t p_time_usec);
+	/// Can be called by many threads at the same time, for different `System`s.
+	void add_system_time(uint32_t p_system_index, uint64_t p_time_usec, uint64_t p_entities);
+	void end_frame();
+
+	/// Called by the `Query` once per process, with the amount of fetched
+	/// `Entities`, to count the `Entities` that the `System` running on this
+	/// thread iterates.
+	static _FORCE_INLINE_ void count_entities(uint32_t p_count) {
+		entities_counter += p_count;
+	}
+
+	static uint64_t get_entities_counter();
+
+private:
+	void allocate_slots();
+	void free_slots();
+};
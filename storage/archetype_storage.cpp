@@ -0,0 +1,184 @@
+#include "archetype_storage.h"
+
+bool Archetype::has_component(godex::component_id p_id) const {
+	for (uint32_t i = 0; i < components.size(); i += 1) {
+		if (components[i] == p_id) {
+			return true;
+		} else if (components[i] > p_id) {
+			// Sorted, so it's not here.
+			return false;
+		}
+	}
+	return false;
+}
+
+bool Archetype::has_components(const LocalVector<godex::component_id> &p_sorted_components) const {
+	uint32_t a = 0;
+	for (uint32_t i = 0; i < p_sorted_components.size(); i += 1) {
+		while (a < components.size() && components[a] < p_sorted_components[i]) {
+			a += 1;
+		}
+		if (a >= components.size() || components[a] != p_sorted_components[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+ArchetypeRegistry::ArchetypeRegistry() {
+	// The empty archetype.
+	archetypes.push_back(memnew(Archetype));
+}
+
+ArchetypeRegistry::~ArchetypeRegistry() {
+	detach_storages();
+	for (uint32_t i = 0; i < archetypes.size(); i += 1) {
+		memdelete(archetypes[i]);
+	}
+}
+
+void ArchetypeRegistry::add_storage(godex::component_id p_id, ArchetypeStorageBase *p_storage) {
+	if (p_id >= storages.size()) {
+		const uint32_t start = storages.size();
+		storages.resize(p_id + 1);
+		for (uint32_t i = start; i < storages.size(); i += 1) {
+			storages[i] = nullptr;
+		}
+	}
+	CRASH_COND_MSG(storages[p_id] != nullptr, "This component storage is already added to this `ArchetypeRegistry`.");
+	CRASH_COND_MSG(p_storage->registry != nullptr, "This storage is already added to another `ArchetypeRegistry`.");
+	storages[p_id] = p_storage;
+	p_storage->registry = this;
+}
+
+void ArchetypeRegistry::remove_storage(godex::component_id p_id) {
+	ERR_FAIL_COND(has_storage(p_id) == false);
+	storages[p_id]->registry = nullptr;
+	storages[p_id] = nullptr;
+}
+
+bool ArchetypeRegistry::has_storage(godex::component_id p_id) const {
+	return p_id < storages.size() && storages[p_id] != nullptr;
+}
+
+void ArchetypeRegistry::detach_storages() {
+	for (uint32_t i = 0; i < storages.size(); i += 1) {
+		if (storages[i]) {
+			storages[i]->on_registry_detached();
+			storages[i] = nullptr;
+		}
+	}
+	locations.reset();
+	for (uint32_t i = 0; i < archetypes.size(); i += 1) {
+		archetypes[i]->entities.reset();
+	}
+}
+
+ArchetypeRegistry::Location ArchetypeRegistry::add_component(EntityID p_entity, godex::component_id p_id) {
+	if (uint32_t(p_entity) >= locations.size()) {
+		locations.resize(uint32_t(p_entity) + 1);
+	}
+
+	Location from = locations[p_entity];
+	const uint32_t from_archetype = from.archetype == UINT32_MAX ? 0 : from.archetype;
+
+	// Find the destination archetype.
+	uint32_t to_archetype;
+	const uint32_t *edge = archetypes[from_archetype]->add_edges.lookup_ptr(p_id);
+	if (edge) {
+		to_archetype = *edge;
+	} else {
+		LocalVector<godex::component_id> components = archetypes[from_archetype]->components;
+		components.push_back(p_id);
+		components.sort();
+		to_archetype = find_or_create_archetype(components);
+		archetypes[from_archetype]->add_edges.insert(p_id, to_archetype);
+		archetypes[to_archetype]->remove_edges.insert(p_id, from_archetype);
+	}
+
+	move_entity(p_entity, from, to_archetype);
+	return locations[p_entity];
+}
+
+void ArchetypeRegistry::remove_component(EntityID p_entity, godex::component_id p_id) {
+	const Location from = get_location(p_entity);
+	ERR_FAIL_COND_MSG(from.archetype == UINT32_MAX, "The entity " + itos(p_entity) + " has no archetype.");
+
+	uint32_t to_archetype;
+	const uint32_t *edge = archetypes[from.archetype]->remove_edges.lookup_ptr(p_id);
+	if (edge) {
+		to_archetype = *edge;
+	} else {
+		LocalVector<godex::component_id> components = archetypes[from.archetype]->components;
+		const int64_t index = components.find(p_id);
+		ERR_FAIL_COND_MSG(index == -1, "The entity " + itos(p_entity) + " doesn't have the component " + itos(p_id) + ".");
+		// Keeps the order.
+		components.remove_at(index);
+		to_archetype = find_or_create_archetype(components);
+		archetypes[from.archetype]->remove_edges.insert(p_id, to_archetype);
+		archetypes[to_archetype]->add_edges.insert(p_id, from.archetype);
+	}
+
+	// Drop the removed component.
+	storages[p_id]->remove_row(from.archetype, from.row);
+	move_entity(p_entity, from, to_archetype);
+}
+
+uint32_t ArchetypeRegistry::get_archetypes_count() const {
+	return archetypes.size();
+}
+
+const Archetype *ArchetypeRegistry::get_archetype(uint32_t p_index) const {
+	ERR_FAIL_UNSIGNED_INDEX_V(p_index, archetypes.size(), nullptr);
+	return archetypes[p_index];
+}
+
+uint32_t ArchetypeRegistry::find_or_create_archetype(const LocalVector<godex::component_id> &p_components) {
+	for (uint32_t i = 0; i < archetypes.size(); i += 1) {
+		if (archetypes[i]->components.size() == p_components.size() &&
+				archetypes[i]->has_components(p_components)) {
+			return i;
+		}
+	}
+
+	Archetype *archetype = memnew(Archetype);
+	archetype->components = p_components;
+	archetypes.push_back(archetype);
+	return archetypes.size() - 1;
+}
+
+void ArchetypeRegistry::move_entity(EntityID p_entity, const Location &p_from, uint32_t p_to_archetype) {
+	Location to;
+
+	if (p_to_archetype != 0) {
+		// Move the components into the new archetype, the components are
+		// pushed at the end of each column.
+		Archetype *archetype = archetypes[p_to_archetype];
+		to.archetype = p_to_archetype;
+		to.row = archetype->entities.size();
+		archetype->entities.push_back(p_entity);
+
+		if (p_from.archetype != UINT32_MAX) {
+			for (uint32_t i = 0; i < archetype->components.size(); i += 1) {
+				const godex::component_id id = archetype->components[i];
+				if (archetypes[p_from.archetype]->has_component(id)) {
+					storages[id]->move_row(p_from.archetype, p_from.row, p_to_archetype);
+				}
+			}
+		}
+	}
+
+	if (p_from.archetype != UINT32_MAX) {
+		// Remove from the previous archetype; the last `Entity` takes its row,
+		// as the storages did with the components.
+		Archetype *archetype = archetypes[p_from.archetype];
+		const uint32_t last = archetype->entities.size() - 1;
+		if (p_from.row != last) {
+			const EntityID moved = archetype->entities[last];
+			locations[moved].row = p_from.row;
+		}
+		archetype->entities.remove_at_unordered(p_from.row);
+	}
+
+	locations[p_entity] = to;
+}
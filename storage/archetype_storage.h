@@ -0,0 +1,245 @@
+#pragma once
+
+#include "core/templates/oa_hash_map.h"
+#include "entity_list.h"
+#include "storage.h"
+
+class ArchetypeRegistry;
+
+/// An `Archetype` groups all the `Entities` that have the exact same set of
+/// components stored using an `ArchetypeStorage`.
+/// Each `ArchetypeStorage` stores, for each `Archetype`, a contiguous array of
+/// components (a column) where the component of the `Entity` at
+/// `entities[row]` is at `column[row]`.
+struct Archetype {
+	/// The components of this archetype, sorted.
+	LocalVector<godex::component_id> components;
+	/// The `Entities` of this archetype: the index is the row.
+	LocalVector<EntityID> entities;
+
+	/// Cache of the archetype reached by adding a component.
+	OAHashMap<godex::component_id, uint32_t> add_edges;
+	/// Cache of the archetype reached by removing a component.
+	OAHashMap<godex::component_id, uint32_t> remove_edges;
+
+	bool has_component(godex::component_id p_id) const;
+	/// Returns `true` if this archetype has all the passed components.
+	/// The passed components must be sorted.
+	bool has_components(const LocalVector<godex::component_id> &p_sorted_components) const;
+};
+
+/// Never override this directly. Always override the `ArchetypeStorage`.
+class ArchetypeStorageBase {
+	friend class ArchetypeRegistry;
+
+protected:
+	ArchetypeRegistry *registry = nullptr;
+
+public:
+	virtual ~ArchetypeStorageBase() {}
+
+	/// Moves the component at `p_from_row` of the archetype `p_from_archetype`
+	/// to the end of the archetype `p_to_archetype`.
+	virtual void move_row(uint32_t p_from_archetype, uint32_t p_from_row, uint32_t p_to_archetype) = 0;
+
+	/// Removes the component at `p_row`, the last component of the archetype
+	/// is moved in its place.
+	virtual void remove_row(uint32_t p_archetype, uint32_t p_row) = 0;
+
+protected:
+	/// Called when the `Registry` is destroyed before this storage.
+	virtual void on_registry_detached() = 0;
+};
+
+/// The `ArchetypeRegistry` is owned by the `World` and keeps track of the
+/// `Archetype` of each `Entity`. All the `ArchetypeStorage`s of a `World` share
+/// the same registry, so when a component is added or removed the `Entity` is
+/// moved to its new archetype, across all the storages.
+class ArchetypeRegistry {
+public:
+	struct Location {
+		uint32_t archetype = UINT32_MAX;
+		uint32_t row = UINT32_MAX;
+	};
+
+private:
+	/// The archetype `0` is the empty one, it never has `Entities`.
+	LocalVector<Archetype *> archetypes;
+	/// Sparse vector: `Entity` -> Location.
+	LocalVector<Location> locations;
+	/// Sparse vector: component id -> storage.
+	LocalVector<ArchetypeStorageBase *> storages;
+
+public:
+	ArchetypeRegistry();
+	~ArchetypeRegistry();
+
+	void add_storage(godex::component_id p_id, ArchetypeStorageBase *p_storage);
+	void remove_storage(godex::component_id p_id);
+	bool has_storage(godex::component_id p_id) const;
+
+	/// Detach all the storages, used by the `World` just before destroying the
+	/// storages, so they don't move the entities around.
+	void detach_storages();
+
+	/// Moves `p_entity` to the archetype that has also the component `p_id`,
+	/// and returns the new location: the storage of `p_id` must push the
+	/// component at the end of its column.
+	Location add_component(EntityID p_entity, godex::component_id p_id);
+
+	/// Moves `p_entity` to the archetype that doesn't have the component `p_id`.
+	/// The component `p_id` is removed from its storage by this function.
+	void remove_component(EntityID p_entity, godex::component_id p_id);
+
+	_FORCE_INLINE_ Location get_location(EntityID p_entity) const {
+		if (uint32_t(p_entity) < locations.size()) {
+			return locations[p_entity];
+		}
+		return Location();
+	}
+
+	uint32_t get_archetypes_count() const;
+	const Archetype *get_archetype(uint32_t p_index) const;
+
+private:
+	uint32_t find_or_create_archetype(const LocalVector<godex::component_id> &p_components);
+	/// Moves the `Entity` and the components it has in both the archetypes.
+	void move_entity(EntityID p_entity, const Location &p_from, uint32_t p_to_archetype);
+};
+
+/// The `ArchetypeStorage` stores the components in contiguous arrays grouped by
+/// `Archetype`. A `Query` that fetches only components stored in this way,
+/// iterates the matching archetypes directly: no per `Entity` membership check
+/// is needed.
+///
+/// Adding or removing a component moves all the `Entity` components to the new
+/// archetype, so this storage is a good choice for components that are not
+/// added or removed often.
+/// ```
+/// struct MyComponent {
+/// 	COMPONENT(MyComponent, ArchetypeStorage)
+/// };
+/// ```
+template <class T>
+class ArchetypeStorage : public Storage<T>, public ArchetypeStorageBase {
+	/// One column per archetype.
+	LocalVector<LocalVector<T>> columns;
+	/// `true` for the archetypes that have this component.
+	LocalVector<bool> columns_used;
+	/// Used to give to the `Query` the list of stored `Entities`.
+	EntityList stored_entities;
+
+public:
+	virtual ~ArchetypeStorage() {
+		if (registry) {
+			clear();
+			registry->remove_storage(T::get_component_id());
+		}
+	}
+
+	virtual String get_type_name() const override {
+		return "ArchetypeStorage[" + String(typeid(T).name()) + "]";
+	}
+
+	virtual void insert(EntityID p_entity, const T &p_data) override {
+		ERR_FAIL_COND_MSG(registry == nullptr, "This storage is not yet added to a `World`.");
+		if (has(p_entity)) {
+			const ArchetypeRegistry::Location l = registry->get_location(p_entity);
+			columns[l.archetype][l.row] = p_data;
+		} else {
+			const ArchetypeRegistry::Location l = registry->add_component(p_entity, T::get_component_id());
+			LocalVector<T> &column = get_column(l.archetype);
+#ifdef DEBUG_ENABLED
+			CRASH_COND_MSG(column.size() != l.row, "The archetype column is not aligned with the archetype entities. This is a bug, please report it.");
+#endif
+			column.push_back(p_data);
+			stored_entities.insert(p_entity);
+		}
+		StorageBase::notify_changed(p_entity);
+	}
+
+	virtual bool has(EntityID p_entity) const override {
+		if (unlikely(registry == nullptr)) {
+			return false;
+		}
+		const ArchetypeRegistry::Location l = registry->get_location(p_entity);
+		return l.archetype < columns_used.size() && columns_used[l.archetype];
+	}
+
+	virtual T *get(EntityID p_entity, Space p_mode = Space::LOCAL) override {
+		StorageBase::notify_changed(p_entity);
+		const ArchetypeRegistry::Location l = registry->get_location(p_entity);
+		return &columns[l.archetype][l.row];
+	}
+
+	virtual const T *get(EntityID p_entity, Space p_mode = Space::LOCAL) const override {
+		const ArchetypeRegistry::Location l = registry->get_location(p_entity);
+		return &columns[l.archetype][l.row];
+	}
+
+	virtual void remove(EntityID p_entity) override {
+		if (has(p_entity) == false) {
+			return;
+		}
+		registry->remove_component(p_entity, T::get_component_id());
+		stored_entities.remove(p_entity);
+		// Make sure to remove as changed.
+		StorageBase::notify_updated(p_entity);
+	}
+
+	virtual void clear() override {
+		while (stored_entities.is_empty() == false) {
+			remove(stored_entities.get_entities_ptr()[stored_entities.size() - 1]);
+		}
+		StorageBase::notify_cleared();
+		StorageBase::flush_changed();
+	}
+
+	virtual EntitiesBuffer get_stored_entities() const override {
+		return { stored_entities.size(), stored_entities.get_entities_ptr() };
+	}
+
+	/// Returns the components of the archetype, aligned with the archetype
+	/// `entities`.
+	const T *get_column_ptr(uint32_t p_archetype) const {
+		return p_archetype < columns.size() ? columns[p_archetype].ptr() : nullptr;
+	}
+
+	T *get_column_ptr(uint32_t p_archetype) {
+		return p_archetype < columns.size() ? columns[p_archetype].ptr() : nullptr;
+	}
+
+public:
+	// Override `ArchetypeStorageBase`.
+	virtual void move_row(uint32_t p_from_archetype, uint32_t p_from_row, uint32_t p_to_archetype) override {
+		LocalVector<T> &to = get_column(p_to_archetype);
+		to.push_back(columns[p_from_archetype][p_from_row]);
+		columns[p_from_archetype].remove_at_unordered(p_from_row);
+	}
+
+	virtual void remove_row(uint32_t p_archetype, uint32_t p_row) override {
+		columns[p_archetype].remove_at_unordered(p_row);
+	}
+
+protected:
+	virtual void on_registry_detached() override {
+		registry = nullptr;
+		columns.reset();
+		columns_used.reset();
+		stored_entities.reset();
+	}
+
+private:
+	LocalVector<T> &get_column(uint32_t p_archetype) {
+		if (unlikely(p_archetype >= columns.size())) {
+			columns.resize(p_archetype + 1);
+			const uint32_t start = columns_used.size();
+			columns_used.resize(p_archetype + 1);
+			for (uint32_t i = start; i < columns_used.size(); i += 1) {
+				columns_used[i] = false;
+			}
+		}
+		columns_used[p_archetype] = true;
+		return columns[p_archetype];
+	}
+};
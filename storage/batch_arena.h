@@ -0,0 +1,141 @@
+#pragma once
+
+#include "core/os/memory.h"
+#include "core/string/ustring.h"
+#include "core/templates/local_vector.h"
+#include <type_traits>
+
+/// Paged memory shared by all the batches of a `BatchStorage`: the batches are
+/// carved next to each other from big pages, instead of being a heap
+/// allocation each.
+///
+/// The memory is handed out in blocks of power of two sizes (the size class).
+/// A released block goes into the free list of its size class, and it's
+/// reused by the next batch of the same class. The pages are never moved, so a
+/// block pointer is valid until the block is released or the arena `reset`.
+template <class T>
+class BatchArena {
+	static_assert(std::is_trivially_copyable<T>::value, "The `BatchArena` can store only trivially copyable types.");
+
+public:
+	static constexpr uint32_t PAGE_SHIFT = 10;
+	static constexpr uint32_t PAGE_SIZE = 1 << PAGE_SHIFT;
+	static constexpr uint32_t SIZE_CLASSES = 32;
+
+	struct Block {
+		uint32_t page = 0;
+		uint32_t offset = 0;
+	};
+
+private:
+	struct Page {
+		T *data = nullptr;
+		uint32_t capacity = 0;
+	};
+
+	LocalVector<Page> pages;
+	/// The page where the new blocks are carved, and how much of it is used.
+	uint32_t current_page = 0;
+	uint32_t current_used = 0;
+	/// Size class -> the released blocks.
+	LocalVector<Block> free_blocks[SIZE_CLASSES];
+
+public:
+	BatchArena() = default;
+	BatchArena(const BatchArena &) = delete;
+	BatchArena &operator=(const BatchArena &) = delete;
+
+	~BatchArena() {
+		for (uint32_t i = 0; i < pages.size(); i += 1) {
+			memfree(pages[i].data);
+		}
+	}
+
+	/// Returns the smallest size class that fits `p_size` elements.
+	static uint32_t get_size_class(uint32_t p_size) {
+		uint32_t size_class = 0;
+		while ((uint32_t(1) << size_class) < p_size) {
+			size_class += 1;
+		}
+		return size_class;
+	}
+
+	/// Returns a block of `1 << p_size_class` elements, not initialized.
+	Block allocate(uint32_t p_size_class) {
+		CRASH_COND_MSG(p_size_class >= SIZE_CLASSES, "The size class " + itos(p_size_class) + " is too big.");
+
+		LocalVector<Block> &free_list = free_blocks[p_size_class];
+		if (free_list.size() > 0) {
+			const Block block = free_list[free_list.size() - 1];
+			free_list.resize(free_list.size() - 1);
+			return block;
+		}
+
+		const uint32_t size = uint32_t(1) << p_size_class;
+		while (current_page < pages.size() && current_used + size > pages[current_page].capacity) {
+			// This page is full, its tail still fits smaller blocks.
+			release_tail();
+			current_page += 1;
+			current_used = 0;
+		}
+
+		if (current_page == pages.size()) {
+			Page page;
+			page.capacity = MAX(PAGE_SIZE, size);
+			page.data = static_cast<T *>(memalloc(sizeof(T) * page.capacity));
+			pages.push_back(page);
+		}
+
+		Block block;
+		block.page = current_page;
+		block.offset = current_used;
+		current_used += size;
+		return block;
+	}
+
+	/// The block can be reused by the next `allocate` of the same size class.
+	void release(Block p_block, uint32_t p_size_class) {
+		free_blocks[p_size_class].push_back(p_block);
+	}
+
+	T *get(Block p_block) {
+		return pages[p_block.page].data + p_block.offset;
+	}
+
+	const T *get(Block p_block) const {
+		return pages[p_block.page].data + p_block.offset;
+	}
+
+	/// Releases all the blocks at once, in O(1): the pages are kept, and the
+	/// next blocks are carved from the first page again.
+	void reset() {
+		current_page = 0;
+		current_used = 0;
+		for (uint32_t i = 0; i < SIZE_CLASSES; i += 1) {
+			free_blocks[i].clear();
+		}
+	}
+
+private:
+	/// Splits the unused part of the current page in blocks, and releases them.
+	void release_tail() {
+		uint32_t offset = current_used;
+		uint32_t remaining = pages[current_page].capacity - current_used;
+		while (remaining > 0) {
+			// The biggest size class that fits.
+			uint32_t size_class = 0;
+			while ((uint32_t(1) << (size_class + 1)) <= remaining) {
+				size_class += 1;
+			}
+
+			Block block;
+			block.page = current_page;
+			block.offset = offset;
+			free_blocks[size_class].push_back(block);
+
+			offset += uint32_t(1) << size_class;
+			remaining -= uint32_t(1) << size_class;
+		}
+		current_used = pages[current_page].capacity;
+	}
+};
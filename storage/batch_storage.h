@@ -1,13 +1,76 @@
 #pragma once
 
 #include "../ecs.h"
+#include "batch_arena.h"
 #include "static_vector.h"
 #include "storage.h"
+#include <type_traits>
+
+/// Writes all the batches into the `World` snapshot, with all their components.
+template <class T>
+void batch_save_snapshot(const Storage<T> &p_storage, SnapshotWriter &p_writer, uint32_t p_component_id) {
+	const EntitiesBuffer entities = p_storage.get_stored_entities();
+
+	p_writer.write_u32(SNAPSHOT_FORMAT_BATCH);
+	p_writer.write_u32(entities.count);
+
+	List<PropertyInfo> properties;
+	for (uint32_t i = 0; i < entities.count; i += 1) {
+		const uint32_t size = p_storage.get_batch_size(entities.entities[i]);
+		const T *batch = p_storage.get(entities.entities[i]);
+
+		p_writer.write_u32(entities.entities[i].get_raw_id());
+		p_writer.write_u32(size);
+		for (uint32_t b = 0; b < size; b += 1) {
+			properties.clear();
+			ECS::unsafe_component_get_property_list(p_component_id, const_cast<T *>(batch + b), &properties);
+
+			Dictionary data;
+			for (const PropertyInfo &property : properties) {
+				data[property.name] = ECS::unsafe_component_get_by_name(p_component_id, batch + b, property.name);
+			}
+			p_writer.write_variant(data);
+		}
+	}
+}
+
+/// Inserts the batches stored by `batch_save_snapshot`. Returns `false` if the
+/// data is malformed.
+template <class T>
+bool batch_load_snapshot(Storage<T> &p_storage, SnapshotReader &p_reader) {
+	uint32_t format;
+	uint32_t count;
+	ERR_FAIL_COND_V(p_reader.read_u32(format) == false || format != SNAPSHOT_FORMAT_BATCH, false);
+	ERR_FAIL_COND_V(p_reader.read_u32(count) == false, false);
+
+	for (uint32_t i = 0; i < count; i += 1) {
+		uint32_t entity;
+		uint32_t size;
+		ERR_FAIL_COND_V(p_reader.read_u32(entity) == false, false);
+		ERR_FAIL_COND_V(p_reader.read_u32(size) == false, false);
+		for (uint32_t b = 0; b < size; b += 1) {
+			Variant data;
+			ERR_FAIL_COND_V(p_reader.read_variant(data) == false || data.get_type() != Variant::DICTIONARY, false);
+			// Each insert appends the component to the batch.
+			p_storage.insert_dynamic(entity, data);
+		}
+	}
+	return true;
+}
 
 /// Optimized version that allow to store a max size of components consecutivelly,
 /// the size must be known at compile time.
-template <template <class> class STORAGE, int SIZE, class T>
+///
+/// When the size is `-1` the batches can grow on the fly: by default each
+/// batch is stored into its own vector, while with `ARENA` the batches are
+/// stored into a shared `BatchArena` (see `COMPONENT_BATCH_ARENA`).
+///
+/// `ARENA` is explicit, rather than deduced from `T`, because the storage type
+/// is named inside the component body, where `T` is still incomplete.
+template <template <class> class STORAGE, int SIZE, class T, bool ARENA = false>
 class BatchStorage : public Storage<T> {
+	static_assert(ARENA == false, "The `BatchArena` can be used only by the dynamic sized batches.");
+
 protected:
 	STORAGE<StaticVector<T, SIZE>> storage;
 
@@ -49,6 +112,20 @@ public:
 		return storage.get(p_entity).size();
 	}
 
+	virtual void insert_from_prototype(EntityID p_prototype, const EntityID *p_entities, uint32_t p_count) override {
+		ERR_FAIL_COND_MSG(storage.has(p_prototype) == false, "The prototype Entity " + itos(p_prototype) + " doesn't have this component.");
+		// Copy the batch, so it stays valid even if the storage memory moves.
+		const StaticVector<T, SIZE> batch = storage.get(p_prototype);
+		for (uint32_t i = 0; i < p_count; i += 1) {
+			if (storage.has(p_entities[i])) {
+				storage.get(p_entities[i]) = batch;
+			} else {
+				storage.insert(p_entities[i], batch);
+			}
+		}
+		StorageBase::notify_changed_batch(p_entities, p_count);
+	}
+
 	virtual void remove(EntityID p_entity) override {
 		storage.remove(p_entity);
 		// Make sure to remove as changed.
@@ -57,18 +134,34 @@ public:
 
 	virtual void clear() override {
 		storage.clear();
+		StorageBase::notify_cleared();
 		StorageBase::flush_changed();
 	}
 
 	virtual EntitiesBuffer get_stored_entities() const {
 		return { storage.get_entities().size(), storage.get_entities().ptr() };
 	}
+
+	virtual void save_snapshot(SnapshotWriter &p_writer, uint32_t p_component_id) const override {
+		batch_save_snapshot<T>(*this, p_writer, p_component_id);
+	}
+
+	virtual bool load_snapshot(SnapshotReader &p_reader, uint32_t p_component_id) override {
+		return batch_load_snapshot<T>(*this, p_reader);
+	}
+
+	/// The batch snapshot keeps all the components of each batch, so the
+	/// default `fork` restores the whole state.
+	virtual bool is_forkable() const override {
+		return true;
+	}
 };
 
 /// The size can be chosen on the fly, but the components are stored in a
-/// de-localized memory, which may invalidate cache coherency.
+/// de-localized memory, which may invalidate cache coherency. The trivially
+/// copyable components can use `COMPONENT_BATCH_ARENA` instead.
 template <template <class> class STORAGE, class T>
-class BatchStorage<STORAGE, -1, T> : public Storage<T> {
+class BatchStorage<STORAGE, -1, T, false> : public Storage<T> {
 protected:
 	STORAGE<LocalVector<T>> storage;
 
@@ -108,6 +201,20 @@ public:
 		return storage.get(p_entity).size();
 	}
 
+	virtual void insert_from_prototype(EntityID p_prototype, const EntityID *p_entities, uint32_t p_count) override {
+		ERR_FAIL_COND_MSG(storage.has(p_prototype) == false, "The prototype Entity " + itos(p_prototype) + " doesn't have this component.");
+		// Copy the batch, so it stays valid even if the storage memory moves.
+		const LocalVector<T> batch = storage.get(p_prototype);
+		for (uint32_t i = 0; i < p_count; i += 1) {
+			if (storage.has(p_entities[i])) {
+				storage.get(p_entities[i]) = batch;
+			} else {
+				storage.insert(p_entities[i], batch);
+			}
+		}
+		StorageBase::notify_changed_batch(p_entities, p_count);
+	}
+
 	virtual void remove(EntityID p_entity) override {
 		storage.remove(p_entity);
 		// Make sure to remove as changed.
@@ -116,10 +223,169 @@ public:
 
 	virtual void clear() override {
 		storage.clear();
+		StorageBase::notify_cleared();
 		StorageBase::flush_changed();
 	}
 
 	virtual EntitiesBuffer get_stored_entities() const {
 		return { storage.get_entities().size(), storage.get_entities().ptr() };
 	}
+
+	virtual void save_snapshot(SnapshotWriter &p_writer, uint32_t p_component_id) const override {
+		batch_save_snapshot<T>(*this, p_writer, p_component_id);
+	}
+
+	virtual bool load_snapshot(SnapshotReader &p_reader, uint32_t p_component_id) override {
+		return batch_load_snapshot<T>(*this, p_reader);
+	}
+
+	virtual bool is_forkable() const override {
+		return true;
+	}
+};
+
+/// The size can be chosen on the fly, and the batches are stored into a shared
+/// `BatchArena`: the small batches are stored inline, so most of the `Entities`
+/// never touch the arena. `clear` releases all the batches in O(1), so the
+/// batches written and cleared each frame (like the forces) never allocate,
+/// once the arena is warm.
+template <template <class> class STORAGE, class T>
+class BatchStorage<STORAGE, -1, T, true> : public Storage<T> {
+	/// The batches up to this size are stored inline, into the slot.
+	static constexpr uint32_t INLINE_SIZE = sizeof(T) >= 32 ? 1 : 32 / sizeof(T);
+	/// The `size_class` of the batches stored inline.
+	static constexpr uint32_t INLINE = UINT32_MAX;
+
+	struct Slot {
+		uint32_t size = 0;
+		uint32_t size_class = INLINE;
+		typename BatchArena<T>::Block block;
+		alignas(T) uint8_t inline_data[sizeof(T) * INLINE_SIZE];
+	};
+
+protected:
+	STORAGE<Slot> storage;
+	BatchArena<T> arena;
+
+public:
+	virtual String get_type_name() const override {
+		return "DynamicSizedBatchStorage<" + String(typeid(T).name()) + ">";
+	}
+
+	virtual void insert(EntityID p_entity, const T &p_data) override {
+		if (storage.has(p_entity)) {
+			Slot &slot = storage.get(p_entity);
+			if (slot.size == get_capacity(slot)) {
+				grow(slot, slot.size + 1);
+			}
+			memnew_placement(get_batch(slot) + slot.size, T(p_data));
+			slot.size += 1;
+		} else {
+			Slot slot;
+			slot.size = 1;
+			memnew_placement(get_batch(slot), T(p_data));
+			storage.insert(p_entity, slot);
+		}
+		StorageBase::notify_changed(p_entity);
+	}
+
+	virtual bool has(EntityID p_entity) const override {
+		return storage.has(p_entity);
+	}
+
+	virtual T *get(EntityID p_entity, Space p_mode = Space::LOCAL) override {
+		StorageBase::notify_changed(p_entity);
+		return get_batch(storage.get(p_entity));
+	}
+
+	virtual const T *get(EntityID p_entity, Space p_mode = Space::LOCAL) const override {
+		return get_batch(storage.get(p_entity));
+	}
+
+	virtual uint32_t get_batch_size(EntityID p_entity) const override {
+		return storage.get(p_entity).size;
+	}
+
+	virtual void insert_from_prototype(EntityID p_prototype, const EntityID *p_entities, uint32_t p_count) override {
+		ERR_FAIL_COND_MSG(storage.has(p_prototype) == false, "The prototype Entity " + itos(p_prototype) + " doesn't have this component.");
+		// Copy the batch, so it stays valid even if the storage memory moves.
+		const Slot &prototype = storage.get(p_prototype);
+		LocalVector<T> batch;
+		batch.resize(prototype.size);
+		memcpy(batch.ptr(), get_batch(prototype), sizeof(T) * prototype.size);
+
+		for (uint32_t i = 0; i < p_count; i += 1) {
+			if (storage.has(p_entities[i]) == false) {
+				storage.insert(p_entities[i], Slot());
+			}
+			Slot &slot = storage.get(p_entities[i]);
+			slot.size = 0;
+			if (batch.size() > get_capacity(slot)) {
+				grow(slot, batch.size());
+			}
+			memcpy(get_batch(slot), batch.ptr(), sizeof(T) * batch.size());
+			slot.size = batch.size();
+		}
+		StorageBase::notify_changed_batch(p_entities, p_count);
+	}
+
+	virtual void remove(EntityID p_entity) override {
+		if (storage.has(p_entity)) {
+			const Slot &slot = storage.get(p_entity);
+			if (slot.size_class != INLINE) {
+				arena.release(slot.block, slot.size_class);
+			}
+		}
+		storage.remove(p_entity);
+		// Make sure to remove as changed.
+		StorageBase::notify_updated(p_entity);
+	}
+
+	virtual void clear() override {
+		storage.clear();
+		arena.reset();
+		StorageBase::notify_cleared();
+		StorageBase::flush_changed();
+	}
+
+	virtual EntitiesBuffer get_stored_entities() const {
+		return { storage.get_entities().size(), storage.get_entities().ptr() };
+	}
+
+	virtual void save_snapshot(SnapshotWriter &p_writer, uint32_t p_component_id) const override {
+		batch_save_snapshot<T>(*this, p_writer, p_component_id);
+	}
+
+	virtual bool load_snapshot(SnapshotReader &p_reader, uint32_t p_component_id) override {
+		return batch_load_snapshot<T>(*this, p_reader);
+	}
+
+	virtual bool is_forkable() const override {
+		return true;
+	}
+
+private:
+	uint32_t get_capacity(const Slot &p_slot) const {
+		return p_slot.size_class == INLINE ? INLINE_SIZE : (uint32_t(1) << p_slot.size_class);
+	}
+
+	T *get_batch(Slot &p_slot) {
+		return p_slot.size_class == INLINE ? reinterpret_cast<T *>(p_slot.inline_data) : arena.get(p_slot.block);
+	}
+
+	const T *get_batch(const Slot &p_slot) const {
+		return p_slot.size_class == INLINE ? reinterpret_cast<const T *>(p_slot.inline_data) : arena.get(p_slot.block);
+	}
+
+	/// Moves the batch into an arena block that fits `p_size` elements.
+	void grow(Slot &p_slot, uint32_t p_size) {
+		const uint32_t size_class = BatchArena<T>::get_size_class(p_size);
+		const typename BatchArena<T>::Block block = arena.allocate(size_class);
+		memcpy(arena.get(block), get_batch(p_slot), sizeof(T) * p_slot.size);
+		if (p_slot.size_class != INLINE) {
+			arena.release(p_slot.block, p_slot.size_class);
+		}
+		p_slot.size_class = size_class;
+		p_slot.block = block;
+	}
 };
@@ -0,0 +1,67 @@
+#include "change_ticks.h"
+
+ChangeTicks::ChangeTicks() :
+		tick(1) {}
+
+ChangeTicks::~ChangeTicks() {
+	reset();
+}
+
+ChangeTick ChangeTicks::advance() {
+	return tick.postincrement();
+}
+
+void ChangeTicks::flush() {
+	flushed_tick = advance();
+	dirty_pages.clear();
+}
+
+ChangeTick ChangeTicks::get_flushed_tick() const {
+	return flushed_tick;
+}
+
+void ChangeTicks::collect_changed(ChangeTick p_from, ChangeTick p_to, LocalVector<EntityID> &r_entities) const {
+#ifdef DEBUG_ENABLED
+	CRASH_COND_MSG(p_from < flushed_tick, "The changes before the last flush are not tracked anymore.");
+#endif
+	// Many readers can collect at the same time, so the pages to visit are
+	// sorted into a local copy. A page is dirty at most once, so no duplicates.
+	LocalVector<uint32_t> changed_pages;
+	for (uint32_t d = 0; d < dirty_pages.size(); d += 1) {
+		if (pages[dirty_pages[d]]->tick > p_from) {
+			changed_pages.push_back(dirty_pages[d]);
+		}
+	}
+	changed_pages.sort();
+
+	for (uint32_t d = 0; d < changed_pages.size(); d += 1) {
+		const Page *page = pages[changed_pages[d]];
+		const uint32_t begin = changed_pages[d] << PAGE_SHIFT;
+		for (uint32_t i = 0; i < PAGE_SIZE; i += 1) {
+			if (page->entity_ticks[i] > p_from && page->entity_ticks[i] <= p_to) {
+				r_entities.push_back(EntityID(begin + i, page->entity_generations[i]));
+			}
+		}
+	}
+}
+
+void ChangeTicks::reset() {
+	for (uint32_t i = 0; i < pages.size(); i += 1) {
+		if (pages[i] != nullptr) {
+			memdelete(pages[i]);
+		}
+	}
+	pages.reset();
+	dirty_pages.reset();
+}
+
+void ChangeTicks::allocate_page(uint32_t p_page) {
+	if (p_page >= pages.size()) {
+		const uint32_t initial_size = pages.size();
+		pages.resize(p_page + 1);
+		for (uint32_t i = initial_size; i < pages.size(); i += 1) {
+			pages[i] = nullptr;
+		}
+	}
+	pages[p_page] = memnew(Page);
+}
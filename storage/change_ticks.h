@@ -0,0 +1,106 @@
+#pragma once
+
+#include "../ecs_types.h"
+#include "core/templates/safe_refcount.h"
+
+typedef uint64_t ChangeTick;
+
+/// Keeps track of when each `Entity` changed, using a monotonic tick.
+///
+/// Marking an `Entity` as changed is just a store of the current tick: it
+/// allocates only the first time an `Entity` of a page changes.
+/// The `Entities` are grouped in pages of `PAGE_SIZE`, allocated on demand like
+/// the `PagedSparseIndex` pages, so a storage that changes few `Entities` with a
+/// high index doesn't pay a slot for each lower index. Each page stores the
+/// tick of its last change. The pages changed since the last `flush` are listed
+/// in `dirty_pages`, so collecting the changes never visits the other pages.
+///
+/// A reader (like the `Changed` filter) takes a tick using `advance`, and next
+/// time it considers as changed all the `Entities` with a greater tick.
+class ChangeTicks {
+public:
+	static constexpr uint32_t PAGE_SHIFT = 6;
+	static constexpr uint32_t PAGE_SIZE = 1 << PAGE_SHIFT;
+	static constexpr uint32_t PAGE_MASK = PAGE_SIZE - 1;
+
+private:
+	struct Page {
+		/// The tick of the last change of any `Entity` of the page.
+		ChangeTick tick = 0;
+		/// `Entity` -> tick of its last change; `0` is never changed.
+		ChangeTick entity_ticks[PAGE_SIZE] = {};
+		/// `Entity` -> generation, to give back the full `EntityID`.
+		uint8_t entity_generations[PAGE_SIZE] = {};
+	};
+
+	/// The tick assigned to the changes notified from now on.
+	/// It's atomic because many readers can `advance` it at the same time.
+	SafeNumeric<ChangeTick> tick;
+	/// The changes with a tick lower or equal to this are discarded.
+	ChangeTick flushed_tick = 0;
+
+	/// Page -> the ticks of its `Entities`; `nullptr` when none ever changed.
+	LocalVector<Page *> pages;
+	/// The pages changed since the last `flush`, in the order they changed:
+	/// `collect_changed` sorts them.
+	LocalVector<uint32_t> dirty_pages;
+
+public:
+	ChangeTicks();
+	ChangeTicks(const ChangeTicks &) = delete;
+	ChangeTicks &operator=(const ChangeTicks &) = delete;
+	~ChangeTicks();
+
+	_FORCE_INLINE_ void mark_changed(EntityID p_entity) {
+		const uint32_t page_index = uint32_t(p_entity) >> PAGE_SHIFT;
+		if (unlikely(page_index >= pages.size() || pages[page_index] == nullptr)) {
+			allocate_page(page_index);
+		}
+		Page *page = pages[page_index];
+		const ChangeTick t = tick.get();
+		const uint32_t index = uint32_t(p_entity) & PAGE_MASK;
+		page->entity_ticks[index] = t;
+		page->entity_generations[index] = p_entity.get_generation();
+		if (page->tick <= flushed_tick) {
+			// First change of this page since the last `flush`.
+			dirty_pages.push_back(page_index);
+		}
+		page->tick = t;
+	}
+
+	/// The `Entity` is no more changed.
+	_FORCE_INLINE_ void mark_updated(EntityID p_entity) {
+		const uint32_t page_index = uint32_t(p_entity) >> PAGE_SHIFT;
+		if (page_index < pages.size() && pages[page_index] != nullptr) {
+			pages[page_index]->entity_ticks[uint32_t(p_entity) & PAGE_MASK] = 0;
+		}
+	}
+
+	_FORCE_INLINE_ ChangeTick get_tick(EntityID p_entity) const {
+		const uint32_t page_index = uint32_t(p_entity) >> PAGE_SHIFT;
+		if (page_index < pages.size() && pages[page_index] != nullptr) {
+			return pages[page_index]->entity_ticks[uint32_t(p_entity) & PAGE_MASK];
+		}
+		return 0;
+	}
+
+	/// Returns a tick that is greater or equal to the tick of any change notified
+	/// so far, and lower than the tick of any change notified from now on.
+	/// Safe to call from many threads at the same time.
+	ChangeTick advance();
+
+	/// Discards all the changes notified so far.
+	void flush();
+	ChangeTick get_flushed_tick() const;
+
+	/// Fetches the `Entities` changed in the range (`p_from`, `p_to`], in order.
+	/// Only the dirty pages changed after `p_from` are visited; `p_from` can't be
+	/// lower than `get_flushed_tick`.
+	void collect_changed(ChangeTick p_from, ChangeTick p_to, LocalVector<EntityID> &r_entities) const;
+
+	/// Release the memory completely.
+	void reset();
+
+private:
+	void allocate_page(uint32_t p_page);
+};
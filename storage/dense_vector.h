@@ -1,20 +1,60 @@
 #pragma once
 
 #include "../ecs.h"
+#include "core/os/mutex.h"
 #include "core/templates/local_vector.h"
+#include "paged_sparse_index.h"
 #include "storage.h"
+#include <atomic>
 
+/// The `DenseVector` can be forked, see `fork`: the data is saved in pages,
+/// and a page is copied only when it's written after the fork.
 template <class T>
 class DenseVector {
+public:
+	static constexpr uint32_t FORK_PAGE_SHIFT = 8;
+	static constexpr uint32_t FORK_PAGE_SIZE = 1 << FORK_PAGE_SHIFT;
+
 protected:
 	LocalVector<T> data;
 	LocalVector<EntityID> data_to_entity;
-	// Each position of this vector is an Entity Index.
-	LocalVector<uint32_t> entity_to_data;
+	// Each position of this index is an Entity Index.
+	PagedSparseIndex entity_to_data;
+
+	/// The pages written between this fork and the next one, as they were
+	/// when the fork was taken.
+	struct Fork {
+		/// The data size when the fork was taken.
+		uint32_t size = 0;
+		/// The saved pages, the elements of each page are appended in order
+		/// to `data` and `entities`.
+		LocalVector<uint32_t> pages;
+		LocalVector<T> data;
+		LocalVector<EntityID> entities;
+	};
+
+	/// The oldest fork first.
+	LocalVector<Fork> forks;
+	/// Page -> the `fork_epoch` when the page was last saved. It's atomic
+	/// because the mutable `get` can be called by many threads at once.
+	std::atomic<uint32_t> *pages_fork_epoch = nullptr;
+	uint32_t pages_fork_epoch_size = 0;
+	/// Changes each time a fork is taken or restored.
+	uint32_t fork_epoch = 0;
+	/// Guards the save of the pages.
+	Mutex fork_mutex;
 
 public:
+	~DenseVector() {
+		if (pages_fork_epoch != nullptr) {
+			memdelete_arr(pages_fork_epoch);
+		}
+	}
+
 	void insert(EntityID p_entity, const T &p_data) {
 		const uint32_t index = data.size();
+		// The slot may be part of a fork, if the data shrank after it.
+		fork_save(index);
 		insert_entity(p_entity, index);
 
 		// Store the data
@@ -23,60 +63,105 @@ public:
 	}
 
 	bool has(EntityID p_entity) const {
-		return p_entity < entity_to_data.size() && entity_to_data[p_entity] != UINT32_MAX;
+		return entity_to_data.has(p_entity);
 	}
 
 	const T &get(EntityID p_entity) const {
 #ifdef DEBUG_ENABLED
 		CRASH_COND_MSG(has(p_entity) == false, "This entity doesn't have anything stored into this storage.");
 #endif
-		return data[entity_to_data[p_entity]];
+		return data[entity_to_data.get(p_entity)];
 	}
 
 	T &get(EntityID p_entity) {
 #ifdef DEBUG_ENABLED
 		CRASH_COND_MSG(has(p_entity) == false, "This entity doesn't have anything stored into this storage.");
 #endif
-		return data[entity_to_data[p_entity]];
+		const uint32_t index = entity_to_data.get(p_entity);
+		fork_save(index);
+		return data[index];
 	}
 
 	void remove(EntityID p_entity) {
 		ERR_FAIL_COND_MSG(has(p_entity) == false, "This entity doesn't have anything stored into this storage.");
 
 		const uint32_t last = data.size() - 1;
+		const uint32_t index = entity_to_data.get(p_entity);
+		fork_save(index);
+		fork_save(last);
 
-		if (entity_to_data[p_entity] != last) {
+		if (index != last) {
 			// This entity is the last one, so swap the alst with the current one
 			// to remove.
 
 			// Copy the last array element on the data element to remove.
-			data[entity_to_data[p_entity]] = data[last];
+			data[index] = data[last];
 
 			// Make sure the entity for the last array element, points to the right slot.
-			entity_to_data[data_to_entity[last]] = entity_to_data[p_entity];
+			entity_to_data.update(data_to_entity[last], index);
 
 			// Now updated the data to entity by simply coping what's in the last.
-			data_to_entity[entity_to_data[p_entity]] = data_to_entity[last];
+			data_to_entity[index] = data_to_entity[last];
 		}
 
 		data.remove_at(last);
 		data_to_entity.remove_at(last);
-		entity_to_data[p_entity] = UINT32_MAX;
+		entity_to_data.erase(p_entity);
+	}
+
+	/// Reserves the memory to insert `p_count` more elements.
+	void reserve(uint32_t p_count) {
+		data.reserve(data.size() + p_count);
+		data_to_entity.reserve(data_to_entity.size() + p_count);
 	}
 
 	const LocalVector<EntityID> &get_entities() const {
 		return data_to_entity;
 	}
 
-	/// Clear the storage.
+	const LocalVector<T> &get_data() const {
+		return data;
+	}
+
+	/// Replaces the stored data with a copy of the passed arrays, copied with
+	/// a single `memcpy` each: `T` must be trivially copyable.
+	/// Returns `false`, and leaves the storage empty, if an `Entity` is repeated.
+	bool adopt(const EntityID *p_entities, const T *p_data, uint32_t p_count) {
+		static_assert(std::is_trivially_copyable<T>::value, "`adopt` can be used only by trivially copyable types.");
+		clear();
+		data.resize(p_count);
+		data_to_entity.resize(p_count);
+		if (p_count > 0) {
+			memcpy(data.ptr(), p_data, sizeof(T) * p_count);
+			memcpy(data_to_entity.ptr(), p_entities, sizeof(EntityID) * p_count);
+		}
+		entity_to_data.reserve(p_count == 0 ? 0 : p_entities[p_count - 1].get_index() + 1);
+		for (uint32_t i = 0; i < p_count; i += 1) {
+			if (unlikely(entity_to_data.has(data_to_entity[i]))) {
+				// Drop the `Entities` inserted so far.
+				data_to_entity.resize(i);
+				clear();
+				ERR_FAIL_V_MSG(false, "The Entity " + itos(p_entities[i].get_index()) + " is repeated.");
+			}
+			insert_entity(data_to_entity[i], i);
+		}
+		return true;
+	}
+
+	/// Clear the storage, keeping the memory so it's not reallocated when the
+	/// storage is filled again.
 	void clear() {
+		fork_save_all();
+		for (uint32_t i = 0; i < data_to_entity.size(); i += 1) {
+			entity_to_data.erase(data_to_entity[i], false);
+		}
 		data.clear();
 		data_to_entity.clear();
-		entity_to_data.clear();
 	}
 
 	/// Reset the storage unallocating the memory.
 	void reset() {
+		fork_save_all();
 		data.reset();
 		data_to_entity.reset();
 		entity_to_data.reset();
@@ -91,25 +176,151 @@ public:
 		data.reserve(p_reserve);
 		data_to_entity.reserve(p_reserve);
 		entity_to_data.reserve(p_reserve);
+	}
+
+	/// Takes a new fork: from now on, each page of data is copied the first
+	/// time it's written, so `restore_fork` can bring back the current state.
+	/// The data that is never written after the fork is never copied.
+	void fork() {
+		const uint32_t pages_count = (data.size() + FORK_PAGE_SIZE - 1) >> FORK_PAGE_SHIFT;
+		if (pages_count > pages_fork_epoch_size) {
+			// The old stamps are all outdated, so no need to copy them.
+			if (pages_fork_epoch != nullptr) {
+				memdelete_arr(pages_fork_epoch);
+			}
+			pages_fork_epoch_size = MAX(pages_count, pages_fork_epoch_size * 2);
+			pages_fork_epoch = memnew_arr(std::atomic<uint32_t>, pages_fork_epoch_size);
+			for (uint32_t i = 0; i < pages_fork_epoch_size; i += 1) {
+				pages_fork_epoch[i].store(0, std::memory_order_relaxed);
+			}
+		}
+
+		fork_epoch += 1;
+		forks.resize(forks.size() + 1);
+		forks[forks.size() - 1].size = data.size();
+		entity_to_data.fork();
+	}
+
+	/// Restores the state of the fork `p_fork`, where `0` is the oldest fork.
+	/// The newer forks are dropped, while `p_fork` is kept.
+	/// The `Entities` of the restored data are appended to `r_restored`,
+	/// together with the `Entities` that lost their data: check `has` to
+	/// tell them apart. An `Entity` may be appended more than once.
+	void restore_fork(uint32_t p_fork, LocalVector<EntityID> &r_restored) {
+		ERR_FAIL_UNSIGNED_INDEX_MSG(p_fork, forks.size(), "The fork " + itos(p_fork) + " doesn't exist.");
+
+		// The `Entities` stored now into the pages to restore, or past the
+		// restored size, may lose their data.
+		for (uint32_t f = p_fork; f < forks.size(); f += 1) {
+			const Fork &fork = forks[f];
+			for (uint32_t i = 0; i < fork.pages.size(); i += 1) {
+				const uint32_t begin = fork.pages[i] << FORK_PAGE_SHIFT;
+				const uint32_t end = MIN(begin + FORK_PAGE_SIZE, data.size());
+				for (uint32_t e = begin; e < end; e += 1) {
+					r_restored.push_back(data_to_entity[e]);
+				}
+			}
+		}
+		for (uint32_t e = forks[p_fork].size; e < data.size(); e += 1) {
+			r_restored.push_back(data_to_entity[e]);
+		}
+
+		// Undo the forks from the newest, so each page ends up as it was when
+		// the fork `p_fork` was taken.
+		for (int64_t f = int64_t(forks.size()) - 1; f >= int64_t(p_fork); f -= 1) {
+			const Fork &fork = forks[f];
+			data.resize(fork.size);
+			data_to_entity.resize(fork.size);
+
+			uint32_t offset = 0;
+			for (uint32_t i = 0; i < fork.pages.size(); i += 1) {
+				const uint32_t begin = fork.pages[i] << FORK_PAGE_SHIFT;
+				const uint32_t count = MIN(FORK_PAGE_SIZE, fork.size - begin);
+				for (uint32_t e = 0; e < count; e += 1) {
+					data[begin + e] = fork.data[offset + e];
+					data_to_entity[begin + e] = fork.entities[offset + e];
+				}
+				offset += count;
+			}
+		}
+
+		for (int64_t f = int64_t(forks.size()) - 1; f >= int64_t(p_fork); f -= 1) {
+			const Fork &fork = forks[f];
+			for (uint32_t i = 0; i < fork.pages.size(); i += 1) {
+				const uint32_t begin = fork.pages[i] << FORK_PAGE_SHIFT;
+				const uint32_t end = MIN(begin + FORK_PAGE_SIZE, data.size());
+				for (uint32_t e = begin; e < end; e += 1) {
+					r_restored.push_back(data_to_entity[e]);
+				}
+			}
+		}
+
+		forks.resize(p_fork + 1);
+		forks[p_fork].pages.clear();
+		forks[p_fork].data.clear();
+		forks[p_fork].entities.clear();
+		// The pages saved so far belong to the dropped forks.
+		fork_epoch += 1;
+
+		entity_to_data.restore_fork(p_fork);
+	}
 
-		entity_to_data.resize(p_reserve);
-		for (uint32_t i = 0; i < p_reserve; i += 1) {
-			entity_to_data[i] = UINT32_MAX;
+	/// Drops the `p_count` oldest forks.
+	void release_forks(uint32_t p_count) {
+		p_count = MIN(p_count, forks.size());
+		for (uint32_t i = 0; i < p_count; i += 1) {
+			forks.remove_at(0);
 		}
+		entity_to_data.release_forks(p_count);
+	}
+
+	uint32_t get_forks_count() const {
+		return forks.size();
 	}
 
 protected:
 	void insert_entity(EntityID p_entity, uint32_t p_index) {
-		if (entity_to_data.size() <= p_entity) {
-			const uint32_t start = entity_to_data.size();
-			// Resize the vector so to fit this new entity.
-			entity_to_data.resize(p_entity + 1);
-			for (uint32_t i = start; i < entity_to_data.size(); i += 1) {
-				entity_to_data[i] = UINT32_MAX;
+		// Store the data-index, the page is allocated only if needed.
+		entity_to_data.set(p_entity, p_index);
+	}
+
+	/// Saves the page of `p_index` into the newest fork, if this is the first
+	/// time the page is written after it.
+	_FORCE_INLINE_ void fork_save(uint32_t p_index) {
+		if (unlikely(forks.size() > 0)) {
+			const uint32_t page = p_index >> FORK_PAGE_SHIFT;
+			if ((page << FORK_PAGE_SHIFT) < forks[forks.size() - 1].size &&
+					pages_fork_epoch[page].load(std::memory_order_acquire) != fork_epoch) {
+				fork_save_page(page);
 			}
 		}
+	}
+
+	void fork_save_all() {
+		if (unlikely(forks.size() > 0)) {
+			const uint32_t size = MIN(data.size(), forks[forks.size() - 1].size);
+			for (uint32_t i = 0; i < size; i += FORK_PAGE_SIZE) {
+				fork_save(i);
+			}
+		}
+	}
+
+	void fork_save_page(uint32_t p_page) {
+		MutexLock lock(fork_mutex);
+		if (pages_fork_epoch[p_page].load(std::memory_order_relaxed) == fork_epoch) {
+			// Saved by another thread in the meantime.
+			return;
+		}
+
+		Fork &fork = forks[forks.size() - 1];
+		const uint32_t begin = p_page << FORK_PAGE_SHIFT;
+		const uint32_t count = MIN(FORK_PAGE_SIZE, fork.size - begin);
+		fork.pages.push_back(p_page);
+		for (uint32_t e = 0; e < count; e += 1) {
+			fork.data.push_back(data[begin + e]);
+			fork.entities.push_back(data_to_entity[begin + e]);
+		}
 
-		// Store the data-index
-		entity_to_data[p_entity] = p_index;
+		pages_fork_epoch[p_page].store(fork_epoch, std::memory_order_release);
 	}
 };
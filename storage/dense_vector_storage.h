@@ -28,16 +28,42 @@ public:
 		StorageBase::notify_changed(p_entity);
 	}
 
-	virtual bool has(EntityID p_entity) const override {
+	virtual void insert_batch(const EntityID *p_entities, uint32_t p_count, const T *p_data) override {
+		storage.reserve(p_count);
+		for (uint32_t i = 0; i < p_count; i += 1) {
+			if (storage.has(p_entities[i])) {
+				storage.get(p_entities[i]) = p_data[i];
+			} else {
+				storage.insert(p_entities[i], p_data[i]);
+			}
+		}
+		StorageBase::notify_changed_batch(p_entities, p_count);
+	}
+
+	virtual void insert_batch(const EntityID *p_entities, uint32_t p_count, const T &p_data) override {
+		storage.reserve(p_count);
+		for (uint32_t i = 0; i < p_count; i += 1) {
+			if (storage.has(p_entities[i])) {
+				storage.get(p_entities[i]) = p_data;
+			} else {
+				storage.insert(p_entities[i], p_data);
+			}
+		}
+		StorageBase::notify_changed_batch(p_entities, p_count);
+	}
+
+	// These are `final` so the `Query`, that knows the storage type, can call
+	// them without virtual dispatch.
+	virtual bool has(EntityID p_entity) const override final {
 		return storage.has(p_entity);
 	}
 
-	virtual T *get(EntityID p_entity, Space p_mode = Space::LOCAL) override {
+	virtual T *get(EntityID p_entity, Space p_mode = Space::LOCAL) override final {
 		StorageBase::notify_changed(p_entity);
 		return &storage.get(p_entity);
 	}
 
-	virtual const T *get(EntityID p_entity, Space p_mode = Space::LOCAL) const override {
+	virtual const T *get(EntityID p_entity, Space p_mode = Space::LOCAL) const override final {
 		return &storage.get(p_entity);
 	}
 
@@ -49,12 +75,70 @@ public:
 
 	virtual void clear() override {
 		storage.clear();
+		StorageBase::notify_cleared();
 		StorageBase::flush_changed();
 	}
 
 	virtual EntitiesBuffer get_stored_entities() const {
 		return { storage.get_entities().size(), storage.get_entities().ptr() };
 	}
+
+	virtual void save_snapshot(SnapshotWriter &p_writer, uint32_t p_component_id) const override {
+		if constexpr (snapshot_raw_layout<T>::value) {
+			const uint32_t count = storage.get_entities().size();
+			p_writer.write_u32(SNAPSHOT_FORMAT_RAW);
+			p_writer.write_u32(sizeof(T));
+			p_writer.write_u32(count);
+			p_writer.write_raw(storage.get_entities().ptr(), sizeof(EntityID) * count);
+			p_writer.write_raw(storage.get_data().ptr(), sizeof(T) * count);
+		} else {
+			StorageBase::save_snapshot(p_writer, p_component_id);
+		}
+	}
+
+	virtual bool load_snapshot(SnapshotReader &p_reader, uint32_t p_component_id) override {
+		if constexpr (snapshot_raw_layout<T>::value) {
+			uint32_t format;
+			uint32_t size;
+			uint32_t count;
+			ERR_FAIL_COND_V(p_reader.read_u32(format) == false || format != SNAPSHOT_FORMAT_RAW, false);
+			ERR_FAIL_COND_V_MSG(p_reader.read_u32(size) == false || size != sizeof(T), false, "The component layout changed since the snapshot was taken.");
+			ERR_FAIL_COND_V(p_reader.read_u32(count) == false, false);
+			ERR_FAIL_COND_V_MSG(storage.get_entities().size() != 0, false, "The storage must be empty to load the snapshot.");
+
+			const uint8_t *entities = p_reader.read_array(count, sizeof(EntityID));
+			const uint8_t *data = p_reader.read_array(count, sizeof(T));
+			ERR_FAIL_COND_V(entities == nullptr || data == nullptr, false);
+
+			const bool adopted = storage.adopt(
+					reinterpret_cast<const EntityID *>(entities),
+					reinterpret_cast<const T *>(data),
+					count);
+			ERR_FAIL_COND_V(adopted == false, false);
+			StorageBase::notify_changed_batch(storage.get_entities().ptr(), count);
+			return true;
+		} else {
+			return StorageBase::load_snapshot(p_reader, p_component_id);
+		}
+	}
+
+	virtual bool is_forkable() const override {
+		return true;
+	}
+
+	virtual void fork(uint32_t p_component_id) override {
+		storage.fork();
+	}
+
+	virtual void restore_fork(uint32_t p_fork, uint32_t p_component_id) override {
+		LocalVector<EntityID> restored;
+		storage.restore_fork(p_fork, restored);
+		StorageBase::notify_restored(restored.ptr(), restored.size());
+	}
+
+	virtual void release_forks(uint32_t p_count) override {
+		storage.release_forks(p_count);
+	}
 };
 
 template <class T>
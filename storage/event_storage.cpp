@@ -0,0 +1,35 @@
+#include "event_storage.h"
+
+Mutex EventEmitters::mutex;
+OAHashMap<String, godex::emitter_id> EventEmitters::ids;
+LocalVector<String> EventEmitters::names;
+
+godex::emitter_id EventEmitters::intern(const String &p_name) {
+	MutexLock lock(mutex);
+	const godex::emitter_id *id = ids.lookup_ptr(p_name);
+	if (id != nullptr) {
+		return *id;
+	}
+	const godex::emitter_id new_id = names.size();
+	names.push_back(p_name);
+	ids.insert(p_name, new_id);
+	return new_id;
+}
+
+godex::emitter_id EventEmitters::get_id(const String &p_name) {
+	MutexLock lock(mutex);
+	const godex::emitter_id *id = ids.lookup_ptr(p_name);
+	return id == nullptr ? godex::EMITTER_NONE : *id;
+}
+
+String EventEmitters::get_name(godex::emitter_id p_id) {
+	MutexLock lock(mutex);
+	ERR_FAIL_UNSIGNED_INDEX_V(p_id, names.size(), String());
+	return names[p_id];
+}
+
+void EventEmitters::__static_destructor() {
+	MutexLock lock(mutex);
+	ids.clear();
+	names.reset();
+}
@@ -1,9 +1,45 @@
 #pragma once
 
+#include "../ecs_types.h"
+#include "../utils/thread_pool.h"
+#include "core/os/mutex.h"
 #include "core/templates/local_vector.h"
 #include "core/templates/oa_hash_map.h"
 #include "core/variant/dictionary.h"
 
+/// Interns the emitter names: each name is mapped to a dense `emitter_id`, so
+/// the `EventStorage` can store the events of each emitter in an array.
+///
+/// The id of an `EMITTER(Name)` is resolved once and cached by the
+/// `EventsEmitter` and `EventsReceiver`, so emitting an event doesn't need to
+/// hash any string.
+class EventEmitters {
+	static Mutex mutex;
+	static OAHashMap<String, godex::emitter_id> ids;
+	static LocalVector<String> names;
+
+public:
+	/// Returns the id of this emitter name, assigning a new one if necessary.
+	/// Safe to call from many threads.
+	static godex::emitter_id intern(const String &p_name);
+
+	/// Returns the id of this emitter name, or `EMITTER_NONE` if never interned.
+	static godex::emitter_id get_id(const String &p_name);
+
+	static String get_name(godex::emitter_id p_id);
+
+	static void __static_destructor();
+};
+
+/// The read position of an `EventsReceiver` on a persistent `EventStorage`.
+/// The memory is owned by the receiver, the storage detaches it when destroyed.
+struct EventReader {
+	godex::emitter_id emitter = godex::EMITTER_NONE;
+	/// The sequence number of the next event to read.
+	uint64_t cursor = 0;
+	bool attached = false;
+};
+
 class EventStorageBase {
 public:
 	virtual ~EventStorageBase() {
@@ -35,20 +71,121 @@ public:
 	virtual void flush_events() {
 		CRASH_NOW_MSG("Override this function.");
 	}
+
+	/// Flushes the old events and opens the per thread buffers used by the
+	/// `SharedEventsEmitter`s. `p_lanes_count` is the number of threads that
+	/// can emit, the non worker threads included.
+	virtual void begin_shared_emission(uint32_t p_lanes_count) {
+		CRASH_NOW_MSG("Override this function.");
+	}
+
+	virtual bool is_shared_emission_open() const {
+		CRASH_NOW_MSG("Override this function.");
+		return false;
+	}
+
+	/// Moves the events of the per thread buffers into the emitters, so the
+	/// receivers can read them.
+	virtual void end_shared_emission() {
+		CRASH_NOW_MSG("Override this function.");
+	}
 };
 
+/// Stores the events of each emitter in an array indexed by `emitter_id`.
+/// The memory of the events is reused frame after frame: `flush_events` just
+/// clears the emitters that received some events.
+///
+/// Many `System`s can emit the same event from different threads, using the
+/// `SharedEventsEmitter`: each thread appends to its own lane, and the lanes
+/// are merged into the emitters by `end_shared_emission`, before any receiver
+/// runs. The merge follows the task order (see `ThreadPool::Order`), so the
+/// events order doesn't depend on which thread run which `System`.
+///
+/// When `persistent`, the events survive the flush until all the receivers
+/// read them: each `EventsReceiver` keeps its own `EventReader` cursor, so it
+/// gets each event exactly once, even if it runs less often than the emitter.
+/// The flush just drops the events all the readers already consumed.
 template <class E>
 class EventStorage : public EventStorageBase {
-	OAHashMap<String, LocalVector<E>> events_map;
+	struct Channel {
+		bool exists = false;
+		LocalVector<E> events;
+		/// The sequence number of `events[0]`, used only when `persistent`.
+		uint64_t first_sequence = 0;
+	};
+
+	struct Lane {
+		/// Parallel to `events`: the emitter of each event.
+		LocalVector<godex::emitter_id> emitters;
+		/// Parallel to `events`: the task that emitted each event.
+		LocalVector<ThreadPool::Order> orders;
+		LocalVector<E> events;
+	};
+
+	/// An event of the lane `lane`, sorted by `end_shared_emission`.
+	struct SortedEvent {
+		ThreadPool::Order order;
+		uint32_t lane = 0;
+		uint32_t index = 0;
+	};
+
+	struct SortedEventComparator {
+		bool operator()(const SortedEvent &p_a, const SortedEvent &p_b) const {
+			if (p_a.order < p_b.order) {
+				return true;
+			}
+			if (p_b.order < p_a.order) {
+				return false;
+			}
+			return p_a.lane == p_b.lane ? p_a.index < p_b.index : p_a.lane < p_b.lane;
+		}
+	};
+
+	/// Indexed by `emitter_id`.
+	LocalVector<Channel> channels;
+	/// The emitters that received some events since the last flush.
+	LocalVector<godex::emitter_id> used_channels;
+
+	/// Indexed by `ThreadPool::get_thread_index()`.
+	LocalVector<Lane> lanes;
+	/// Used by `end_shared_emission` when more than one lane has events.
+	LocalVector<SortedEvent> sorted_events;
+	bool shared_emission = false;
+
+	bool persistent = false;
+	LocalVector<EventReader *> readers;
 
 public:
+	virtual ~EventStorage() {
+		for (uint32_t i = 0; i < readers.size(); i += 1) {
+			readers[i]->attached = false;
+		}
+	}
+
+	void set_persistent(bool p_persistent) {
+		ERR_FAIL_COND_MSG(readers.size() > 0, String("The persistent mode of the event `") + E::get_class_static() + "` can't change while some receivers read it.");
+		persistent = p_persistent;
+	}
+
+	bool is_persistent() const {
+		return persistent;
+	}
+
 	virtual void add_event_emitter(const String &p_emitter) override {
-		ERR_FAIL_COND_MSG(events_map.has(p_emitter), String("The emitter `") + p_emitter + "` for the event `" + E::get_class_static() + "` exists.");
-		events_map.insert(p_emitter, LocalVector<E>());
+		const godex::emitter_id id = EventEmitters::intern(p_emitter);
+		ERR_FAIL_COND_MSG(has_emitter(id), String("The emitter `") + p_emitter + "` for the event `" + E::get_class_static() + "` exists.");
+		if (id >= channels.size()) {
+			channels.resize(id + 1);
+		}
+		channels[id].exists = true;
 	}
 
 	virtual bool has_emitter(const String &p_emitter) override {
-		return events_map.has(p_emitter);
+		return has_emitter(EventEmitters::get_id(p_emitter));
+	}
+
+	bool has_emitter(godex::emitter_id p_emitter) const {
+		return p_emitter < channels.size() && channels[p_emitter].exists;
 	}
 
 	virtual void add_event_dynamic(const String &p_emitter, const Dictionary &p_data) override {
@@ -89,19 +226,186 @@ public:
 	}
 
 	virtual void flush_events() override {
-		for (typename OAHashMap<String, LocalVector<E>>::Iterator it = events_map.iter(); it.valid; it = events_map.next_iter(it)) {
-			it.value->clear();
+		if (persistent) {
+			flush_consumed_events();
+			return;
 		}
+		for (uint32_t i = 0; i < used_channels.size(); i += 1) {
+			// `clear` keeps the memory, so it's reused by the next events.
+			channels[used_channels[i]].events.clear();
+		}
+		used_channels.clear();
+	}
+
+	virtual void begin_shared_emission(uint32_t p_lanes_count) override {
+		ERR_FAIL_COND_MSG(shared_emission, String("The shared emission of the event `") + E::get_class_static() + "` is already open.");
+		flush_events();
+		if (lanes.size() < p_lanes_count) {
+			lanes.resize(p_lanes_count);
+		}
+		shared_emission = true;
+	}
+
+	virtual bool is_shared_emission_open() const override {
+		return shared_emission;
+	}
+
+	virtual void end_shared_emission() override {
+		ERR_FAIL_COND_MSG(shared_emission == false, String("The shared emission of the event `") + E::get_class_static() + "` is not open.");
+
+		uint32_t used_lanes = 0;
+		uint32_t last_used_lane = 0;
+		for (uint32_t l = 0; l < lanes.size(); l += 1) {
+			if (lanes[l].events.size() > 0) {
+				used_lanes += 1;
+				last_used_lane = l;
+			}
+		}
+
+		if (used_lanes == 1) {
+			// A single lane is already in order.
+			const Lane &lane = lanes[last_used_lane];
+			for (uint32_t i = 0; i < lane.events.size(); i += 1) {
+				add_event(lane.emitters[i], lane.events[i]);
+			}
+		} else if (used_lanes > 1) {
+			// Merge the lanes in task order; the events emitted by a task keep
+			// their relative order.
+			sorted_events.clear();
+			for (uint32_t l = 0; l < lanes.size(); l += 1) {
+				for (uint32_t i = 0; i < lanes[l].events.size(); i += 1) {
+					SortedEvent sorted;
+					sorted.order = lanes[l].orders[i];
+					sorted.lane = l;
+					sorted.index = i;
+					sorted_events.push_back(sorted);
+				}
+			}
+			sorted_events.sort_custom<SortedEventComparator>();
+			for (uint32_t i = 0; i < sorted_events.size(); i += 1) {
+				const Lane &lane = lanes[sorted_events[i].lane];
+				add_event(lane.emitters[sorted_events[i].index], lane.events[sorted_events[i].index]);
+			}
+			sorted_events.clear();
+		}
+
+		for (uint32_t l = 0; l < lanes.size(); l += 1) {
+			// `clear` keeps the memory, so it's reused by the next events.
+			lanes[l].emitters.clear();
+			lanes[l].orders.clear();
+			lanes[l].events.clear();
+		}
+		shared_emission = false;
 	}
 
 public:
-	void add_event(const String &p_emitter, E p_event) {
-		LocalVector<E> *emitter = events_map.lookup_ptr(p_emitter);
-		ERR_FAIL_COND_MSG(emitter == nullptr, String("The emitter `") + p_emitter + "` for the event `" + E::get_class_static() + "` doesn't exists. No systems are fetching from this emitter.");
-		emitter->push_back(p_event);
+	void add_event(const String &p_emitter, const E &p_event) {
+		const godex::emitter_id id = EventEmitters::get_id(p_emitter);
+		ERR_FAIL_COND_MSG(has_emitter(id) == false, String("The emitter `") + p_emitter + "` for the event `" + E::get_class_static() + "` doesn't exists. No systems are fetching from this emitter.");
+		add_event(id, p_event);
+	}
+
+	_FORCE_INLINE_ void add_event(godex::emitter_id p_emitter, const E &p_event) {
+#ifdef DEBUG_ENABLED
+		ERR_FAIL_COND_MSG(has_emitter(p_emitter) == false, String("The emitter `") + EventEmitters::get_name(p_emitter) + "` for the event `" + E::get_class_static() + "` doesn't exists. No systems are fetching from this emitter.");
+#endif
+		// Also in release, the id comes from the caller: never write out of
+		// the channels.
+		ERR_FAIL_UNSIGNED_INDEX(p_emitter, channels.size());
+		LocalVector<E> &events = channels[p_emitter].events;
+		if (events.size() == 0) {
+			used_channels.push_back(p_emitter);
+		}
+		events.push_back(p_event);
+	}
+
+	/// Thread safe, as long as each thread has its own lane: can be called only
+	/// between `begin_shared_emission` and `end_shared_emission`.
+	_FORCE_INLINE_ void add_shared_event(godex::emitter_id p_emitter, const E &p_event) {
+		const uint32_t index = ThreadPool::get_thread_index();
+		// Checked here, also in release: an unknown emitter would be dropped
+		// only at the end of the stage, far from the `System` that emitted it.
+		ERR_FAIL_COND_MSG(has_emitter(p_emitter) == false, String("The emitter `") + (p_emitter == godex::EMITTER_NONE ? String() : EventEmitters::get_name(p_emitter)) + "` for the event `" + E::get_class_static() + "` doesn't exists. No systems are fetching from this emitter.");
+#ifdef DEBUG_ENABLED
+		CRASH_COND_MSG(shared_emission == false, String("The shared emission of the event `") + E::get_class_static() + "` is not open.");
+		CRASH_COND_MSG(index >= lanes.size(), "The EventStorage has no lane for the thread " + itos(index) + ".");
+#endif
+		Lane &lane = lanes[index];
+		lane.emitters.push_back(p_emitter);
+		lane.orders.push_back(ThreadPool::get_order());
+		lane.events.push_back(p_event);
+	}
+
+	/// Attaches the reader to the emitter: it reads the events emitted from now
+	/// on. Can be used only when `persistent`.
+	void add_reader(EventReader *p_reader, godex::emitter_id p_emitter) {
+		ERR_FAIL_COND_MSG(persistent == false, String("The event `") + E::get_class_static() + "` is not persistent.");
+		ERR_FAIL_COND_MSG(has_emitter(p_emitter) == false, String("The emitter `") + EventEmitters::get_name(p_emitter) + "` for the event `" + E::get_class_static() + "` doesn't exists.");
+		ERR_FAIL_COND_MSG(p_reader->attached, "This reader is already attached.");
+		const Channel &channel = channels[p_emitter];
+		p_reader->emitter = p_emitter;
+		p_reader->cursor = channel.first_sequence + channel.events.size();
+		p_reader->attached = true;
+		readers.push_back(p_reader);
+	}
+
+	void remove_reader(EventReader *p_reader) {
+		const int64_t index = readers.find(p_reader);
+		ERR_FAIL_COND_MSG(index == -1, "This reader is not attached to this storage.");
+		readers.remove_at_unordered(index);
+		p_reader->attached = false;
+	}
+
+	/// Returns the events not yet read by this reader, and marks them as read.
+	/// Many readers can read at the same time, since each one moves only its
+	/// own cursor.
+	const E *read(EventReader *p_reader, uint32_t &r_count) {
+#ifdef DEBUG_ENABLED
+		CRASH_COND_MSG(p_reader->attached == false, "This reader is not attached.");
+#endif
+		const Channel &channel = channels[p_reader->emitter];
+		const uint32_t begin = p_reader->cursor - channel.first_sequence;
+		r_count = channel.events.size() - begin;
+		p_reader->cursor = channel.first_sequence + channel.events.size();
+		return channel.events.ptr() + begin;
 	}
 
 	const LocalVector<E> *get_events(const String &p_emitter) const {
-		return events_map.lookup_ptr(p_emitter);
+		return get_events(EventEmitters::get_id(p_emitter));
+	}
+
+	const LocalVector<E> *get_events(godex::emitter_id p_emitter) const {
+		return has_emitter(p_emitter) ? &channels[p_emitter].events : nullptr;
+	}
+
+private:
+	/// Drops the events that all the readers of the channel already read.
+	void flush_consumed_events() {
+		for (int64_t i = int64_t(used_channels.size()) - 1; i >= 0; i -= 1) {
+			Channel &channel = channels[used_channels[i]];
+			const uint64_t end = channel.first_sequence + channel.events.size();
+
+			uint64_t min_cursor = end;
+			for (uint32_t r = 0; r < readers.size(); r += 1) {
+				if (readers[r]->emitter == used_channels[i]) {
+					min_cursor = MIN(min_cursor, readers[r]->cursor);
+				}
+			}
+
+			const uint32_t consumed = min_cursor - channel.first_sequence;
+			if (consumed == channel.events.size()) {
+				// Everything was read, `clear` keeps the memory.
+				channel.events.clear();
+				used_channels.remove_at_unordered(i);
+			} else if (consumed > 0) {
+				// Move the unread events at the front.
+				const uint32_t remaining = channel.events.size() - consumed;
+				for (uint32_t e = 0; e < remaining; e += 1) {
+					channel.events[e] = channel.events[consumed + e];
+				}
+				channel.events.resize(remaining);
+			}
+			channel.first_sequence += consumed;
+		}
 	}
 };
@@ -24,6 +24,8 @@ class Hierarchy : public Storage<Child> {
 	DenseVector<Child> storage;
 	EntityList hierarchy_changed;
 	LocalVector<HierarchicalStorageBase *> sub_storages;
+	/// The workers of the `Pipeline` that is dispatching the world, if any.
+	ThreadPool *thread_pool = nullptr;
 
 public:
 	void configure(const Dictionary &p_config) {
@@ -41,6 +43,16 @@ public:
 		return hierarchy_changed;
 	}
 
+	/// Set by the `Pipeline` while dispatching, so the sub storages can
+	/// propagate the changes in parallel.
+	void set_thread_pool(ThreadPool *p_thread_pool) {
+		thread_pool = p_thread_pool;
+	}
+
+	ThreadPool *get_thread_pool() const {
+		return thread_pool;
+	}
+
 	virtual void on_system_release() override {
 		flush_hierarchy_changes();
 	}
@@ -60,19 +72,23 @@ public:
 		return true;
 	}
 
+	virtual bool is_parallel_write_safe() const override {
+		// Changing a relationship alters the parent and the siblings too.
+		return false;
+	}
+
 	virtual bool has(EntityID p_entity) const override {
 		return storage.has(p_entity);
 	}
 
 	virtual void remove(EntityID p_entity) override {
 		if (storage.has(p_entity)) {
-			Child &child = storage.get(p_entity);
-
 			// 1. Unlink from parent.
-			unlink_parent(p_entity, child);
+			unlink_parent(p_entity, storage.get(p_entity));
 
-			// 2. Unlink the childs.
-			unlink_childs(child);
+			// 2. Unlink the childs. Fetched again, since removing the parent
+			// may have moved the data.
+			unlink_childs(storage.get(p_entity));
 
 			// 3. Drop the data.
 			storage.remove(p_entity);
@@ -87,23 +103,9 @@ public:
 	}
 
 	virtual void insert(EntityID p_entity, const Child &p_data) override {
-		bool update;
-
 		if (storage.has(p_entity)) {
 			// This is an update.
-			update = true;
-		} else if (p_data.parent.is_null() == false) {
-			// This is a new insert.
-			update = false;
-			storage.insert(p_entity, p_data);
-		} else {
-			// This is a new insert but there is no parent so nothing to do.
-			return;
-		}
-
-		Child &child = storage.get(p_entity);
-
-		if (update) {
+			Child &child = storage.get(p_entity);
 			if (child.parent == p_data.parent) {
 				// Same parent, nothing to do.
 				return;
@@ -113,37 +115,45 @@ public:
 			// 1. Unlink p_entity with its current parent.
 			unlink_parent(p_entity, child);
 
-			// 2. Set `p_entity` with its new parent.
-			child.parent = p_data.parent;
+			// 2. Set `p_entity` with its new parent. Fetched again, since
+			// removing the old parent may have moved the data.
+			Child &relinked_child = storage.get(p_entity);
+			relinked_child.parent = p_data.parent;
 
-			if (child.parent.is_null() && child.first_child.is_null()) {
+			if (relinked_child.parent.is_null() && relinked_child.first_child.is_null()) {
 				// There are no more relations, so just remove this.
 				remove(p_entity);
 				return;
 			}
+		} else if (p_data.parent.is_null() == false) {
+			// This is a new insert, so make sure the links are not set.
+			Child child(p_data.parent);
+			storage.insert(p_entity, child);
 		} else {
-			// This is a new insert, so make sure `first_child` and `next` are
-			// not set.
-			child.first_child = EntityID();
-			child.next = EntityID();
+			// This is a new insert but there is no parent so nothing to do.
+			return;
 		}
 
 		hierarchy_changed.insert(p_entity);
 
 		// Update the parent if any.
-		if (child.parent.is_null() == false) {
-			if (has(child.parent) == false) {
+		if (p_data.parent.is_null() == false) {
+			if (has(p_data.parent) == false) {
 				// Parent is always root when added in this way.
-				storage.insert(child.parent, Child());
-				hierarchy_changed.insert(child.parent);
+				storage.insert(p_data.parent, Child());
+				hierarchy_changed.insert(p_data.parent);
 			}
 
-			Child &parent = storage.get(child.parent);
-
-			// Add `child` as child of this parent but keep the chain.
-			EntityID prev_first_child = parent.first_child;
+			// Add `p_entity` as first child of this parent but keep the chain.
+			Child &parent = storage.get(p_data.parent);
+			Child &child = storage.get(p_entity);
+			const EntityID prev_first_child = parent.first_child;
 			parent.first_child = p_entity;
+			child.prev = EntityID();
 			child.next = prev_first_child;
+			if (prev_first_child.is_null() == false) {
+				storage.get(prev_first_child).prev = p_entity;
+			}
 		}
 	}
 
@@ -160,6 +170,26 @@ public:
 		return { storage.get_entities().size(), storage.get_entities().ptr() };
 	}
 
+	virtual bool is_forkable() const override {
+		return true;
+	}
+
+	/// The `World` flushes the hierarchy changes before taking the fork, so
+	/// only the structure is forked.
+	virtual void fork(uint32_t p_component_id) override {
+		storage.fork();
+	}
+
+	virtual void restore_fork(uint32_t p_fork, uint32_t p_component_id) override {
+		LocalVector<EntityID> restored;
+		storage.restore_fork(p_fork, restored);
+		hierarchy_changed.clear();
+	}
+
+	virtual void release_forks(uint32_t p_count) override {
+		storage.release_forks(p_count);
+	}
+
 	/// For each child, slow version.
 	template <typename F>
 	void for_each_child(EntityID p_entity, F func) const {
@@ -203,46 +233,30 @@ public:
 	}
 
 private:
-	/// This is private because it's possible to alter the hierarchy only via:
-	/// `insert`, `remove`.
-	template <typename F>
-	void for_each_child_mutable(Child &this_entity_data, F func) {
-		EntityID next = this_entity_data.first_child;
-		while (next.is_null() == false) {
-			Child &next_c = storage.get(next);
-			if (func(next, next_c) == false) {
-				// Stop here.
-				return;
-			}
-			next = next_c.next;
-		}
-	}
+	// These are private because it's possible to alter the hierarchy only via:
+	// `insert`, `remove`.
 
-	/// Unlink from parent.
+	/// Unlink from parent, O(1) thanks to the `prev` link.
 	void unlink_parent(EntityID p_entity, Child &this_entity_data) {
 		if (this_entity_data.parent.is_null()) {
 			return;
 		}
 
 		Child &parent = storage.get(this_entity_data.parent);
-		if (parent.first_child == p_entity) {
+		if (this_entity_data.prev.is_null()) {
 			// This `Entity` is the first child of its parent.
 			parent.first_child = this_entity_data.next;
-
 		} else {
-			// This `Entity` is not the first child, so search it and remove.
-			for_each_child_mutable(parent, [&](EntityID p_sub_child_id, Child &p_sub_child) -> bool {
-				if (p_sub_child.next == p_entity) {
-					// This `Entity` is pointeed by this `sub_child` so remove it.
-					p_sub_child.next = this_entity_data.next;
-					return false;
-				}
-				return true;
-			});
+			storage.get(this_entity_data.prev).next = this_entity_data.next;
+		}
+		if (this_entity_data.next.is_null() == false) {
+			storage.get(this_entity_data.next).prev = this_entity_data.prev;
 		}
 
 		const EntityID parent_entity = this_entity_data.parent;
 		this_entity_data.parent = EntityID();
+		this_entity_data.prev = EntityID();
+		this_entity_data.next = EntityID();
 
 		if (parent.first_child.is_null() && parent.parent.is_null()) {
 			// Since this parent has no more relationships, remove it.
@@ -252,20 +266,26 @@ private:
 
 	/// Unlink from childs.
 	void unlink_childs(Child &this_entity_data) {
-		for_each_child_mutable(this_entity_data, [&](EntityID p_entity, Child &p_child) -> bool {
-			p_child.parent = EntityID();
-
-			if (p_child.first_child.is_null()) {
-				// Since this child has no more relationships, remove it.
-				remove(p_entity);
-			}
-
-			// Keep iterate.
-			return true;
-		});
+		EntityID next = this_entity_data.first_child;
 
 		// No more childs.
 		this_entity_data.first_child = EntityID();
+
+		while (next.is_null() == false) {
+			const EntityID entity = next;
+			Child &child = storage.get(entity);
+			next = child.next;
+
+			child.parent = EntityID();
+			child.prev = EntityID();
+			child.next = EntityID();
+
+			if (child.first_child.is_null()) {
+				// Since this child has no more relationships, remove it.
+				// Removing may move the data, so `child` is not used anymore.
+				remove(entity);
+			}
+		}
 	}
 };
 
@@ -280,16 +300,33 @@ struct LocalGlobal {
 };
 
 /// Stores the data
+///
+/// By default, the changes are propagated recursively, one `Entity` at a time.
+/// With the `breadth_first` config the hierarchy is visited level by level
+/// instead: each level is a flat array of child / parent data, that is
+/// combined in parallel when big enough.
 template <class T>
 class HierarchicalStorage : public Storage<T>, public HierarchicalStorageBase {
+	/// The amount of `Entities` of a level combined by a single task.
+	static constexpr uint32_t PARALLEL_CHUNK_SIZE = 512;
+
 	DenseVector<LocalGlobal<T>> internal_storage;
 	// List of `Entities` taken mutably, for which we need to flush.
 	EntityList relationship_dirty_list;
 
+	bool breadth_first = false;
+	/// The `Entities` to propagate, sorted by level. Built by each flush, but
+	/// the vectors are members so their memory is reused.
+	LocalVector<EntityID> propagation_queue;
+	/// The level being propagated: the parent data is `nullptr` for the roots.
+	LocalVector<LocalGlobal<T> *> level_data;
+	LocalVector<const LocalGlobal<T> *> level_parents_data;
+
 public:
 	void configure(const Dictionary &p_config) {
 		internal_storage.reset();
 		internal_storage.configure(p_config.get("pre_allocate", 500));
+		breadth_first = p_config.get("breadth_first", false);
 	}
 
 	virtual String get_type_name() const override {
@@ -300,6 +337,12 @@ public:
 		return true;
 	}
 
+	virtual bool is_parallel_write_safe() const override {
+		// Each `Entity` owns its data: the `relationship_dirty_list`, that is
+		// shared, is filled by `on_parallel_changed` once the threads are done.
+		return true;
+	}
+
 	virtual bool has(EntityID p_entity) const override {
 		return internal_storage.has(p_entity);
 	}
@@ -311,6 +354,7 @@ public:
 
 	virtual void clear() override {
 		internal_storage.clear();
+		StorageBase::notify_cleared();
 		StorageBase::flush_changed();
 	}
 
@@ -334,7 +378,12 @@ public:
 		StorageBase::notify_changed(p_entity);
 		LocalGlobal<T> &data = internal_storage.get(p_entity);
 		if (data.has_relationship) {
-			relationship_dirty_list.insert(p_entity);
+			if (likely(StorageBase::is_parallel_changes_in_progress() == false)) {
+				relationship_dirty_list.insert(p_entity);
+			} else {
+				// Inserted by `on_parallel_changed`, since the list is not
+				// thread safe.
+			}
 			data.global_changed = p_mode == Space::GLOBAL;
 		}
 		return data.is_root || p_mode == Space::LOCAL ? &data.local : &data.global;
@@ -349,6 +398,68 @@ public:
 		return { internal_storage.get_entities().size(), internal_storage.get_entities().ptr() };
 	}
 
+	/// With the `SNAPSHOT_RAW_LAYOUT` the local and the global data are stored
+	/// as they are, so the loaded data doesn't need to be propagated again.
+	virtual void save_snapshot(SnapshotWriter &p_writer, uint32_t p_component_id) const override {
+		if constexpr (snapshot_raw_layout<T>::value) {
+			const uint32_t count = internal_storage.get_entities().size();
+			p_writer.write_u32(SNAPSHOT_FORMAT_RAW);
+			p_writer.write_u32(sizeof(LocalGlobal<T>));
+			p_writer.write_u32(count);
+			p_writer.write_raw(internal_storage.get_entities().ptr(), sizeof(EntityID) * count);
+			p_writer.write_raw(internal_storage.get_data().ptr(), sizeof(LocalGlobal<T>) * count);
+		} else {
+			StorageBase::save_snapshot(p_writer, p_component_id);
+		}
+	}
+
+	virtual bool load_snapshot(SnapshotReader &p_reader, uint32_t p_component_id) override {
+		if constexpr (snapshot_raw_layout<T>::value) {
+			uint32_t format;
+			uint32_t size;
+			uint32_t count;
+			ERR_FAIL_COND_V(p_reader.read_u32(format) == false || format != SNAPSHOT_FORMAT_RAW, false);
+			ERR_FAIL_COND_V_MSG(p_reader.read_u32(size) == false || size != sizeof(LocalGlobal<T>), false, "The component layout changed since the snapshot was taken.");
+			ERR_FAIL_COND_V(p_reader.read_u32(count) == false, false);
+			ERR_FAIL_COND_V_MSG(internal_storage.get_entities().size() != 0, false, "The storage must be empty to load the snapshot.");
+
+			const uint8_t *entities = p_reader.read_array(count, sizeof(EntityID));
+			const uint8_t *data = p_reader.read_array(count, sizeof(LocalGlobal<T>));
+			ERR_FAIL_COND_V(entities == nullptr || data == nullptr, false);
+
+			const bool adopted = internal_storage.adopt(
+					reinterpret_cast<const EntityID *>(entities),
+					reinterpret_cast<const LocalGlobal<T> *>(data),
+					count);
+			ERR_FAIL_COND_V(adopted == false, false);
+			StorageBase::notify_changed_batch(internal_storage.get_entities().ptr(), count);
+			return true;
+		} else {
+			return StorageBase::load_snapshot(p_reader, p_component_id);
+		}
+	}
+
+	virtual bool is_forkable() const override {
+		return true;
+	}
+
+	/// Both the local and the global data are forked, so the restored data
+	/// doesn't need to be propagated again.
+	virtual void fork(uint32_t p_component_id) override {
+		internal_storage.fork();
+	}
+
+	virtual void restore_fork(uint32_t p_fork, uint32_t p_component_id) override {
+		LocalVector<EntityID> restored;
+		internal_storage.restore_fork(p_fork, restored);
+		relationship_dirty_list.clear();
+		StorageBase::notify_restored(restored.ptr(), restored.size());
+	}
+
+	virtual void release_forks(uint32_t p_count) override {
+		internal_storage.release_forks(p_count);
+	}
+
 	void propagate_change(EntityID p_entity) {
 		if (has(p_entity) == false) {
 			relationship_dirty_list.remove(p_entity);
@@ -421,10 +532,22 @@ public:
 		flush_changes();
 	}
 
+protected:
+	virtual void on_parallel_changed(EntityID p_entity) override {
+		if (has(p_entity) && internal_storage.get(p_entity).has_relationship) {
+			relationship_dirty_list.insert(p_entity);
+		}
+	}
+
+public:
 	void flush_changes() {
-		relationship_dirty_list.for_each([&](EntityID entity) {
-			propagate_change(entity);
-		});
+		if (breadth_first) {
+			flush_changes_breadth_first();
+		} else {
+			relationship_dirty_list.for_each([&](EntityID entity) {
+				propagate_change(entity);
+			});
+		}
 #ifdef DEBUG_ENABLED
 		CRASH_COND_MSG(relationship_dirty_list.is_empty() == false, "At this point the flush list must be empty.");
 #endif
@@ -436,4 +559,135 @@ public:
 		});
 		flush_changes();
 	}
+
+private:
+	/// The queue holds only the dirty subtrees, so it's rebuilt each flush: a
+	/// depth ordered index of the whole hierarchy, rebuilt when the hierarchy
+	/// changes, would need a full scan to find the dirty `Entities` instead.
+	/// The level data is taken again too, since the `DenseVector` moves the
+	/// data on insert and remove.
+	void flush_changes_breadth_first() {
+#ifdef DEBUG_ENABLED
+		CRASH_COND_MSG(hierarchy == nullptr, "Hierarchy is never supposed to be nullptr.");
+#endif
+		propagation_queue.clear();
+
+		// 1. Find the dirty roots: the dirty `Entities` not reached by the
+		// propagation of a dirty ancestor.
+		relationship_dirty_list.for_each([&](EntityID entity) {
+			if (has(entity) == false) {
+				relationship_dirty_list.remove(entity);
+				return;
+			}
+
+			LocalGlobal<T> &data = internal_storage.get(entity);
+			if (hierarchy->has(entity) == false) {
+				// This is not parented, nothing more to do.
+				data.is_root = true;
+				data.has_relationship = false;
+				relationship_dirty_list.remove(entity);
+				StorageBase::notify_changed(entity);
+				return;
+			}
+			data.has_relationship = true;
+
+			bool reached_by_ancestor = false;
+			hierarchy->for_each_parent(entity, [&](EntityID p_parent, const Child &p_parent_data) -> bool {
+				if (has(p_parent) == false) {
+					// The propagation stops at the `Entities` without `T`.
+					return false;
+				}
+				reached_by_ancestor = relationship_dirty_list.has(p_parent);
+				return reached_by_ancestor == false;
+			});
+
+			if (reached_by_ancestor == false) {
+				propagation_queue.push_back(entity);
+			}
+		});
+
+		// 2. Propagate level by level, so the parents are always combined
+		// before the children: the children of a level are appended to the
+		// queue, and form the next level.
+		uint32_t level_begin = 0;
+		while (level_begin < propagation_queue.size()) {
+			const uint32_t level_end = propagation_queue.size();
+			const uint32_t level_size = level_end - level_begin;
+
+			level_data.resize(level_size);
+			level_parents_data.resize(level_size);
+			for (uint32_t i = 0; i < level_size; i += 1) {
+				const EntityID entity = propagation_queue[level_begin + i];
+				const Child *child = hierarchy->get(entity);
+				level_data[i] = &internal_storage.get(entity);
+				if (child->parent.is_null() || has(child->parent) == false) {
+					// This is root.
+					level_parents_data[i] = nullptr;
+				} else {
+					level_parents_data[i] = &internal_storage.get(child->parent);
+				}
+			}
+
+			combine_level();
+
+			for (uint32_t i = 0; i < level_size; i += 1) {
+				const EntityID entity = propagation_queue[level_begin + i];
+				if (level_parents_data[i] != nullptr) {
+					StorageBase::notify_changed(entity);
+				}
+				relationship_dirty_list.remove(entity);
+
+				hierarchy->for_each_child(entity, [&](EntityID p_child_entity, const Child &p_child_data) -> bool {
+					if (has(p_child_entity)) {
+						propagation_queue.push_back(p_child_entity);
+					}
+					return true;
+				});
+			}
+
+			level_begin = level_end;
+		}
+	}
+
+	void combine_level() {
+		const uint32_t chunks_count = (level_data.size() + PARALLEL_CHUNK_SIZE - 1) / PARALLEL_CHUNK_SIZE;
+		ThreadPool *thread_pool = hierarchy->get_thread_pool();
+		if (chunks_count > 1 &&
+				thread_pool != nullptr &&
+				thread_pool->get_threads_count() > 0 &&
+				ThreadPool::is_executing_task() == false) {
+			thread_pool->run(combine_level_chunk, this, chunks_count);
+		} else {
+			combine_level_range(0, level_data.size());
+		}
+	}
+
+	static void combine_level_chunk(void *p_user_data, uint32_t p_chunk_index) {
+		HierarchicalStorage<T> *self = static_cast<HierarchicalStorage<T> *>(p_user_data);
+		const uint32_t from = p_chunk_index * PARALLEL_CHUNK_SIZE;
+		const uint32_t to = MIN(from + PARALLEL_CHUNK_SIZE, self->level_data.size());
+		self->combine_level_range(from, to);
+	}
+
+	/// Each `Entity` writes only its own data and reads the data of its parent,
+	/// that belongs to the previous level: so the range can run in parallel.
+	void combine_level_range(uint32_t p_from, uint32_t p_to) {
+		LocalGlobal<T> *const *data = level_data.ptr();
+		const LocalGlobal<T> *const *parents_data = level_parents_data.ptr();
+		for (uint32_t i = p_from; i < p_to; i += 1) {
+			LocalGlobal<T> &d = *data[i];
+			if (parents_data[i] == nullptr) {
+				d.is_root = true;
+				continue;
+			}
+			const T &global_parent_data = parents_data[i]->is_root ? parents_data[i]->local : parents_data[i]->global;
+			if (d.global_changed) {
+				T::combine_inverse(d.global, global_parent_data, d.local);
+			} else {
+				T::combine(d.local, global_parent_data, d.global);
+			}
+			d.is_root = false;
+			d.global_changed = false;
+		}
+	}
 };
@@ -0,0 +1,192 @@
+#include "paged_sparse_index.h"
+
+PagedSparseIndex::PagedSparseIndex(const PagedSparseIndex &p_other) {
+	*this = p_other;
+}
+
+PagedSparseIndex &PagedSparseIndex::operator=(const PagedSparseIndex &p_other) {
+	if (this == &p_other) {
+		return *this;
+	}
+	// The forks are not copied.
+	release_forks(forks.size());
+	reset();
+	pages.resize(p_other.pages.size());
+	pages_used = p_other.pages_used;
+	for (uint32_t i = 0; i < pages.size(); i += 1) {
+		if (p_other.pages[i] == nullptr) {
+			pages[i] = nullptr;
+		} else {
+			pages[i] = memnew_arr(uint32_t, PAGE_SIZE);
+			memcpy(pages[i], p_other.pages[i], sizeof(uint32_t) * PAGE_SIZE);
+		}
+	}
+	return *this;
+}
+
+PagedSparseIndex::~PagedSparseIndex() {
+	release_forks(forks.size());
+	reset();
+}
+
+void PagedSparseIndex::set(uint32_t p_index, uint32_t p_value) {
+	ERR_FAIL_COND_MSG(p_value == NONE, "The value `NONE` can't be stored, use `erase`.");
+
+	const uint32_t page = p_index >> PAGE_SHIFT;
+	if (page >= pages.size()) {
+		resize_pages(page + 1);
+	}
+	if (unlikely(forks.size() > 0)) {
+		fork_save_page(page);
+	}
+
+	if (pages[page] == nullptr) {
+		pages[page] = memnew_arr(uint32_t, PAGE_SIZE);
+		for (uint32_t i = 0; i < PAGE_SIZE; i += 1) {
+			pages[page][i] = NONE;
+		}
+	}
+
+	uint32_t &slot = pages[page][p_index & PAGE_MASK];
+	if (slot == NONE) {
+		pages_used[page] += 1;
+	}
+	slot = p_value;
+}
+
+void PagedSparseIndex::erase(uint32_t p_index, bool p_release_empty_page) {
+	const uint32_t page = p_index >> PAGE_SHIFT;
+	if (page >= pages.size() || pages[page] == nullptr) {
+		// Nothing to do.
+		return;
+	}
+
+	uint32_t &slot = pages[page][p_index & PAGE_MASK];
+	if (slot == NONE) {
+		// Nothing to do.
+		return;
+	}
+	if (unlikely(forks.size() > 0)) {
+		fork_save_page(page);
+	}
+	slot = NONE;
+	pages_used[page] -= 1;
+
+	if (pages_used[page] == 0 && p_release_empty_page) {
+		// The page is empty, release it.
+		memdelete_arr(pages[page]);
+		pages[page] = nullptr;
+	}
+}
+
+uint32_t PagedSparseIndex::get_pages_count() const {
+	uint32_t count = 0;
+	for (uint32_t i = 0; i < pages.size(); i += 1) {
+		if (pages[i] != nullptr) {
+			count += 1;
+		}
+	}
+	return count;
+}
+
+void PagedSparseIndex::reset() {
+	for (uint32_t i = 0; i < pages.size(); i += 1) {
+		if (pages[i] != nullptr) {
+			if (unlikely(forks.size() > 0)) {
+				fork_save_page(i);
+			}
+			memdelete_arr(pages[i]);
+		}
+	}
+	pages.reset();
+	pages_used.reset();
+	pages_fork_epoch.reset();
+}
+
+void PagedSparseIndex::reserve(uint32_t p_size) {
+	const uint32_t pages_count = (p_size + PAGE_MASK) >> PAGE_SHIFT;
+	pages.reserve(pages_count);
+	pages_used.reserve(pages_count);
+}
+
+void PagedSparseIndex::fork() {
+	forks.push_back(LocalVector<ForkPage>());
+	fork_epoch += 1;
+}
+
+void PagedSparseIndex::restore_fork(uint32_t p_fork) {
+	ERR_FAIL_UNSIGNED_INDEX_MSG(p_fork, forks.size(), "The fork " + itos(p_fork) + " doesn't exist.");
+
+	// Undo the forks from the newest, so each page ends up as it was when the
+	// fork `p_fork` was taken.
+	for (int64_t f = int64_t(forks.size()) - 1; f >= int64_t(p_fork); f -= 1) {
+		// A page can be saved twice by a fork, if `reset` dropped its stamp:
+		// the first save is the right one, so it's restored last.
+		LocalVector<ForkPage> &saved_pages = forks[f];
+		for (int64_t i = int64_t(saved_pages.size()) - 1; i >= 0; i -= 1) {
+			ForkPage &saved = saved_pages[i];
+			if (saved.page >= pages.size()) {
+				resize_pages(saved.page + 1);
+			}
+			if (pages[saved.page] != nullptr) {
+				memdelete_arr(pages[saved.page]);
+			}
+			// The saved page is moved back, no need to copy it.
+			pages[saved.page] = saved.values;
+			pages_used[saved.page] = saved.used;
+		}
+		saved_pages.clear();
+	}
+	forks.resize(p_fork + 1);
+
+	// The pages saved so far belong to the dropped forks.
+	fork_epoch += 1;
+}
+
+void PagedSparseIndex::release_forks(uint32_t p_count) {
+	p_count = MIN(p_count, forks.size());
+	for (uint32_t f = 0; f < p_count; f += 1) {
+		for (uint32_t i = 0; i < forks[f].size(); i += 1) {
+			if (forks[f][i].values != nullptr) {
+				memdelete_arr(forks[f][i].values);
+			}
+		}
+	}
+	for (uint32_t f = p_count; f < forks.size(); f += 1) {
+		SWAP(forks[f - p_count], forks[f]);
+	}
+	forks.resize(forks.size() - p_count);
+}
+
+void PagedSparseIndex::resize_pages(uint32_t p_pages_count) {
+	const uint32_t initial_size = pages.size();
+	pages.resize(p_pages_count);
+	pages_used.resize(p_pages_count);
+	pages_fork_epoch.resize(p_pages_count);
+	for (uint32_t i = initial_size; i < p_pages_count; i += 1) {
+		pages[i] = nullptr;
+		pages_used[i] = 0;
+		pages_fork_epoch[i] = 0;
+	}
+}
+
+void PagedSparseIndex::fork_save_page(uint32_t p_page) {
+	if (p_page >= pages.size()) {
+		resize_pages(p_page + 1);
+	}
+	if (pages_fork_epoch[p_page] == fork_epoch) {
+		// Already saved by the current fork.
+		return;
+	}
+	pages_fork_epoch[p_page] = fork_epoch;
+
+	ForkPage saved;
+	saved.page = p_page;
+	saved.used = pages_used[p_page];
+	saved.values = nullptr;
+	if (pages[p_page] != nullptr) {
+		saved.values = memnew_arr(uint32_t, PAGE_SIZE);
+		memcpy(saved.values, pages[p_page], sizeof(uint32_t) * PAGE_SIZE);
+	}
+	forks[forks.size() - 1].push_back(saved);
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "core/string/ustring.h"
+#include "core/templates/local_vector.h"
+
+/// Sparse vector that maps an `Entity` index to a `uint32_t`, used by the
+/// storages to find the data of an `Entity`.
+///
+/// The indices are grouped in pages of `PAGE_SIZE`: only the pages that hold
+/// at least one value are allocated. So, a storage that holds few components
+/// for high `Entity` indices doesn't need to allocate a slot for each lower
+/// index. The lookup is still O(1): just one more indirection.
+///
+/// A page is released as soon as it becomes empty, unless the erase is part
+/// of a clear: the containers that are cleared each frame keep their pages,
+/// to not reallocate them.
+///
+/// The index can be forked, see `fork`: the pages are copied only when
+/// written after the fork.
+class PagedSparseIndex {
+public:
+	static constexpr uint32_t PAGE_SHIFT = 10;
+	static constexpr uint32_t PAGE_SIZE = 1 << PAGE_SHIFT;
+	static constexpr uint32_t PAGE_MASK = PAGE_SIZE - 1;
+	static constexpr uint32_t NONE = UINT32_MAX;
+
+private:
+	/// Page -> `PAGE_SIZE` values; `nullptr` when the page is empty.
+	LocalVector<uint32_t *> pages;
+	/// Page -> count of values stored in the page.
+	LocalVector<uint32_t> pages_used;
+
+	/// A page as it was when the fork was taken.
+	struct ForkPage {
+		uint32_t page;
+		uint32_t used;
+		/// `nullptr` when the page was not allocated.
+		uint32_t *values;
+	};
+
+	/// The pages saved by each fork, the oldest first: each fork holds the
+	/// pages written between it and the next fork.
+	LocalVector<LocalVector<ForkPage>> forks;
+	/// Page -> the `fork_epoch` when the page was last saved.
+	LocalVector<uint32_t> pages_fork_epoch;
+	/// Changes each time a fork is taken or restored.
+	uint32_t fork_epoch = 0;
+
+public:
+	PagedSparseIndex() = default;
+	PagedSparseIndex(const PagedSparseIndex &p_other);
+	PagedSparseIndex &operator=(const PagedSparseIndex &p_other);
+	~PagedSparseIndex();
+
+	/// Returns `NONE` when nothing is stored for this index.
+	_FORCE_INLINE_ uint32_t get(uint32_t p_index) const {
+		const uint32_t page = p_index >> PAGE_SHIFT;
+		if (page < pages.size() && pages[page] != nullptr) {
+			return pages[page][p_index & PAGE_MASK];
+		}
+		return NONE;
+	}
+
+	_FORCE_INLINE_ bool has(uint32_t p_index) const {
+		return get(p_index) != NONE;
+	}
+
+	/// Stores the value, `p_value` can't be `NONE`: use `erase`.
+	void set(uint32_t p_index, uint32_t p_value);
+
+	/// Sets the value of an index that is already stored: it never allocates.
+	_FORCE_INLINE_ void update(uint32_t p_index, uint32_t p_value) {
+#ifdef DEBUG_ENABLED
+		CRASH_COND_MSG(has(p_index) == false, "The index " + itos(p_index) + " is not stored, use `set`.");
+#endif
+		const uint32_t page = p_index >> PAGE_SHIFT;
+		if (unlikely(forks.size() > 0)) {
+			fork_save_page(page);
+		}
+		pages[page][p_index & PAGE_MASK] = p_value;
+	}
+
+	/// Removes the value. The page is released when it becomes empty, unless
+	/// `p_release_empty_page` is `false`: the containers that are cleared and
+	/// filled again each frame keep the pages, so they are not reallocated.
+	void erase(uint32_t p_index, bool p_release_empty_page = true);
+
+	/// Returns the number of allocated pages.
+	uint32_t get_pages_count() const;
+
+	/// Release the memory completely.
+	void reset();
+
+	/// Preallocate the page directory, so to fit `p_size` indices.
+	void reserve(uint32_t p_size);
+
+	/// Takes a new fork: from now on, each page is saved the first time it's
+	/// written, so `restore_fork` can bring back the current state.
+	void fork();
+
+	/// Restores the state of the fork `p_fork`, where `0` is the oldest fork.
+	/// The newer forks are dropped, while `p_fork` is kept.
+	void restore_fork(uint32_t p_fork);
+
+	/// Drops the `p_count` oldest forks.
+	void release_forks(uint32_t p_count);
+
+	uint32_t get_forks_count() const {
+		return forks.size();
+	}
+
+private:
+	void resize_pages(uint32_t p_pages_count);
+	void fork_save_page(uint32_t p_page);
+};
@@ -65,6 +65,21 @@ public:
 		ERR_PRINT("The SID is not poiting to any valid object. This is not supposed to happen.");
 	}
 
+	virtual void insert_from_prototype(EntityID p_prototype, const EntityID *p_entities, uint32_t p_count) override {
+		ERR_FAIL_COND_MSG(storage.has(p_prototype) == false, "The prototype Entity " + itos(p_prototype) + " doesn't have this component.");
+		// The `Entities` share the same component of the prototype.
+		const godex::SID sid = storage.get(p_prototype);
+		storage.reserve(p_count);
+		for (uint32_t i = 0; i < p_count; i += 1) {
+			if (storage.has(p_entities[i])) {
+				storage.get(p_entities[i]) = sid;
+			} else {
+				storage.insert(p_entities[i], sid);
+			}
+		}
+		StorageBase::notify_changed_batch(p_entities, p_count);
+	}
+
 	virtual T *get_shared_component(godex::SID p_id) override {
 		if (p_id < allocated_pointers.size()) {
 			if (allocated_pointers[p_id] != nullptr) {
@@ -118,6 +133,7 @@ public:
 		allocator.reset();
 		allocated_pointers.reset();
 		storage.clear();
+		StorageBase::notify_cleared();
 		StorageBase::flush_changed();
 	}
 
@@ -0,0 +1,97 @@
+#include "snapshot.h"
+
+#include "core/io/marshalls.h"
+
+void SnapshotWriter::write_raw(const void *p_data, uint32_t p_size) {
+	if (p_size == 0) {
+		return;
+	}
+	const uint32_t offset = buffer.size();
+	buffer.resize(offset + p_size);
+	memcpy(buffer.ptr() + offset, p_data, p_size);
+}
+
+void SnapshotWriter::write_u32(uint32_t p_value) {
+	write_raw(&p_value, sizeof(uint32_t));
+}
+
+void SnapshotWriter::write_string(const String &p_string) {
+	const CharString utf8 = p_string.utf8();
+	write_u32(utf8.length());
+	write_raw(utf8.get_data(), utf8.length());
+}
+
+void SnapshotWriter::write_variant(const Variant &p_variant) {
+	int len = 0;
+	Error err = encode_variant(p_variant, nullptr, len, false);
+	ERR_FAIL_COND_MSG(err != OK, "This Variant can't be stored into the snapshot.");
+
+	write_u32(len);
+	const uint32_t offset = buffer.size();
+	buffer.resize(offset + len);
+	encode_variant(p_variant, buffer.ptr() + offset, len, false);
+}
+
+void SnapshotWriter::patch_u32(uint32_t p_position, uint32_t p_value) {
+	ERR_FAIL_COND(p_position + sizeof(uint32_t) > buffer.size());
+	memcpy(buffer.ptr() + p_position, &p_value, sizeof(uint32_t));
+}
+
+const uint8_t *SnapshotReader::read_raw(uint32_t p_size) {
+	if (p_size > size - position) {
+		return nullptr;
+	}
+	const uint8_t *ptr = data + position;
+	position += p_size;
+	return ptr;
+}
+
+const uint8_t *SnapshotReader::read_array(uint32_t p_count, uint32_t p_element_size) {
+	if (p_element_size != 0 && p_count > get_remaining() / p_element_size) {
+		return nullptr;
+	}
+	return read_raw(p_count * p_element_size);
+}
+
+bool SnapshotReader::read_u32(uint32_t &r_value) {
+	const uint8_t *ptr = read_raw(sizeof(uint32_t));
+	if (ptr == nullptr) {
+		return false;
+	}
+	memcpy(&r_value, ptr, sizeof(uint32_t));
+	return true;
+}
+
+bool SnapshotReader::read_string(String &r_string) {
+	uint32_t len;
+	if (read_u32(len) == false) {
+		return false;
+	}
+	const uint8_t *ptr = read_raw(len);
+	if (ptr == nullptr) {
+		return false;
+	}
+	r_string.parse_utf8((const char *)ptr, len);
+	return true;
+}
+
+bool SnapshotReader::read_variant(Variant &r_variant) {
+	uint32_t len;
+	if (read_u32(len) == false) {
+		return false;
+	}
+	const uint8_t *ptr = read_raw(len);
+	if (ptr == nullptr) {
+		return false;
+	}
+	return decode_variant(r_variant, ptr, len, nullptr, false) == OK;
+}
+
+bool SnapshotReader::read_section(uint32_t p_size, SnapshotReader &r_section) {
+	const uint8_t *ptr = read_raw(p_size);
+	if (ptr == nullptr) {
+		return false;
+	}
+	r_section = SnapshotReader(ptr, p_size);
+	return true;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "core/string/ustring.h"
+#include "core/templates/local_vector.h"
+#include "core/variant/variant.h"
+#include <type_traits>
+
+/// The formats of the storage sections into the `World` snapshot.
+enum SnapshotFormat {
+	/// Each component is stored as a `Dictionary` of its properties.
+	SNAPSHOT_FORMAT_VARIANT = 0,
+	/// The components array is stored as is, see `snapshot_raw_layout`.
+	SNAPSHOT_FORMAT_RAW = 1,
+	/// Each `Entity` stores its batch size, then each component of the batch
+	/// as a `Dictionary` of its properties.
+	SNAPSHOT_FORMAT_BATCH = 2,
+};
+
+/// Tells if the component `T` can be stored into a `World` snapshot using its
+/// raw memory layout: the storages that support it (like the
+/// `DenseVectorStorage`) write the components array as is, and copy it back
+/// with a single `memcpy` on load.
+///
+/// It's `false` by default, because a trivially copyable component can still
+/// hold pointers or engine handles (like `RID`s), that are meaningless once
+/// the process restarts. Use `SNAPSHOT_RAW_LAYOUT` to opt in.
+template <class T>
+struct snapshot_raw_layout {
+	static constexpr bool value = false;
+};
+
+/// Stores the component with its raw memory layout into the `World` snapshots.
+/// Use this, outside of the component definition, only when the component is
+/// plain data:
+/// ```
+/// SNAPSHOT_RAW_LAYOUT(MyComponent)
+/// ```
+#define SNAPSHOT_RAW_LAYOUT(m_class)                                                                              \
+	template <>                                                                                                   \
+	struct snapshot_raw_layout<m_class> {                                                                         \
+		static_assert(std::is_trivially_copyable<m_class>::value, "The component must be trivially copyable."); \
+		static constexpr bool value = true;                                                                       \
+	};
+
+/// Appends the snapshot data to a byte buffer. The data is written with the
+/// native endianness: a snapshot is meant to be loaded by the same build.
+class SnapshotWriter {
+	LocalVector<uint8_t> &buffer;
+
+public:
+	SnapshotWriter(LocalVector<uint8_t> &r_buffer) :
+			buffer(r_buffer) {}
+
+	uint32_t get_position() const { return buffer.size(); }
+
+	void write_raw(const void *p_data, uint32_t p_size);
+	void write_u32(uint32_t p_value);
+	void write_string(const String &p_string);
+	void write_variant(const Variant &p_variant);
+
+	/// Overwrites an `uint32_t`, already written at `p_position`.
+	void patch_u32(uint32_t p_position, uint32_t p_value);
+};
+
+/// Reads the snapshot data from a byte buffer, that must outlive the reader.
+/// All the functions return `false` (or `nullptr`) when the buffer is too
+/// short, so a truncated snapshot is never read out of bounds.
+class SnapshotReader {
+	const uint8_t *data = nullptr;
+	uint32_t size = 0;
+	uint32_t position = 0;
+
+public:
+	SnapshotReader(const uint8_t *p_data, uint32_t p_size) :
+			data(p_data), size(p_size) {}
+
+	uint32_t get_remaining() const { return size - position; }
+
+	/// Returns the pointer to the next `p_size` bytes and skips them.
+	const uint8_t *read_raw(uint32_t p_size);
+	/// Same as `read_raw`, for `p_count` elements of `p_element_size` bytes. The
+	/// count is checked before multiplying, so it can't overflow.
+	const uint8_t *read_array(uint32_t p_count, uint32_t p_element_size);
+	bool read_u32(uint32_t &r_value);
+	bool read_string(String &r_string);
+	bool read_variant(Variant &r_variant);
+
+	/// Returns a reader for the next `p_size` bytes and skips them.
+	bool read_section(uint32_t p_size, SnapshotReader &r_section);
+};
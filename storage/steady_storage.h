@@ -67,10 +67,18 @@ public:
 	virtual void clear() override {
 		allocator.reset();
 		storage.clear();
+		StorageBase::notify_cleared();
 		StorageBase::flush_changed();
 	}
 
 	virtual EntitiesBuffer get_stored_entities() const {
 		return { storage.get_entities().size(), storage.get_entities().ptr() };
 	}
+
+	/// Not forkable: the components usually own objects of other libraries
+	/// that the snapshot doesn't keep, and restoring it would move the
+	/// components in memory.
+	virtual bool is_forkable() const override {
+		return false;
+	}
 };
@@ -0,0 +1,66 @@
+#include "storage.h"
+
+#include "../ecs.h"
+
+void StorageBase::save_snapshot(SnapshotWriter &p_writer, uint32_t p_component_id) const {
+	const EntitiesBuffer entities = get_stored_entities();
+
+	p_writer.write_u32(SNAPSHOT_FORMAT_VARIANT);
+	p_writer.write_u32(entities.count);
+
+	List<PropertyInfo> properties;
+	for (uint32_t i = 0; i < entities.count; i += 1) {
+		const void *component = get_ptr(entities.entities[i]);
+
+		properties.clear();
+		ECS::unsafe_component_get_property_list(p_component_id, const_cast<void *>(component), &properties);
+
+		Dictionary data;
+		for (const PropertyInfo &property : properties) {
+			data[property.name] = ECS::unsafe_component_get_by_name(p_component_id, component, property.name);
+		}
+
+		p_writer.write_u32(entities.entities[i].get_raw_id());
+		p_writer.write_variant(data);
+	}
+}
+
+bool StorageBase::load_snapshot(SnapshotReader &p_reader, uint32_t p_component_id) {
+	uint32_t format;
+	uint32_t count;
+	ERR_FAIL_COND_V(p_reader.read_u32(format) == false || format != SNAPSHOT_FORMAT_VARIANT, false);
+	ERR_FAIL_COND_V(p_reader.read_u32(count) == false, false);
+
+	for (uint32_t i = 0; i < count; i += 1) {
+		uint32_t entity;
+		Variant data;
+		ERR_FAIL_COND_V(p_reader.read_u32(entity) == false, false);
+		ERR_FAIL_COND_V(p_reader.read_variant(data) == false || data.get_type() != Variant::DICTIONARY, false);
+		insert_dynamic(entity, data);
+	}
+	return true;
+}
+
+void StorageBase::fork(uint32_t p_component_id) {
+	ERR_FAIL_COND_MSG(is_forkable() == false, "The storage " + get_type_name() + " can't be forked: its state can't be restored.");
+	fork_snapshots.resize(fork_snapshots.size() + 1);
+	SnapshotWriter writer(fork_snapshots[fork_snapshots.size() - 1]);
+	save_snapshot(writer, p_component_id);
+}
+
+void StorageBase::restore_fork(uint32_t p_fork, uint32_t p_component_id) {
+	ERR_FAIL_UNSIGNED_INDEX_MSG(p_fork, fork_snapshots.size(), "The fork " + itos(p_fork) + " doesn't exist.");
+
+	clear();
+	const LocalVector<uint8_t> &snapshot = fork_snapshots[p_fork];
+	SnapshotReader reader(snapshot.ptr(), snapshot.size());
+	ERR_FAIL_COND_MSG(load_snapshot(reader, p_component_id) == false, "The fork " + itos(p_fork) + " of the storage " + get_type_name() + " is corrupted.");
+	fork_snapshots.resize(p_fork + 1);
+}
+
+void StorageBase::release_forks(uint32_t p_count) {
+	p_count = MIN(p_count, fork_snapshots.size());
+	for (uint32_t i = 0; i < p_count; i += 1) {
+		fork_snapshots.remove_at(0);
+	}
+}
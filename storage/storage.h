@@ -1,6 +1,9 @@
 #pragma once
 
+#include "../utils/thread_pool.h"
+#include "change_ticks.h"
 #include "entity_list.h"
+#include "snapshot.h"
 
 /// Some stroages support `Entity` nesting, you can get local or global space
 /// data, by specifying one or the other.
@@ -17,9 +20,38 @@ struct EntitiesBuffer {
 			count(c), entities(e) {}
 };
 
+/// Collects the changes of a storage until they are consumed: unlike the
+/// change listeners, that are flushed at the end of each frame, the recorded
+/// `Entities` are kept until the recorder is cleared.
+struct ChangeRecorder {
+	/// The `Entities` that changed or got the component.
+	EntityList changed;
+	/// The `Entities` that lost the component.
+	EntityList removed;
+	/// Set when the storage is cleared: all its `Entities` lost the component.
+	bool cleared = false;
+
+	void clear() {
+		changed.clear();
+		removed.clear();
+		cleared = false;
+	}
+};
+
 /// Never override this directly. Always override the `Storage`.
 class StorageBase {
 	LocalVector<EntityList *> changed_listeners;
+	LocalVector<ChangeRecorder *> change_recorders;
+	/// Used by the `Changed` filter to know which `Entities` changed.
+	ChangeTicks change_ticks;
+
+	/// While many threads are writing this storage at the same time, the
+	/// changes are buffered per thread and merged by `end_parallel_changes`.
+	LocalVector<LocalVector<EntityID>> parallel_changes;
+	bool parallel_changes_in_progress = false;
+
+	/// Used by the default `fork`: a snapshot for each fork, the oldest first.
+	LocalVector<LocalVector<uint8_t>> fork_snapshots;
 
 public:
 	/// This function is called each time this storage is initialized.
@@ -41,6 +73,10 @@ public:
 		return false;
 	}
 
+	/// The storages are indexed by the `Entity` index: `has`, `get` and
+	/// `remove` don't check the generation, so a stale `EntityID` whose index
+	/// was reused accesses the new `Entity`. Use `World::is_entity_alive` to
+	/// validate the `EntityID`s kept across frames.
 	virtual bool has(EntityID p_entity) const {
 		CRASH_NOW_MSG("Override this function.");
 		return false;
@@ -74,6 +110,59 @@ public:
 		return { 0, nullptr };
 	}
 
+	/// Removes the component from all the passed `Entities`, the `Entities`
+	/// that don't have this component are skipped.
+	virtual void remove_batch(const EntityID *p_entities, uint32_t p_count) {
+		for (uint32_t i = 0; i < p_count; i += 1) {
+			if (has(p_entities[i])) {
+				remove(p_entities[i]);
+			}
+		}
+	}
+
+	/// Inserts `*p_data[i]` to `p_entities[i]`, for all the `p_count` passed
+	/// `Entities`. Each `p_data[i]` points to a component of the type stored
+	/// by this storage, like the ones returned by `ECS::new_component`.
+	virtual void insert_batch_ptr(const EntityID *p_entities, uint32_t p_count, const void *const *p_data) {
+		ERR_FAIL_MSG("The storage " + get_type_name() + " can't insert the components in batch.");
+	}
+
+	/// Adds to all the passed `Entities` a copy of the component that
+	/// `p_prototype` has. `Storage` implements it by copying the component,
+	/// a storage that can't copy its components refuses it.
+	virtual void insert_from_prototype(EntityID p_prototype, const EntityID *p_entities, uint32_t p_count) {
+		ERR_FAIL_MSG("The storage " + get_type_name() + " can't copy the component of the prototype Entity " + itos(p_prototype) + ".");
+	}
+
+	/// Writes all the stored components into the `World` snapshot.
+	/// By default each component is stored as a `Dictionary` of its
+	/// properties: override this to store the data in a more compact way.
+	virtual void save_snapshot(SnapshotWriter &p_writer, uint32_t p_component_id) const;
+
+	/// Inserts the components stored by `save_snapshot`. Returns `false` if the
+	/// data is malformed.
+	virtual bool load_snapshot(SnapshotReader &p_reader, uint32_t p_component_id);
+
+	/// Returns `true` when `fork` and `restore_fork` bring back the whole state
+	/// of this storage. The default `fork` goes through the snapshot, that
+	/// keeps only the component properties: a storage opts in only once its
+	/// snapshot round trips, otherwise the `World` refuses to fork.
+	virtual bool is_forkable() const {
+		return false;
+	}
+
+	/// Takes a new fork of the storage, so `restore_fork` can bring back the
+	/// current state. By default the whole storage is copied into a snapshot:
+	/// override this to copy only the data written after the fork.
+	virtual void fork(uint32_t p_component_id);
+
+	/// Restores the state of the fork `p_fork`, where `0` is the oldest fork.
+	/// The newer forks are dropped, while `p_fork` is kept.
+	virtual void restore_fork(uint32_t p_fork, uint32_t p_component_id);
+
+	/// Drops the `p_count` oldest forks.
+	virtual void release_forks(uint32_t p_count);
+
 	/// This function is called by the pipeline only at the end of the stage.
 	/// It's always called in single thread and the Storage is not used by anyone.
 	/// During this stage is also possible to safely operate on other Storages.
@@ -82,7 +171,46 @@ public:
 	/// returns `true`.
 	virtual void on_system_release() {}
 
+	/// Returns `false` if many `Entities` can share the same component, so it's
+	/// not safe to mutate the components from many threads at the same time.
+	virtual bool is_parallel_write_safe() const {
+		return true;
+	}
+
+protected:
+	/// Called by `end_parallel_changes`, in single thread, for each `Entity`
+	/// changed while the storage was written by many threads.
+	virtual void on_parallel_changed(EntityID p_entity) {}
+
 public:
+	/// From now on, the changes are buffered per thread: `notify_changed` can be
+	/// called by `p_threads_count` threads at the same time, each identified by
+	/// `ThreadPool::get_thread_index()`.
+	void begin_parallel_changes(uint32_t p_threads_count) {
+		CRASH_COND_MSG(parallel_changes_in_progress, "The parallel changes are already in progress.");
+		if (parallel_changes.size() < p_threads_count) {
+			parallel_changes.resize(p_threads_count);
+		}
+		parallel_changes_in_progress = true;
+	}
+
+	/// Merges the changes buffered by each thread, in thread order.
+	void end_parallel_changes() {
+		CRASH_COND_MSG(parallel_changes_in_progress == false, "The parallel changes are not in progress.");
+		parallel_changes_in_progress = false;
+		for (uint32_t t = 0; t < parallel_changes.size(); t += 1) {
+			for (uint32_t i = 0; i < parallel_changes[t].size(); i += 1) {
+				notify_changed(parallel_changes[t][i]);
+				on_parallel_changed(parallel_changes[t][i]);
+			}
+			parallel_changes[t].clear();
+		}
+	}
+
+	bool is_parallel_changes_in_progress() const {
+		return parallel_changes_in_progress;
+	}
+
 	void add_change_listener(EntityList *p_changed_listener) {
 		if (changed_listeners.find(p_changed_listener) == -1) {
 			changed_listeners.push_back(p_changed_listener);
@@ -96,24 +224,113 @@ public:
 		}
 	}
 
+	void add_change_recorder(ChangeRecorder *p_recorder) {
+		if (change_recorders.find(p_recorder) == -1) {
+			change_recorders.push_back(p_recorder);
+		}
+	}
+
+	void remove_change_recorder(ChangeRecorder *p_recorder) {
+		const int64_t index = change_recorders.find(p_recorder);
+		if (index != -1) {
+			change_recorders.remove_at_unordered(index);
+		}
+	}
+
 	void notify_changed(EntityID p_entity) {
+		if (unlikely(parallel_changes_in_progress)) {
+#ifdef DEBUG_ENABLED
+			CRASH_COND_MSG(ThreadPool::get_thread_index() >= parallel_changes.size(), "This thread is not allowed to write this storage.");
+#endif
+			parallel_changes[ThreadPool::get_thread_index()].push_back(p_entity);
+			return;
+		}
+		change_ticks.mark_changed(p_entity);
 		for (uint32_t i = 0; i < changed_listeners.size(); i += 1) {
 			changed_listeners[i]->insert(p_entity);
 		}
+		for (uint32_t i = 0; i < change_recorders.size(); i += 1) {
+			change_recorders[i]->changed.insert(p_entity);
+			change_recorders[i]->removed.remove(p_entity);
+		}
+	}
+
+	/// Same as `notify_changed`, but notifies many `Entities` in one pass.
+	void notify_changed_batch(const EntityID *p_entities, uint32_t p_count) {
+		if (unlikely(parallel_changes_in_progress)) {
+			for (uint32_t i = 0; i < p_count; i += 1) {
+				notify_changed(p_entities[i]);
+			}
+			return;
+		}
+		for (uint32_t i = 0; i < p_count; i += 1) {
+			change_ticks.mark_changed(p_entities[i]);
+		}
+		for (uint32_t l = 0; l < changed_listeners.size(); l += 1) {
+			for (uint32_t i = 0; i < p_count; i += 1) {
+				changed_listeners[l]->insert(p_entities[i]);
+			}
+		}
+		for (uint32_t r = 0; r < change_recorders.size(); r += 1) {
+			for (uint32_t i = 0; i < p_count; i += 1) {
+				change_recorders[r]->changed.insert(p_entities[i]);
+				change_recorders[r]->removed.remove(p_entities[i]);
+			}
+		}
 	}
 
+	/// Called when the component is removed from the `Entity`.
 	void notify_updated(EntityID p_entity) {
+		change_ticks.mark_updated(p_entity);
 		for (uint32_t i = 0; i < changed_listeners.size(); i += 1) {
 			changed_listeners[i]->remove(p_entity);
 		}
+		for (uint32_t i = 0; i < change_recorders.size(); i += 1) {
+			change_recorders[i]->changed.remove(p_entity);
+			change_recorders[i]->removed.insert(p_entity);
+		}
+	}
+
+	/// Called after `restore_fork`: the `Entities` that still have the
+	/// component are notified as changed, the others as removed.
+	void notify_restored(const EntityID *p_entities, uint32_t p_count) {
+		LocalVector<EntityID> changed;
+		changed.reserve(p_count);
+		for (uint32_t i = 0; i < p_count; i += 1) {
+			if (has(p_entities[i])) {
+				changed.push_back(p_entities[i]);
+			} else {
+				notify_updated(p_entities[i]);
+			}
+		}
+		notify_changed_batch(changed.ptr(), changed.size());
+	}
+
+	/// Called when the storage is cleared, together with `flush_changed`.
+	void notify_cleared() {
+		for (uint32_t i = 0; i < change_recorders.size(); i += 1) {
+			change_recorders[i]->clear();
+			change_recorders[i]->cleared = true;
+		}
 	}
 
 	void flush_changed() {
+		change_ticks.flush();
 		for (uint32_t i = 0; i < changed_listeners.size(); i += 1) {
 			changed_listeners[i]->clear();
 		}
 	}
 
+	const ChangeTicks &get_change_ticks() const {
+		return change_ticks;
+	}
+
+	/// Returns a tick that covers all the changes notified so far: the changes
+	/// notified from now on have a greater tick. Safe to call from many threads.
+	ChangeTick advance_change_tick() {
+		return change_ticks.advance();
+	}
+
 public:
 	/// This method is used by the `DataAccessor` to expose the `Storage` to
 	/// GDScript.
@@ -222,6 +439,38 @@ public:
 		return nullptr;
 	}
 
+	/// Inserts `p_data[i]` to `p_entities[i]`, for all the `p_count` passed
+	/// `Entities`. Override this to reserve the memory only once.
+	virtual void insert_batch(const EntityID *p_entities, uint32_t p_count, const T *p_data) {
+		for (uint32_t i = 0; i < p_count; i += 1) {
+			insert(p_entities[i], p_data[i]);
+		}
+	}
+
+	/// Inserts a copy of `p_data` to all the `p_count` passed `Entities`.
+	/// Override this to reserve the memory only once.
+	virtual void insert_batch(const EntityID *p_entities, uint32_t p_count, const T &p_data) {
+		for (uint32_t i = 0; i < p_count; i += 1) {
+			insert(p_entities[i], p_data);
+		}
+	}
+
+	virtual void insert_batch_ptr(const EntityID *p_entities, uint32_t p_count, const void *const *p_data) override {
+		LocalVector<T> data;
+		data.reserve(p_count);
+		for (uint32_t i = 0; i < p_count; i += 1) {
+			data.push_back(*static_cast<const T *>(p_data[i]));
+		}
+		insert_batch(p_entities, p_count, data.ptr());
+	}
+
+	virtual void insert_from_prototype(EntityID p_prototype, const EntityID *p_entities, uint32_t p_count) override {
+		ERR_FAIL_COND_MSG(has(p_prototype) == false, "The prototype Entity " + itos(p_prototype) + " doesn't have this component.");
+		// Copy the data, so it stays valid even if the storage memory moves.
+		const T data = *static_cast<const Storage<T> *>(this)->get(p_prototype);
+		insert_batch(p_entities, p_count, data);
+	}
+
 	/// Must be overridden if this storage is storing in batch.
 	virtual uint32_t get_batch_size(EntityID p_entity) const {
 		return 1;
@@ -290,6 +539,11 @@ public:
 
 public:
 	// Override Storage<T>
+	virtual bool is_parallel_write_safe() const override {
+		// The same component can be fetched by many entities.
+		return false;
+	}
+
 	virtual void insert(EntityID, const T &) override final {
 		ERR_PRINT("This component is stored inside a SharedStorage, so you can't just insert the data using the normal `insert` function. Check the documentation.");
 	}
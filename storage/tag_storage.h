@@ -0,0 +1,223 @@
+#pragma once
+
+#include "../ecs.h"
+#include "core/os/mutex.h"
+#include "core/templates/local_vector.h"
+#include "snapshot.h"
+#include "storage.h"
+#include <atomic>
+#include <type_traits>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/// Returns the index of the lowest set bit, `p_bits` can't be `0`.
+_FORCE_INLINE_ uint32_t tag_lowest_bit(uint64_t p_bits) {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward64(&index, p_bits);
+	return index;
+#else
+	return __builtin_ctzll(p_bits);
+#endif
+}
+
+/// Storage for the tag components: the components without data, like
+/// `Disabled`, that only mark an `Entity`.
+///
+/// Each tag is a bit, indexed by the `Entity` index: adding, removing and
+/// checking a tag is a bit operation, that never moves memory. The list of the
+/// tagged `Entities`, used to iterate them, is built only when requested, and
+/// only once after the tags change.
+///
+/// Two tag storages can be intersected a word at a time, see `intersect`: the
+/// `Query` uses it when it fetches more than one tag.
+template <class T>
+class TagStorage : public Storage<T> {
+	static_assert(std::is_empty<T>::value, "The `TagStorage` can store only components without data.");
+
+public:
+	static constexpr uint32_t WORD_SHIFT = 6;
+	static constexpr uint32_t WORD_MASK = (1 << WORD_SHIFT) - 1;
+
+protected:
+	/// The bit `i` is set when the `Entity` with index `i` has the tag.
+	LocalVector<uint64_t> words;
+	/// `Entity` index -> the generation of the tagged `Entity`.
+	LocalVector<uint8_t> generations;
+	/// All the tags point to this component, since it has no data.
+	T tag;
+
+	/// The tagged `Entities` sorted by index, built by `get_stored_entities`.
+	mutable LocalVector<EntityID> entities;
+	mutable std::atomic<bool> entities_dirty{ false };
+	/// Guards the build of `entities`, since many systems can read the
+	/// storage at the same time.
+	mutable Mutex entities_mutex;
+
+	static_assert(EntityID::GENERATION_MASK <= UINT8_MAX, "The generation doesn't fit into `generations`.");
+
+public:
+	virtual void configure(const Dictionary &p_config) override {
+		clear();
+		const uint32_t pre_allocate = p_config.get("pre_allocate", 500);
+		words.reserve((pre_allocate + WORD_MASK) >> WORD_SHIFT);
+		generations.reserve(pre_allocate);
+	}
+
+	virtual String get_type_name() const override {
+		return "TagStorage[" + String(typeid(T).name()) + "]";
+	}
+
+	virtual void insert(EntityID p_entity, const T &p_data) override {
+		set_tag(p_entity);
+		StorageBase::notify_changed(p_entity);
+	}
+
+	virtual void insert_batch(const EntityID *p_entities, uint32_t p_count, const T *p_data) override {
+		for (uint32_t i = 0; i < p_count; i += 1) {
+			set_tag(p_entities[i]);
+		}
+		StorageBase::notify_changed_batch(p_entities, p_count);
+	}
+
+	virtual void insert_batch(const EntityID *p_entities, uint32_t p_count, const T &p_data) override {
+		for (uint32_t i = 0; i < p_count; i += 1) {
+			set_tag(p_entities[i]);
+		}
+		StorageBase::notify_changed_batch(p_entities, p_count);
+	}
+
+	virtual void insert_from_prototype(EntityID p_prototype, const EntityID *p_entities, uint32_t p_count) override {
+		ERR_FAIL_COND_MSG(has(p_prototype) == false, "The prototype Entity " + itos(p_prototype) + " doesn't have this component.");
+		insert_batch(p_entities, p_count, tag);
+	}
+
+	// These are `final` so the `Query`, that knows the storage type, can call
+	// them without virtual dispatch.
+	virtual bool has(EntityID p_entity) const override final {
+		const uint32_t word = p_entity.get_index() >> WORD_SHIFT;
+		return word < words.size() && ((words[word] >> (p_entity.get_index() & WORD_MASK)) & 1) != 0;
+	}
+
+	virtual T *get(EntityID p_entity, Space p_mode = Space::LOCAL) override final {
+#ifdef DEBUG_ENABLED
+		CRASH_COND_MSG(has(p_entity) == false, "This entity doesn't have anything stored into this storage.");
+#endif
+		StorageBase::notify_changed(p_entity);
+		return &tag;
+	}
+
+	virtual const T *get(EntityID p_entity, Space p_mode = Space::LOCAL) const override final {
+#ifdef DEBUG_ENABLED
+		CRASH_COND_MSG(has(p_entity) == false, "This entity doesn't have anything stored into this storage.");
+#endif
+		return &tag;
+	}
+
+	virtual void remove(EntityID p_entity) override {
+		ERR_FAIL_COND_MSG(has(p_entity) == false, "This entity doesn't have anything stored into this storage.");
+		words[p_entity.get_index() >> WORD_SHIFT] &= ~(uint64_t(1) << (p_entity.get_index() & WORD_MASK));
+		entities_dirty = true;
+		// Make sure to remove as changed.
+		StorageBase::notify_updated(p_entity);
+	}
+
+	virtual void clear() override {
+		words.clear();
+		entities.clear();
+		entities_dirty = false;
+		StorageBase::notify_cleared();
+		StorageBase::flush_changed();
+	}
+
+	virtual EntitiesBuffer get_stored_entities() const override {
+		if (entities_dirty.load(std::memory_order_acquire)) {
+			MutexLock lock(entities_mutex);
+			if (entities_dirty.load(std::memory_order_relaxed)) {
+				build_entities();
+			}
+		}
+		return { entities.size(), entities.ptr() };
+	}
+
+	/// The tags have no data, so the snapshot keeps the whole state.
+	virtual bool is_forkable() const override {
+		return true;
+	}
+
+	/// The tags are stored as the sorted `Entity` list.
+	virtual void save_snapshot(SnapshotWriter &p_writer, uint32_t p_component_id) const override {
+		const EntitiesBuffer stored = get_stored_entities();
+		p_writer.write_u32(SNAPSHOT_FORMAT_RAW);
+		p_writer.write_u32(stored.count);
+		p_writer.write_raw(stored.entities, sizeof(EntityID) * stored.count);
+	}
+
+	virtual bool load_snapshot(SnapshotReader &p_reader, uint32_t p_component_id) override {
+		uint32_t format;
+		uint32_t count;
+		ERR_FAIL_COND_V(p_reader.read_u32(format) == false || format != SNAPSHOT_FORMAT_RAW, false);
+		ERR_FAIL_COND_V(p_reader.read_u32(count) == false, false);
+		ERR_FAIL_COND_V_MSG(get_stored_entities().count != 0, false, "The storage must be empty to load the snapshot.");
+
+		const uint8_t *data = p_reader.read_array(count, sizeof(EntityID));
+		ERR_FAIL_COND_V(data == nullptr, false);
+		const EntityID *loaded = reinterpret_cast<const EntityID *>(data);
+
+		insert_batch(loaded, count, tag);
+		return true;
+	}
+
+	const LocalVector<uint64_t> &get_words() const {
+		return words;
+	}
+
+	/// Sets into `r_entities` the `Entities` that have both this tag and the
+	/// `p_other` tag: the two bitsets are intersected a word at a time, so the
+	/// words with no common tags are skipped at once.
+	template <class U>
+	void intersect(const TagStorage<U> &p_other, LocalVector<EntityID> &r_entities) const {
+		r_entities.clear();
+		const LocalVector<uint64_t> &other_words = p_other.get_words();
+		const uint32_t count = MIN(words.size(), other_words.size());
+		for (uint32_t w = 0; w < count; w += 1) {
+			push_word_entities(w, words[w] & other_words[w], r_entities);
+		}
+	}
+
+private:
+	void set_tag(EntityID p_entity) {
+		const uint32_t index = p_entity.get_index();
+		const uint32_t word = index >> WORD_SHIFT;
+		if (word >= words.size()) {
+			const uint32_t old_size = words.size();
+			words.resize(MAX(word + 1, old_size * 2));
+			for (uint32_t w = old_size; w < words.size(); w += 1) {
+				words[w] = 0;
+			}
+			generations.resize(words.size() << WORD_SHIFT);
+		}
+		words[word] |= uint64_t(1) << (index & WORD_MASK);
+		generations[index] = p_entity.get_generation();
+		entities_dirty = true;
+	}
+
+	void build_entities() const {
+		entities.clear();
+		for (uint32_t w = 0; w < words.size(); w += 1) {
+			push_word_entities(w, words[w], entities);
+		}
+		entities_dirty.store(false, std::memory_order_release);
+	}
+
+	void push_word_entities(uint32_t p_word, uint64_t p_bits, LocalVector<EntityID> &r_entities) const {
+		while (p_bits != 0) {
+			const uint32_t index = (p_word << WORD_SHIFT) + tag_lowest_bit(p_bits);
+			r_entities.push_back(EntityID(index, generations[index]));
+			// Clears the lowest set bit.
+			p_bits &= p_bits - 1;
+		}
+	}
+};
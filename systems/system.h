@@ -25,6 +25,9 @@ struct SystemExeInfo {
 	RBSet<uint32_t> mutable_databags;
 	RBSet<uint32_t> immutable_databags;
 	RBSet<uint32_t> events_emitters;
+	/// The events emitted using the `SharedEventsEmitter`: the `System`s
+	/// emitting the same event this way can run in parallel.
+	RBSet<uint32_t> shared_events_emitters;
 	OAHashMap<uint32_t, RBSet<String>> events_receivers;
 
 	// Used if the system is a normal system.
@@ -39,6 +42,7 @@ struct SystemExeInfo {
 		mutable_databags.clear();
 		immutable_databags.clear();
 		events_emitters.clear();
+		shared_events_emitters.clear();
 		events_receivers.clear();
 
 		system_func = nullptr;
@@ -4,6 +4,7 @@
 #include "../iterators/events_emitter_receiver.h"
 #include "../iterators/query.h"
 #include "../spawners/spawner.h"
+#include "../world/command_buffer.h"
 #include <type_traits>
 
 // TODO put all this into a CPP or a namespace?
@@ -38,6 +39,17 @@ struct InfoConstructor<Spawner<I> &, Cs...> : InfoConstructor<Cs...> {
 	}
 };
 
+/// Fetches the `CommandBuffer`.
+/// The commands are applied at the end of the stage, so no storage is declared:
+/// ```
+/// void test_func(CommandBuffer &p_commands){}
+/// ```
+template <class... Cs>
+struct InfoConstructor<CommandBuffer &, Cs...> : InfoConstructor<Cs...> {
+	InfoConstructor(SystemExeInfo &r_info) :
+			InfoConstructor<Cs...>(r_info) {}
+};
+
 /// Fetches the argument `Query`.
 /// The query is supposed to be a mutable query reference:
 /// ```
@@ -82,6 +94,19 @@ struct InfoConstructor<EventsEmitter<E> &, Cs...> : InfoConstructor<Cs...> {
 	}
 };
 
+/// Fetches the `SharedEventsEmitter`.
+/// The `SharedEventsEmitter` is supposed to be takes as mutable reference.
+/// ```
+/// void test_func(SharedEventsEmitter<MyEventType> &p_emitter){}
+/// ```
+template <class E, class... Cs>
+struct InfoConstructor<SharedEventsEmitter<E> &, Cs...> : InfoConstructor<Cs...> {
+	InfoConstructor(SystemExeInfo &r_info) :
+			InfoConstructor<Cs...>(r_info) {
+		r_info.shared_events_emitters.insert(E::get_event_id());
+	}
+};
+
 /// Fetches the `Events`.
 /// The `Events` is supposed to be takes as mutable reference.
 /// ```
@@ -149,6 +174,24 @@ struct DataFetcher<Spawner<I> &> {
 	void set_active(bool p_active) {}
 };
 
+/// CommandBuffer
+template <>
+struct DataFetcher<CommandBuffer &> {
+	CommandBuffer inner;
+
+	DataFetcher(World *p_world) {
+		p_world->add_command_buffer(&inner);
+	}
+
+	void initiate_process(World *p_world) {
+		inner.initiate_process(p_world);
+	}
+
+	void conclude_process(World *p_world) {}
+
+	void set_active(bool p_active) {}
+};
+
 /// EventsEmitter
 template <class E>
 struct DataFetcher<EventsEmitter<E> &> {
@@ -165,12 +208,32 @@ struct DataFetcher<EventsEmitter<E> &> {
 	void set_active(bool p_active) {}
 };
 
+/// SharedEventsEmitter
+template <class E>
+struct DataFetcher<SharedEventsEmitter<E> &> {
+	SharedEventsEmitter<E> inner;
+
+	DataFetcher(World *p_world) {}
+
+	void initiate_process(World *p_world) {
+		inner.initiate_process(p_world);
+	}
+
+	void conclude_process(World *p_world) {
+		inner.conclude_process(p_world);
+	}
+
+	void set_active(bool p_active) {}
+};
+
 /// Events
 template <class E, typename EmitterName>
 struct DataFetcher<EventsReceiver<E, EmitterName> &> {
 	EventsReceiver<E, EmitterName> inner;
 
-	DataFetcher(World *p_world) {}
+	DataFetcher(World *p_world) {
+		inner.prepare_world(p_world);
+	}
 
 	void initiate_process(World *p_world) {
 		inner.initiate_process(p_world);
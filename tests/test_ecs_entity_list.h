@@ -157,6 +157,51 @@ TEST_CASE("[Modules][ECS] Test ECS EntityList.") {
 		CHECK(changed.is_empty());
 	}
 }
+
+TEST_CASE("[Modules][ECS] Test ChangeTicks collects only the dirty pages.") {
+	ChangeTicks ticks;
+
+	// Change the pages out of order, the changes are still collected in order.
+	ticks.mark_changed(EntityID(700, 1));
+	ticks.mark_changed(EntityID(130, 2));
+	ticks.mark_changed(EntityID(5, 1));
+	ticks.mark_changed(EntityID(701, 1));
+
+	LocalVector<EntityID> entities;
+	ticks.collect_changed(ticks.get_flushed_tick(), ticks.advance(), entities);
+	CHECK(entities.size() == 4);
+	CHECK(entities[0] == EntityID(5, 1));
+	CHECK(entities[1] == EntityID(130, 2));
+	CHECK(entities[2] == EntityID(700, 1));
+	CHECK(entities[3] == EntityID(701, 1));
+
+	// After the flush only the new changes are collected.
+	ticks.flush();
+	ticks.mark_changed(EntityID(130, 3));
+	ticks.mark_updated(EntityID(130, 3));
+	ticks.mark_changed(EntityID(64, 1));
+
+	entities.clear();
+	ticks.collect_changed(ticks.get_flushed_tick(), ticks.advance(), entities);
+	CHECK(entities.size() == 1);
+	CHECK(entities[0] == EntityID(64, 1));
+
+	// A change after the collect is taken only by the next collect.
+	const ChangeTick from = ticks.advance();
+	ticks.mark_changed(EntityID(5, 1));
+	entities.clear();
+	ticks.collect_changed(from, ticks.advance(), entities);
+	CHECK(entities.size() == 1);
+	CHECK(entities[0] == EntityID(5, 1));
+
+	// The pages never changed are not allocated, and are never changed.
+	CHECK(ticks.get_tick(EntityID(100000, 0)) == 0);
+	ticks.mark_updated(EntityID(100000, 0));
+	CHECK(ticks.get_tick(EntityID(100000, 0)) == 0);
+	ticks.mark_changed(EntityID(100000, 2));
+	CHECK(ticks.get_tick(EntityID(100000, 2)) > from);
+	CHECK(ticks.get_tick(EntityID(99999, 0)) == 0);
+}
 } // namespace godex_entity_list_tests
 
 #endif
@@ -10,6 +10,7 @@
 #include "../pipeline/pipeline_commands.h"
 #include "../storage/dense_vector_storage.h"
 #include "../systems/dynamic_system.h"
+#include "../utils/thread_pool.h"
 
 class PipelineTestDatabag1 : public godex::Databag {
 	DATABAG(PipelineTestDatabag1)
@@ -18,6 +19,20 @@ public:
 	int a = 10;
 };
 
+class PipelineTestDatabag2 : public godex::Databag {
+	DATABAG(PipelineTestDatabag2)
+
+public:
+	int a = 0;
+};
+
+class PipelineTestDatabag3 : public godex::Databag {
+	DATABAG(PipelineTestDatabag3)
+
+public:
+	int a = 0;
+};
+
 namespace godex_tests_pipeline {
 
 void system_with_databag(PipelineTestDatabag1 *test_res) {}
@@ -44,9 +59,6 @@ TEST_CASE("[Modules][ECS] Test pipeline build.") {
 	// Make sure the pipeline is not ready again.
 	CHECK(pipeline.is_ready() == false);
 }
-} // namespace godex_tests_pipeline
-
-namespace godex_tests_pipeline {
 
 void test_trigger_changed_1(PipelineCommands *p_pipeline_command, Query<TransformComponent> &p_query) {
 	p_pipeline_command->set_active_system(SNAME("test_get_changed"), false);
@@ -120,5 +132,160 @@ TEST_CASE("[Modules][ECS] Test `PipelineCommands`.") {
 	CHECK(Math::is_equal_approx(storage->get(entity_2)->origin.x, real_t(300.0)));
 	CHECK(Math::is_equal_approx(storage->get(entity_3)->origin.x, real_t(600.0)));
 }
+
+void test_thread_pool_task(void *p_user_data, uint32_t p_index) {
+	SafeNumeric<uint32_t> *sum = static_cast<SafeNumeric<uint32_t> *>(p_user_data);
+	sum->add(p_index);
+}
+
+struct ThreadPoolNestedData {
+	ThreadPool *pool;
+	SafeNumeric<uint32_t> sum;
+};
+
+void test_thread_pool_nested_task(void *p_user_data, uint32_t p_index) {
+	// The nested `run` is executed on the calling thread.
+	ThreadPoolNestedData *data = static_cast<ThreadPoolNestedData *>(p_user_data);
+	data->pool->run(test_thread_pool_task, &data->sum, 10);
+}
+
+TEST_CASE("[Modules][ECS] Test `ThreadPool`.") {
+	ThreadPool pool;
+	pool.set_threads_count(3);
+	CHECK(pool.get_threads_count() == 3);
+
+	for (uint32_t i = 0; i < 10; i += 1) {
+		SafeNumeric<uint32_t> sum;
+		pool.run(test_thread_pool_task, &sum, 1000);
+		// Make sure all the tasks got executed once: 0 + 1 + ... + 999.
+		CHECK(sum.get() == 499500);
+	}
+
+	{
+		// Nested call.
+		ThreadPoolNestedData data;
+		data.pool = &pool;
+		pool.run(test_thread_pool_nested_task, &data, 20);
+		// 20 times 0 + 1 + ... + 9.
+		CHECK(data.sum.get() == 900);
+	}
+
+	// No workers, everything runs on this thread.
+	pool.set_threads_count(0);
+	CHECK(pool.get_threads_count() == 0);
+	SafeNumeric<uint32_t> sum;
+	pool.run(test_thread_pool_task, &sum, 1000);
+	CHECK(sum.get() == 499500);
+}
+
+void test_parallel_system_1(PipelineTestDatabag2 *p_databag) {
+	p_databag->a += 1;
+}
+
+void test_parallel_system_2(PipelineTestDatabag3 *p_databag) {
+	p_databag->a += 2;
+}
+
+TEST_CASE("[Modules][ECS] Test pipeline dispatches stages in parallel.") {
+	ECS::register_databag<PipelineTestDatabag2>();
+	ECS::register_databag<PipelineTestDatabag3>();
+
+	const godex::system_id system_1_id = ECS::register_system(test_parallel_system_1, "test_parallel_system_1").get_id();
+	const godex::system_id system_2_id = ECS::register_system(test_parallel_system_2, "test_parallel_system_2").get_id();
+
+	Pipeline pipeline;
+	{
+		PipelineBuilder pipeline_builder;
+		pipeline_builder.add_system(system_1_id);
+		pipeline_builder.add_system(system_2_id);
+		pipeline_builder.build(pipeline);
+	}
+	pipeline.set_threads_count(4);
+	CHECK(pipeline.get_threads_count() == 4);
+
+	// Both systems are in the same stage.
+	CHECK(pipeline.get_system_stage(system_1_id) == pipeline.get_system_stage(system_2_id));
+
+	World world;
+	const Token token = pipeline.prepare_world(&world);
+	pipeline.set_active(token, true);
+	for (uint32_t i = 0; i < 100; i += 1) {
+		pipeline.dispatch(token);
+	}
+
+	CHECK(world.get_databag<PipelineTestDatabag2>()->a == 100);
+	CHECK(world.get_databag<PipelineTestDatabag3>()->a == 200);
+
+	// Switch to single thread, the result is the same.
+	pipeline.set_threads_count(1);
+	pipeline.dispatch(token);
+	CHECK(world.get_databag<PipelineTestDatabag2>()->a == 101);
+	CHECK(world.get_databag<PipelineTestDatabag3>()->a == 202);
+
+	pipeline.release_world(token);
+}
+
+void test_profiled_system(Query<const TransformComponent> &p_query) {
+	uint32_t count = 0;
+	for (auto [_t] : p_query) {
+		count += 1;
+		if (count == 3) {
+			// Only the visited `Entities` are counted.
+			break;
+		}
+	}
+}
+
+TEST_CASE("[Modules][ECS] Test pipeline profiler.") {
+	const godex::system_id system_id = ECS::register_system(test_profiled_system, "test_profiled_system").get_id();
+
+	Pipeline pipeline;
+	{
+		PipelineBuilder pipeline_builder;
+		pipeline_builder.add_system(system_id);
+		pipeline_builder.build(pipeline);
+	}
+	CHECK(pipeline.get_systems_count() == 1);
+	CHECK(pipeline.get_system_at_index(0) == system_id);
+
+	World world;
+	for (uint32_t i = 0; i < 5; i += 1) {
+		world.create_entity().with(TransformComponent());
+	}
+
+	const Token token = pipeline.prepare_world(&world);
+	pipeline.set_active(token, true);
+
+	// The profiler is disabled by default.
+	pipeline.dispatch(token);
+	CHECK(pipeline.get_profiler().get_frames_count() == 0);
+
+	pipeline.get_profiler().set_history_size(3);
+	pipeline.set_profiling_enabled(true);
+	for (uint32_t i = 0; i < 5; i += 1) {
+		pipeline.dispatch(token);
+	}
+	CHECK(pipeline.get_profiler().get_frames_count() == 5);
+
+	FrameProfile frame;
+	CHECK(pipeline.get_profiler().get_frame(0, frame));
+	CHECK(frame.frame == 4);
+	CHECK(frame.stages_time_usec.size() == pipeline.get_stages_count());
+	CHECK(frame.systems.size() == 1);
+	CHECK(frame.systems[0].calls == 1);
+	CHECK(frame.systems[0].entities == 3);
+
+	CHECK(pipeline.get_profiler().get_frame(2, frame));
+	CHECK(frame.frame == 2);
+
+	// Only the last 3 frames are kept.
+	CHECK(pipeline.get_profiler().get_frame(3, frame) == false);
+
+	pipeline.set_profiling_enabled(false);
+	pipeline.dispatch(token);
+	CHECK(pipeline.get_profiler().get_frames_count() == 5);
+
+	pipeline.release_world(token);
+}
 } // namespace godex_tests_pipeline
 #endif // TEST_ECS_PIPELINE_H
@@ -7,8 +7,12 @@
 #include "../ecs.h"
 #include "../iterators/dynamic_query.h"
 #include "../modules/godot/components/transform_component.h"
+#include "../pipeline/pipeline.h"
+#include "../pipeline/pipeline_builder.h"
 #include "../storage/batch_storage.h"
 #include "../storage/dense_vector_storage.h"
+#include "../utils/thread_pool.h"
+#include "../world/command_buffer.h"
 #include "../world/world.h"
 
 struct TagQueryTestComponent {
@@ -28,6 +32,15 @@ struct TagC {
 	COMPONENT(TagC, DenseVectorStorage)
 };
 
+struct ParallelQueryTestComponent {
+	COMPONENT(ParallelQueryTestComponent, DenseVectorStorage)
+
+public:
+	int value = 0;
+	/// `true` when the last write was done by a `ThreadPool` task.
+	bool written_by_task = false;
+};
+
 struct TestFixedSizeEvent {
 	COMPONENT_BATCH(TestFixedSizeEvent, DenseVector, 2)
 	static void _bind_methods() {}
@@ -1228,6 +1241,126 @@ TEST_CASE("[Modules][ECS] Test DynamicQuery changed.") {
 	}
 }
 
+TEST_CASE("[Modules][ECS] Test DynamicQuery chunk columns.") {
+	World world;
+
+	for (uint32_t i = 0; i < 10; i += 1) {
+		TransformComponent t;
+		t.origin = Vector3(i, 0, 0);
+		world.create_entity().with(t);
+	}
+
+	godex::DynamicQuery query;
+	query.with_component(TransformComponent::get_component_id(), true);
+	query.initiate_process(&world);
+
+	// Move all the entities, 4 at a time.
+	uint32_t chunks = 0;
+	uint32_t fetched = 0;
+	while (query.next_chunk(4) > 0) {
+		chunks += 1;
+		fetched += query.get_chunk_size();
+		CHECK(query.get_chunk_entities().size() == int(query.get_chunk_size()));
+
+		const Variant column = query.get_column(0, "origin");
+		CHECK(column.get_type() == Variant::PACKED_VECTOR3_ARRAY);
+
+		PackedVector3Array origins = column;
+		CHECK(origins.size() == int(query.get_chunk_size()));
+		for (int i = 0; i < origins.size(); i += 1) {
+			origins.set(i, origins[i] + Vector3(0, 10, 0));
+		}
+		CHECK(query.set_column(0, "origin", origins));
+
+		// A column with a different size is refused.
+		CHECK(query.set_column(0, "origin", PackedVector3Array()) == false);
+	}
+	query.conclude_process(&world);
+
+	CHECK(chunks == 3);
+	CHECK(fetched == 10);
+
+	const Storage<TransformComponent> *storage = world.get_storage<TransformComponent>();
+	for (uint32_t i = 0; i < 10; i += 1) {
+		CHECK(storage->get(i)->origin.is_equal_approx(Vector3(i, 10, 0)));
+	}
+
+	{
+		// The immutable components can't be written.
+		godex::DynamicQuery query_immut;
+		query_immut.with_component(TransformComponent::get_component_id(), false);
+		query_immut.initiate_process(&world);
+		CHECK(query_immut.next_chunk(100) == 10);
+		CHECK(query_immut.set_column(0, "origin", query_immut.get_column(0, "origin")) == false);
+		query_immut.conclude_process(&world);
+	}
+}
+
+TEST_CASE("[Modules][ECS] Test DynamicQuery chunk columns with packed components.") {
+	LocalVector<ScriptProperty> props;
+	props.push_back({ PropertyInfo(Variant::INT, "counter"), 7 });
+	props.push_back({ PropertyInfo(Variant::VECTOR3, "direction"), Vector3(0, 1, 0) });
+
+	const uint32_t packed_id = ECS::register_or_update_script_component(
+			"TestDynamicQueryPackedColumns.gd",
+			props,
+			StorageType::DENSE_VECTOR,
+			Vector<StringName>());
+
+	World world;
+
+	// Recycle an `Entity`, so its id has a generation.
+	world.destroy_entity(world.create_entity());
+	LocalVector<EntityID> entities;
+	for (uint32_t i = 0; i < 3; i += 1) {
+		entities.push_back(world.create_entity().with(packed_id, Dictionary()));
+	}
+	CHECK(entities[0].get_generation() != 0);
+
+	godex::DynamicQuery query;
+	query.with_component(packed_id, true);
+	query.initiate_process(&world);
+	CHECK(query.next_chunk(10) == 3);
+
+	// The generation is kept.
+	const PackedInt32Array chunk_entities = query.get_chunk_entities();
+	CHECK(chunk_entities[0] == int(entities[0].get_raw_id()));
+
+	const PackedInt64Array counters = query.get_column(0, "counter");
+	CHECK(counters.size() == 3);
+	CHECK(counters[2] == 7);
+	const PackedVector3Array directions = query.get_column(0, "direction");
+	CHECK(directions[1] == Vector3(0, 1, 0));
+
+	PackedInt64Array new_counters;
+	new_counters.push_back(1);
+	new_counters.push_back(2);
+	new_counters.push_back(3);
+	CHECK(query.set_column(0, "counter", new_counters));
+
+	// A column of a different type is refused, nothing is written.
+	PackedFloat64Array floats;
+	floats.push_back(10.0);
+	floats.push_back(20.0);
+	floats.push_back(30.0);
+	CHECK(query.set_column(0, "counter", floats) == false);
+
+	Array mixed;
+	mixed.push_back(10);
+	mixed.push_back(20.0);
+	mixed.push_back(30);
+	CHECK(query.set_column(0, "counter", mixed) == false);
+
+	const PackedInt64Array written = query.get_column(0, "counter");
+	CHECK(written[0] == 1);
+	CHECK(written[1] == 2);
+	CHECK(written[2] == 3);
+	query.conclude_process(&world);
+
+	const void *component = world.get_storage(packed_id)->get_ptr(entities[2]);
+	CHECK(ECS::unsafe_component_get_by_name(packed_id, component, "counter") == Variant(3));
+}
+
 TEST_CASE("[Modules][ECS] Test static query check query type fetch.") {
 	World world;
 
@@ -1750,6 +1883,117 @@ TEST_CASE("[Modules][ECS] Test static query count.") {
 	}
 }
 
+TEST_CASE("[Modules][ECS] Test static query DenseVectorStorage fast path.") {
+	// The storage type is taken from the component declaration.
+	CHECK(QueryStorage<0, TagA>::IS_DENSE);
+	CHECK(QueryStorage<0, const TagA>::IS_DENSE);
+	CHECK(QueryStorage<0, TransformComponent>::IS_DENSE == false);
+	CHECK(QueryStorage<0, TestFixedSizeEvent>::IS_DENSE == false);
+
+	World world;
+
+	const EntityID entity_1 = world
+									  .create_entity()
+									  .with(TagA())
+									  .with(TagB());
+
+	const EntityID entity_2 = world
+									  .create_entity()
+									  .with(TagA());
+
+	const EntityID entity_3 = world
+									  .create_entity()
+									  .with(TagA())
+									  .with(TagB());
+
+	Query<EntityID, TagA, const TagB> query(&world);
+	query.initiate_process(&world);
+
+	CHECK(query.has(entity_1));
+	CHECK(query.has(entity_2) == false);
+	CHECK(query.has(entity_3));
+
+	uint32_t count = 0;
+	for (auto [entity, tag_a, tag_b] : query) {
+		CHECK(tag_a == world.get_storage<TagA>()->get(entity));
+		CHECK(tag_b == world.get_storage<const TagB>()->get(entity));
+		count += 1;
+	}
+	CHECK(count == 2);
+
+	query.conclude_process(&world);
+}
+
+TEST_CASE("[Modules][ECS] Test static query Changed filter ticks.") {
+	World world;
+
+	for (uint32_t i = 0; i < 300; i += 1) {
+		world.create_entity()
+				.with(TransformComponent());
+	}
+
+	Storage<TransformComponent> *storage = world.get_storage<TransformComponent>();
+	Query<EntityID, Changed<const TransformComponent>> query(&world);
+
+	// The changes notified before the query creation are not taken.
+	query.initiate_process(&world);
+	CHECK(query.count() == 0);
+	query.conclude_process(&world);
+
+	storage->notify_changed(250);
+	storage->notify_changed(5);
+	storage->notify_changed(6);
+	storage->notify_updated(6);
+
+	query.initiate_process(&world);
+	{
+		CHECK(query.count() == 2);
+		CHECK(query.has(5));
+		CHECK(query.has(6) == false);
+		CHECK(query.has(250));
+
+		// The entities are iterated in order.
+		LocalVector<EntityID> entities;
+		for (auto [entity, transform] : query) {
+			entities.push_back(entity);
+		}
+		REQUIRE(entities.size() == 2);
+		CHECK(entities[0] == EntityID(5));
+		CHECK(entities[1] == EntityID(250));
+
+		// The changes notified while processing are discarded.
+		storage->notify_changed(7);
+		CHECK(query.has(7) == false);
+	}
+	query.conclude_process(&world);
+
+	query.initiate_process(&world);
+	CHECK(query.count() == 0);
+	query.conclude_process(&world);
+
+	// The changes notified while the notification is not active are ignored.
+	storage->notify_changed(8);
+	query.set_world_notification_active(false);
+	storage->notify_changed(9);
+	query.set_world_notification_active(true);
+	storage->notify_changed(10);
+
+	query.initiate_process(&world);
+	CHECK(query.count() == 2);
+	CHECK(query.has(8));
+	CHECK(query.has(9) == false);
+	CHECK(query.has(10));
+	query.conclude_process(&world);
+
+	// The flushed changes are discarded.
+	storage->notify_changed(11);
+	storage->flush_changed();
+
+	query.initiate_process(&world);
+	CHECK(query.count() == 0);
+	query.conclude_process(&world);
+}
+
 TEST_CASE("[Modules][ECS] Test static query Any filter.") {
 	World world;
 
@@ -2233,6 +2477,185 @@ TEST_CASE("[Modules][ECS] Test static query Join filter.") {
 		}
 	}
 }
+
+void test_par_for_each_system(Query<TransformComponent, const TagA> &p_query) {
+	// Small chunks, so the work is split between all the workers.
+	const uint32_t chunk_size = 16;
+	p_query.par_for_each([](auto p_components) {
+		auto [transform, tag] = p_components;
+		transform->origin.x += 1.0;
+		// The `HierarchicalStorage` is written by the workers.
+		transform->origin.y = ThreadPool::is_executing_task() ? 1.0 : 0.0;
+	},
+			chunk_size);
+}
+
+uint32_t test_par_for_each_changed_count = 0;
+void test_par_for_each_changed_system(Query<Changed<const TransformComponent>> &p_query) {
+	test_par_for_each_changed_count = p_query.count();
+}
+
+TEST_CASE("[Modules][ECS] Test static query par_for_each.") {
+	World world;
+
+	for (uint32_t i = 0; i < 1000; i += 1) {
+		if (i % 2) {
+			world.create_entity()
+					.with(TransformComponent())
+					.with(TagA());
+		} else {
+			world.create_entity()
+					.with(TransformComponent());
+		}
+	}
+
+	// Without workers the query is processed on this thread.
+	{
+		Query<TransformComponent, const TagA> query(&world);
+		query.initiate_process(&world);
+
+		uint32_t count = 0;
+		query.par_for_each([&count](auto p_components) {
+			auto [transform, tag] = p_components;
+			transform->origin.x += 1.0;
+			count += 1;
+		});
+		CHECK(count == 500);
+
+		query.conclude_process(&world);
+	}
+
+	// Using the `Pipeline` workers.
+	{
+		const godex::system_id system_id = ECS::register_system(test_par_for_each_system, "test_par_for_each_system").get_id();
+		const godex::system_id changed_system_id = ECS::register_system(test_par_for_each_changed_system, "test_par_for_each_changed_system")
+														   .after("test_par_for_each_system")
+														   .get_id();
+
+		Pipeline pipeline;
+		{
+			PipelineBuilder pipeline_builder;
+			pipeline_builder.add_system(system_id);
+			pipeline_builder.add_system(changed_system_id);
+			pipeline_builder.build(pipeline);
+		}
+		pipeline.set_threads_count(4);
+
+		const Token token = pipeline.prepare_world(&world);
+		pipeline.set_active(token, true);
+
+		for (uint32_t i = 0; i < 3; i += 1) {
+			test_par_for_each_changed_count = 0;
+			pipeline.dispatch(token);
+			// The changes done by the workers are notified.
+			CHECK(test_par_for_each_changed_count == 500);
+		}
+
+		pipeline.release_world(token);
+	}
+
+	const Storage<const TransformComponent> *storage = world.get_storage<const TransformComponent>();
+	for (uint32_t i = 0; i < 1000; i += 1) {
+		CHECK(Math::is_equal_approx(storage->get(i)->origin.x, i % 2 ? real_t(4.0) : real_t(0.0)));
+		CHECK(Math::is_equal_approx(storage->get(i)->origin.y, i % 2 ? real_t(1.0) : real_t(0.0)));
+	}
+}
+
+void test_par_for_each_dense_system(Query<ParallelQueryTestComponent> &p_query) {
+	p_query.par_for_each([](auto p_components) {
+		auto [component] = p_components;
+		component->value += 1;
+		component->written_by_task = ThreadPool::is_executing_task();
+	},
+			16);
+}
+
+uint32_t test_par_for_each_dense_changed_count = 0;
+void test_par_for_each_dense_changed_system(Query<Changed<const ParallelQueryTestComponent>> &p_query) {
+	test_par_for_each_dense_changed_count = p_query.count();
+}
+
+TEST_CASE("[Modules][ECS] Test static query par_for_each runs on the workers.") {
+	ECS::register_component<ParallelQueryTestComponent>();
+
+	World world;
+	for (uint32_t i = 0; i < 1000; i += 1) {
+		world.create_entity().with(ParallelQueryTestComponent());
+	}
+
+	const godex::system_id system_id = ECS::register_system(test_par_for_each_dense_system, "test_par_for_each_dense_system").get_id();
+	const godex::system_id changed_system_id = ECS::register_system(test_par_for_each_dense_changed_system, "test_par_for_each_dense_changed_system")
+													   .after("test_par_for_each_dense_system")
+													   .get_id();
+
+	Pipeline pipeline;
+	{
+		PipelineBuilder pipeline_builder;
+		pipeline_builder.add_system(system_id);
+		pipeline_builder.add_system(changed_system_id);
+		pipeline_builder.build(pipeline);
+	}
+	pipeline.set_threads_count(4);
+
+	const Token token = pipeline.prepare_world(&world);
+	pipeline.set_active(token, true);
+
+	for (uint32_t i = 0; i < 3; i += 1) {
+		test_par_for_each_dense_changed_count = 0;
+		pipeline.dispatch(token);
+		CHECK(test_par_for_each_dense_changed_count == 1000);
+	}
+
+	pipeline.release_world(token);
+
+	// Every `Entity` is processed once per dispatch, always by a task: so the
+	// query really took the parallel path.
+	const Storage<const ParallelQueryTestComponent> *storage = world.get_storage<const ParallelQueryTestComponent>();
+	for (uint32_t i = 0; i < 1000; i += 1) {
+		CHECK(storage->get(i)->value == 3);
+		CHECK(storage->get(i)->written_by_task);
+	}
+}
+
+void test_par_for_each_commands_system(CommandBuffer &p_commands, Query<EntityID, const ParallelQueryTestComponent> &p_query) {
+	// All the chunks write the first `Entity`.
+	p_query.par_for_each([&p_commands](auto p_components) {
+		auto [entity, component] = p_components;
+		ParallelQueryTestComponent data;
+		data.value = int(entity.get_index());
+		p_commands.insert(EntityID(0), data);
+	},
+			16);
+}
+
+TEST_CASE("[Modules][ECS] Test CommandBuffer recorded by par_for_each is applied in chunk order.") {
+	World world;
+	for (uint32_t i = 0; i < 1000; i += 1) {
+		world.create_entity().with(ParallelQueryTestComponent());
+	}
+
+	const godex::system_id system_id = ECS::register_system(test_par_for_each_commands_system, "test_par_for_each_commands_system").get_id();
+
+	Pipeline pipeline;
+	{
+		PipelineBuilder pipeline_builder;
+		pipeline_builder.add_system(system_id);
+		pipeline_builder.build(pipeline);
+	}
+	pipeline.set_threads_count(4);
+
+	const Token token = pipeline.prepare_world(&world);
+	pipeline.set_active(token, true);
+
+	for (uint32_t i = 0; i < 10; i += 1) {
+		pipeline.dispatch(token);
+		// The command recorded by the last chunk is always the last applied,
+		// no matter which worker took it.
+		CHECK(world.get_storage<const ParallelQueryTestComponent>()->get(EntityID(0))->value == 999);
+	}
+
+	pipeline.release_world(token);
+}
 } // namespace godex_tests
 
 #endif // TEST_ECS_QUERY_H
@@ -0,0 +1,139 @@
+#ifndef TEST_ECS_REPLICATION_H
+#define TEST_ECS_REPLICATION_H
+
+#include "tests/test_macros.h"
+
+#include "../components/component.h"
+#include "../ecs.h"
+#include "../world/replication.h"
+#include "../world/world.h"
+
+namespace godex_replication_tests {
+
+struct ReplicatedComponent {
+	COMPONENT(ReplicatedComponent, DenseVectorStorage)
+
+	static void _bind_methods() {
+		ECS_BIND_PROPERTY(ReplicatedComponent, PropertyInfo(Variant::VECTOR3, "position"), position);
+		ECS_BIND_PROPERTY(ReplicatedComponent, PropertyInfo(Variant::INT, "health"), health);
+		ECS_BIND_PROPERTY(ReplicatedComponent, PropertyInfo(Variant::STRING, "label"), label);
+	}
+
+	Vector3 position;
+	int health = 100;
+	String label;
+};
+
+struct ReplicatedTag {
+	COMPONENT(ReplicatedTag, DenseVectorStorage)
+	static void _bind_methods() {}
+};
+
+TEST_CASE("[Modules][ECS] Test replication encode and decode.") {
+	ECS::register_component<ReplicatedComponent>();
+	ECS::register_component<ReplicatedTag>();
+
+	Dictionary quantization;
+	quantization["position"] = 0.01;
+
+	ReplicationSchema schema;
+	schema.add_component(ReplicatedComponent::get_component_id(), quantization);
+	schema.add_component(ReplicatedTag::get_component_id());
+
+	World server;
+	World client;
+
+	ReplicatedComponent data;
+	data.position = Vector3(1.0, 2.0, 3.0);
+	data.label = "first";
+	const EntityID entity_1 = server.create_entity()
+									  .with(data)
+									  .with(ReplicatedTag());
+
+	ReplicationEncoder encoder(&server, schema);
+	ReplicationDecoder decoder(&client, schema);
+
+	data.position = Vector3(-4.0, 0.5, 0.0);
+	data.health = 20;
+	data.label = "second";
+	const EntityID entity_2 = server.create_entity().with(data);
+
+	// The first frame sends all the `Entities`, also the ones stored before the
+	// encoder creation.
+	LocalVector<uint8_t> frame_1;
+	const uint32_t sequence_1 = encoder.encode(frame_1);
+	uint32_t sequence = 0;
+	CHECK(decoder.decode(frame_1.ptr(), frame_1.size(), sequence) == OK);
+	CHECK(sequence == sequence_1);
+	encoder.ack(sequence);
+
+	const EntityID local_1 = decoder.get_local_entity(entity_1);
+	const EntityID local_2 = decoder.get_local_entity(entity_2);
+	CHECK(local_1.is_null() == false);
+	CHECK(local_2.is_null() == false);
+	{
+		const Storage<const ReplicatedComponent> *storage = client.get_storage<const ReplicatedComponent>();
+		CHECK(storage->get(local_1)->position.distance_to(Vector3(1.0, 2.0, 3.0)) <= 0.01);
+		CHECK(storage->get(local_1)->health == 100);
+		CHECK(storage->get(local_1)->label == "first");
+		CHECK(storage->get(local_2)->position.distance_to(Vector3(-4.0, 0.5, 0.0)) <= 0.01);
+		CHECK(storage->get(local_2)->health == 20);
+		CHECK(storage->get(local_2)->label == "second");
+		CHECK(client.get_storage<const ReplicatedTag>()->has(local_1));
+		CHECK(client.get_storage<const ReplicatedTag>()->has(local_2) == false);
+	}
+
+	// Nothing changed: the frame has no sections.
+	LocalVector<uint8_t> frame_2;
+	encoder.encode(frame_2);
+	CHECK(frame_2.size() < frame_1.size());
+	CHECK(decoder.decode(frame_2.ptr(), frame_2.size(), sequence) == OK);
+	encoder.ack(sequence);
+
+	// A change smaller than the quantization step is not sent, the other
+	// changes send only the changed fields.
+	server.get_storage<ReplicatedComponent>()->get(entity_1)->position.x += 0.001;
+	server.get_storage<ReplicatedComponent>()->get(entity_2)->health = 10;
+	LocalVector<uint8_t> frame_3;
+	encoder.encode(frame_3);
+	CHECK(frame_3.size() > frame_2.size());
+	CHECK(frame_3.size() < frame_1.size());
+
+	// The frame is lost: the next one sends the change again.
+	LocalVector<uint8_t> frame_4;
+	encoder.encode(frame_4);
+	CHECK(frame_4.size() == frame_3.size());
+	CHECK(decoder.decode(frame_4.ptr(), frame_4.size(), sequence) == OK);
+	encoder.ack(sequence);
+	CHECK(client.get_storage<const ReplicatedComponent>()->get(local_2)->health == 10);
+	CHECK(client.get_storage<const ReplicatedComponent>()->get(local_2)->label == "second");
+
+	// The late frames are skipped.
+	CHECK(decoder.decode(frame_3.ptr(), frame_3.size(), sequence) == ERR_SKIP);
+
+	// The removals are replicated, and the `Entity` without replicated
+	// components is destroyed.
+	server.remove_component(entity_1, ReplicatedTag::get_component_id());
+	server.destroy_entity(entity_2);
+	LocalVector<uint8_t> frame_5;
+	encoder.encode(frame_5);
+	CHECK(decoder.decode(frame_5.ptr(), frame_5.size(), sequence) == OK);
+	encoder.ack(sequence);
+
+	CHECK(client.get_storage<const ReplicatedTag>()->has(local_1) == false);
+	CHECK(client.get_storage<const ReplicatedComponent>()->has(local_1));
+	CHECK(client.is_entity_alive(local_2) == false);
+	CHECK(decoder.get_local_entity(entity_2).is_null());
+
+	// A malformed frame is never applied.
+	LocalVector<uint8_t> frame_6;
+	server.get_storage<ReplicatedComponent>()->get(entity_1)->health = 1;
+	encoder.encode(frame_6);
+	ERR_PRINT_OFF;
+	CHECK(decoder.decode(frame_6.ptr(), frame_6.size() - 1, sequence) == ERR_FILE_CORRUPT);
+	ERR_PRINT_ON;
+	CHECK(client.get_storage<const ReplicatedComponent>()->get(local_1)->health == 100);
+}
+} // namespace godex_replication_tests
+
+#endif // TEST_ECS_REPLICATION_H
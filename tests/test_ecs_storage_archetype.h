@@ -0,0 +1,183 @@
+#ifndef TEST_ARCHETYPE_STORAGE_H
+#define TEST_ARCHETYPE_STORAGE_H
+
+#include "../components/component.h"
+#include "../ecs.h"
+#include "../iterators/query.h"
+#include "../storage/archetype_storage.h"
+#include "../world/world.h"
+
+#include "tests/test_macros.h"
+
+namespace godex_ecs_archetype_storage_tests {
+
+struct ArchetypeComponentA {
+	COMPONENT(ArchetypeComponentA, ArchetypeStorage)
+	static void _bind_methods() {}
+
+	int number = 0;
+
+	ArchetypeComponentA(int p_number) :
+			number(p_number) {}
+};
+
+struct ArchetypeComponentB {
+	COMPONENT(ArchetypeComponentB, ArchetypeStorage)
+	static void _bind_methods() {}
+
+	int number = 0;
+
+	ArchetypeComponentB(int p_number) :
+			number(p_number) {}
+};
+
+TEST_CASE("[ArchetypeStorage] Insert, move and remove.") {
+	ECS::register_component<ArchetypeComponentA>();
+	ECS::register_component<ArchetypeComponentB>();
+
+	World world;
+
+	// A
+	const EntityID entity_1 = world.create_entity()
+									  .with(ArchetypeComponentA(1));
+	// A, B
+	const EntityID entity_2 = world.create_entity()
+									  .with(ArchetypeComponentA(2))
+									  .with(ArchetypeComponentB(20));
+	// B
+	const EntityID entity_3 = world.create_entity()
+									  .with(ArchetypeComponentB(30));
+	// A, B
+	const EntityID entity_4 = world.create_entity()
+									  .with(ArchetypeComponentB(40))
+									  .with(ArchetypeComponentA(4));
+
+	const ArchetypeRegistry *registry = world.get_archetype_registry();
+	REQUIRE(registry != nullptr);
+
+	// Both A,B and B,A end into the same archetype.
+	CHECK(registry->get_location(entity_2).archetype == registry->get_location(entity_4).archetype);
+	CHECK(registry->get_location(entity_1).archetype != registry->get_location(entity_2).archetype);
+	CHECK(registry->get_location(entity_3).archetype != registry->get_location(entity_2).archetype);
+
+	Storage<ArchetypeComponentA> *storage_a = world.get_storage<ArchetypeComponentA>();
+	Storage<ArchetypeComponentB> *storage_b = world.get_storage<ArchetypeComponentB>();
+
+	CHECK(storage_a->has(entity_1));
+	CHECK(storage_a->has(entity_2));
+	CHECK(storage_a->has(entity_3) == false);
+	CHECK(storage_a->has(entity_4));
+	CHECK(storage_b->has(entity_1) == false);
+	CHECK(storage_b->has(entity_2));
+	CHECK(storage_b->has(entity_3));
+	CHECK(storage_b->has(entity_4));
+
+	// The data followed the entities while moving between archetypes.
+	CHECK(storage_a->get(entity_1)->number == 1);
+	CHECK(storage_a->get(entity_2)->number == 2);
+	CHECK(storage_a->get(entity_4)->number == 4);
+	CHECK(storage_b->get(entity_2)->number == 20);
+	CHECK(storage_b->get(entity_3)->number == 30);
+	CHECK(storage_b->get(entity_4)->number == 40);
+
+	// Remove `A` from `entity_2`, it moves to the archetype of `entity_3`
+	// and `entity_4` takes its row.
+	storage_a->remove(entity_2);
+	CHECK(storage_a->has(entity_2) == false);
+	CHECK(storage_b->has(entity_2));
+	CHECK(registry->get_location(entity_2).archetype == registry->get_location(entity_3).archetype);
+	CHECK(storage_b->get(entity_2)->number == 20);
+	CHECK(storage_a->get(entity_4)->number == 4);
+	CHECK(storage_b->get(entity_4)->number == 40);
+
+	// Destroying the entity, removes it from the archetype.
+	world.destroy_entity(entity_4);
+	CHECK(storage_a->has(entity_4) == false);
+	CHECK(storage_b->has(entity_4) == false);
+	CHECK(registry->get_location(entity_4).archetype == UINT32_MAX);
+	CHECK(storage_a->get(entity_1)->number == 1);
+	CHECK(storage_b->get(entity_3)->number == 30);
+
+	// Update in place.
+	storage_b->insert(entity_3, ArchetypeComponentB(33));
+	CHECK(storage_b->get(entity_3)->number == 33);
+}
+
+TEST_CASE("[ArchetypeStorage] Query iterates the archetypes.") {
+	World world;
+
+	for (int i = 0; i < 100; i += 1) {
+		if (i % 3 == 0) {
+			world.create_entity()
+					.with(ArchetypeComponentA(i));
+		} else {
+			world.create_entity()
+					.with(ArchetypeComponentA(i))
+					.with(ArchetypeComponentB(i));
+		}
+	}
+
+	{
+		Query<EntityID, ArchetypeComponentA, const ArchetypeComponentB> query(&world);
+		query.initiate_process(&world);
+
+		uint32_t count = 0;
+		for (auto [entity, a, b] : query) {
+			CHECK(a->number == b->number);
+			CHECK(int(uint32_t(entity)) % 3 != 0);
+			a->number += 1000;
+			count += 1;
+		}
+		CHECK(count == 66);
+		CHECK(query.count() == 66);
+		query.conclude_process(&world);
+	}
+
+	{
+		Query<const ArchetypeComponentA> query(&world);
+		query.initiate_process(&world);
+
+		uint32_t count = 0;
+		for (auto [a] : query) {
+			if (a->number >= 1000) {
+				count += 1;
+			}
+		}
+		// All the entities with `A` are iterated, across the two archetypes.
+		CHECK(query.count() == 100);
+		CHECK(count == 66);
+		query.conclude_process(&world);
+	}
+
+	{
+		// The filters use the standard iteration.
+		Query<const ArchetypeComponentA, Not<ArchetypeComponentB>> query(&world);
+		query.initiate_process(&world);
+		CHECK(query.count() == 34);
+		query.conclude_process(&world);
+	}
+}
+
+void test_archetype_add_a(Storage<ArchetypeComponentA> *p_storage) {}
+void test_archetype_read_b(Query<const ArchetypeComponentB> &p_query) {}
+void test_archetype_write_b(Query<ArchetypeComponentB> &p_query) {}
+void test_archetype_read_a(Query<const ArchetypeComponentA> &p_query) {}
+
+TEST_CASE("[ArchetypeStorage] Structural changes are registry wide.") {
+	const godex::system_id add_a = ECS::register_system(test_archetype_add_a, "test_archetype_add_a").get_id();
+	const godex::system_id read_b = ECS::register_system(test_archetype_read_b, "test_archetype_read_b").get_id();
+	const godex::system_id write_b = ECS::register_system(test_archetype_write_b, "test_archetype_write_b").get_id();
+	const godex::system_id read_a = ECS::register_system(test_archetype_read_a, "test_archetype_read_a").get_id();
+
+	// Adding `A` moves the `B` rows too.
+	CHECK(ECS::can_systems_run_in_parallel(add_a, read_b) == false);
+	CHECK(ECS::can_systems_run_in_parallel(write_b, add_a) == false);
+	CHECK(ECS::can_systems_run_in_parallel(add_a, read_a) == false);
+
+	// Without structural changes the usual rules apply.
+	CHECK(ECS::can_systems_run_in_parallel(read_a, read_b));
+	CHECK(ECS::can_systems_run_in_parallel(read_a, write_b));
+}
+} // namespace godex_ecs_archetype_storage_tests
+
+#endif // TEST_ARCHETYPE_STORAGE_H
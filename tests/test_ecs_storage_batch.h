@@ -0,0 +1,141 @@
+#ifndef TEST_ECS_STORAGE_BATCH_H
+#define TEST_ECS_STORAGE_BATCH_H
+
+#include "tests/test_macros.h"
+
+#include "../components/component.h"
+#include "../ecs.h"
+#include "../storage/batch_storage.h"
+#include "../storage/dense_vector.h"
+
+namespace godex_storage_batch_tests {
+
+struct TestBatchInt {
+	COMPONENT_BATCH_ARENA(TestBatchInt, DenseVector)
+
+public:
+	int number = 0;
+
+	TestBatchInt(int i) :
+			number(i) {}
+};
+
+struct TestBatchSnapshot {
+	COMPONENT_BATCH_ARENA(TestBatchSnapshot, DenseVector)
+
+public:
+	static void _bind_methods() {
+		ECS_BIND_PROPERTY(TestBatchSnapshot, PropertyInfo(Variant::INT, "number"), number);
+	}
+
+	int number = 0;
+
+	TestBatchSnapshot(int i) :
+			number(i) {}
+};
+
+TEST_CASE("[Modules][ECS] Test dynamic sized batch storage arena.") {
+	BatchStorage<DenseVector, -1, TestBatchInt, true> storage;
+
+	// Grow the batches past the inline size, interleaved so they are moved
+	// into the arena many times.
+	for (int i = 0; i < 100; i += 1) {
+		for (uint32_t e = 0; e < 5; e += 1) {
+			storage.insert(e, TestBatchInt(int(e) * 1000 + i));
+		}
+	}
+
+	for (uint32_t e = 0; e < 5; e += 1) {
+		CHECK(storage.get_batch_size(e) == 100);
+		const TestBatchInt *batch = std::as_const(storage).get(e);
+		for (int i = 0; i < 100; i += 1) {
+			CHECK(batch[i].number == int(e) * 1000 + i);
+		}
+	}
+
+	// The released blocks are reused, without touching the other batches.
+	storage.remove(2);
+	CHECK(storage.has(2) == false);
+	for (int i = 0; i < 70; i += 1) {
+		storage.insert(7, TestBatchInt(i));
+	}
+	CHECK(storage.get_batch_size(7) == 70);
+	CHECK(std::as_const(storage).get(7)[69].number == 69);
+	CHECK(std::as_const(storage).get(4)[99].number == 4099);
+
+	// The prototype batch is copied.
+	const EntityID copies[2] = { 8, 4 };
+	storage.insert_from_prototype(7, copies, 2);
+	CHECK(storage.get_batch_size(8) == 70);
+	CHECK(storage.get_batch_size(4) == 70);
+	CHECK(std::as_const(storage).get(8)[35].number == 35);
+	CHECK(std::as_const(storage).get(4)[69].number == 69);
+
+	// After the clear the arena is reused.
+	storage.clear();
+	CHECK(storage.has(0) == false);
+	CHECK(storage.has(7) == false);
+	for (uint32_t e = 0; e < 3; e += 1) {
+		for (int i = 0; i < 40; i += 1) {
+			storage.insert(e, TestBatchInt(int(e) + i));
+		}
+	}
+	for (uint32_t e = 0; e < 3; e += 1) {
+		CHECK(storage.get_batch_size(e) == 40);
+		CHECK(std::as_const(storage).get(e)[39].number == int(e) + 39);
+	}
+}
+
+TEST_CASE("[Modules][ECS] Test batch storage snapshot keeps the whole batches.") {
+	ECS::register_component<TestBatchSnapshot>();
+	const godex::component_id id = TestBatchSnapshot::get_component_id();
+
+	BatchStorage<DenseVector, -1, TestBatchSnapshot, true> storage;
+	for (int i = 0; i < 40; i += 1) {
+		storage.insert(1, TestBatchSnapshot(i));
+	}
+	storage.insert(4, TestBatchSnapshot(100));
+
+	LocalVector<uint8_t> buffer;
+	SnapshotWriter writer(buffer);
+	storage.save_snapshot(writer, id);
+
+	BatchStorage<DenseVector, -1, TestBatchSnapshot, true> loaded;
+	SnapshotReader reader(buffer.ptr(), buffer.size());
+	CHECK(loaded.load_snapshot(reader, id));
+
+	CHECK(loaded.get_batch_size(1) == 40);
+	CHECK(loaded.get_batch_size(4) == 1);
+	for (int i = 0; i < 40; i += 1) {
+		CHECK(std::as_const(loaded).get(1)[i].number == i);
+	}
+	CHECK(std::as_const(loaded).get(4)[0].number == 100);
+}
+
+TEST_CASE("[Modules][ECS] Test batch storage fork goes through the snapshot.") {
+	ECS::register_component<TestBatchSnapshot>();
+	const godex::component_id id = TestBatchSnapshot::get_component_id();
+
+	BatchStorage<DenseVector, -1, TestBatchSnapshot, true> storage;
+	CHECK(storage.is_forkable());
+	for (int i = 0; i < 40; i += 1) {
+		storage.insert(1, TestBatchSnapshot(i));
+	}
+
+	storage.fork(id);
+
+	storage.insert(1, TestBatchSnapshot(40));
+	storage.get(1)[0].number = 100;
+	storage.insert(4, TestBatchSnapshot(4));
+
+	storage.restore_fork(0, id);
+	CHECK(storage.has(4) == false);
+	CHECK(storage.get_batch_size(1) == 40);
+	for (int i = 0; i < 40; i += 1) {
+		CHECK(std::as_const(storage).get(1)[i].number == i);
+	}
+	storage.release_forks(1);
+}
+} // namespace godex_storage_batch_tests
+
+#endif // TEST_ECS_STORAGE_BATCH_H
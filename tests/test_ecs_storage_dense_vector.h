@@ -5,6 +5,7 @@
 
 #include "../components/component.h"
 #include "../storage/dense_vector_storage.h"
+#include "../storage/paged_sparse_index.h"
 
 namespace godex_storage_dense_vector_tests {
 
@@ -112,6 +113,143 @@ TEST_CASE("[Modules][ECS] Test dense storage insert and remove.") {
 		}
 	}
 }
+
+TEST_CASE("[Modules][ECS] Test PagedSparseIndex allocates only the used pages.") {
+	PagedSparseIndex index;
+	CHECK(index.get_pages_count() == 0);
+	CHECK(index.has(0) == false);
+	CHECK(index.get(5000000) == PagedSparseIndex::NONE);
+
+	// A high index allocates just its page.
+	index.set(5000000, 0);
+	index.set(5000001, 1);
+	CHECK(index.get_pages_count() == 1);
+	CHECK(index.get(5000000) == 0);
+	CHECK(index.get(5000001) == 1);
+	CHECK(index.has(0) == false);
+	CHECK(index.has(4999999) == false);
+
+	index.set(3, 2);
+	CHECK(index.get_pages_count() == 2);
+
+	index.update(3, 7);
+	CHECK(index.get(3) == 7);
+
+	// The pages are released once empty.
+	index.erase(5000000);
+	CHECK(index.get_pages_count() == 2);
+	index.erase(5000001);
+	CHECK(index.get_pages_count() == 1);
+	CHECK(index.has(5000001) == false);
+	index.erase(3);
+	CHECK(index.get_pages_count() == 0);
+
+	// A clear keeps the empty pages, so they are not reallocated.
+	index.set(3, 0);
+	index.set(5000000, 1);
+	index.erase(3, false);
+	index.erase(5000000, false);
+	CHECK(index.get_pages_count() == 2);
+	CHECK(index.has(3) == false);
+	CHECK(index.has(5000000) == false);
+	index.set(5000000, 2);
+	CHECK(index.get_pages_count() == 2);
+	CHECK(index.get(5000000) == 2);
+
+	// The storage keeps working with sparse high indices.
+	DenseVectorStorage<TestInt> storage;
+	storage.insert(4000000, TestInt(1));
+	storage.insert(10, TestInt(2));
+	CHECK(storage.has(4000000));
+	CHECK(storage.has(10));
+	CHECK(storage.has(11) == false);
+	CHECK(storage.get(4000000)->number == 1);
+	storage.remove(4000000);
+	CHECK(storage.has(4000000) == false);
+	CHECK(storage.get(10)->number == 2);
+}
+
+TEST_CASE("[Modules][ECS] Test DenseVectorStorage fork and restore.") {
+	DenseVectorStorage<TestInt> storage;
+
+	// Spans many fork pages.
+	const uint32_t count = DenseVector<TestInt>::FORK_PAGE_SIZE * 3;
+	for (uint32_t i = 0; i < count; i += 1) {
+		storage.insert(i, TestInt(i));
+	}
+
+	storage.fork(0);
+
+	storage.get(0)->number = 100;
+	storage.remove(5);
+	storage.insert(count, TestInt(count));
+
+	storage.fork(0);
+
+	storage.get(count - 1)->number = 200;
+	storage.remove(0);
+	storage.clear();
+	storage.insert(10000, TestInt(1));
+
+	// Back to the second fork.
+	storage.restore_fork(1, 0);
+	CHECK(storage.get(0)->number == 100);
+	CHECK(storage.has(5) == false);
+	CHECK(storage.get(count)->number == int(count));
+	CHECK(storage.get(count - 1)->number == int(count - 1));
+	CHECK(storage.has(10000) == false);
+
+	// The restored fork is still alive, so it's possible to restore it again.
+	storage.get(1)->number = 300;
+	storage.restore_fork(1, 0);
+	CHECK(storage.get(1)->number == 1);
+
+	// Back to the first fork.
+	storage.restore_fork(0, 0);
+	CHECK(storage.get_stored_entities().count == count);
+	CHECK(storage.has(count) == false);
+	for (uint32_t i = 0; i < count; i += 1) {
+		CHECK(storage.get(i)->number == int(i));
+	}
+
+	// Once released, the changes are not tracked anymore.
+	storage.release_forks(1);
+	storage.get(0)->number = 400;
+	CHECK(storage.get(0)->number == 400);
+}
+
+TEST_CASE("[Modules][ECS] Test DenseVectorStorage restore notifies the dropped components.") {
+	DenseVectorStorage<TestInt> storage;
+	for (uint32_t i = 0; i < 10; i += 1) {
+		storage.insert(i, TestInt(i));
+	}
+
+	storage.fork(0);
+
+	storage.insert(20, TestInt(20));
+	// The last component is moved into the slot `3`.
+	storage.remove(3);
+	storage.insert(21, TestInt(21));
+
+	ChangeRecorder recorder;
+	storage.add_change_recorder(&recorder);
+
+	storage.restore_fork(0, 0);
+	storage.remove_change_recorder(&recorder);
+
+	// The components added after the fork are dropped.
+	CHECK(storage.has(20) == false);
+	CHECK(storage.has(21) == false);
+	CHECK(recorder.removed.has(20));
+	CHECK(recorder.removed.has(21));
+	CHECK(storage.get_change_ticks().get_tick(20) == 0);
+	CHECK(storage.get_change_ticks().get_tick(21) == 0);
+
+	// The restored components are changed.
+	CHECK(storage.get(3)->number == 3);
+	CHECK(recorder.changed.has(3));
+	CHECK(recorder.removed.has(3) == false);
+}
 } // namespace godex_storage_dense_vector_tests
 
 #endif
@@ -6,6 +6,7 @@
 #include "../components/child.h"
 #include "../modules/godot/components/transform_component.h"
 #include "../storage/hierarchical_storage.h"
+#include "../utils/thread_pool.h"
 
 namespace godex_storage_hierarchical_tests {
 
@@ -220,6 +221,54 @@ TEST_CASE("[Modules][ECS] Test Hierarchy.") {
 	}
 }
 
+TEST_CASE("[Modules][ECS] Test Hierarchy unlink in the middle of the siblings.") {
+	Hierarchy hierarchy;
+
+	// Entity 0
+	//  |- Entity 5, 4, 3, 2, 1 (the last inserted is the first child).
+	for (uint32_t i = 1; i <= 5; i += 1) {
+		hierarchy.insert(i, Child(0));
+	}
+
+	// Move the `Entity 3`, that is in the middle of the siblings.
+	hierarchy.insert(3, Child(10));
+	// Remove the first and the last child.
+	hierarchy.remove(5);
+	hierarchy.remove(1);
+
+	LocalVector<EntityID> children;
+	EntityID prev;
+	hierarchy.for_each_child(0, [&](EntityID p_entity, const Child &p_child) -> bool {
+		CHECK(p_child.parent == EntityID(0));
+		CHECK(p_child.prev == prev);
+		prev = p_entity;
+		children.push_back(p_entity);
+		return true;
+	});
+	CHECK(children.size() == 2);
+	CHECK(children[0] == EntityID(4));
+	CHECK(children[1] == EntityID(2));
+
+	{
+		const Child *child = hierarchy.get(3);
+		CHECK(child->parent == EntityID(10));
+		CHECK(child->prev.is_null());
+		CHECK(child->next.is_null());
+		CHECK(hierarchy.get(10)->first_child == EntityID(3));
+	}
+
+	// Make `Entity 3` root: `Entity 10` has no more relations.
+	hierarchy.insert(3, Child());
+	CHECK(hierarchy.has(3) == false);
+	CHECK(hierarchy.has(10) == false);
+
+	// Remove the parent: the children have no more relations.
+	hierarchy.remove(0);
+	CHECK(hierarchy.has(0) == false);
+	CHECK(hierarchy.has(2) == false);
+	CHECK(hierarchy.has(4) == false);
+}
+
 TEST_CASE("[Modules][ECS] Test HierarchicalStorage.") {
 	Hierarchy hierarchy;
 
@@ -362,6 +411,131 @@ TEST_CASE("[Modules][ECS] Test HierarchicalStorage.") {
 		CHECK(entities.count == 5);
 	}
 }
+TEST_CASE("[Modules][ECS] Test HierarchicalStorage breadth first propagation.") {
+	ThreadPool thread_pool;
+	thread_pool.set_threads_count(3);
+
+	Hierarchy hierarchy;
+	hierarchy.set_thread_pool(&thread_pool);
+
+	// Both storages store the same data, using a different propagation.
+	HierarchicalStorage<TransformComponent> recursive_storage;
+	HierarchicalStorage<TransformComponent> breadth_first_storage;
+	{
+		Dictionary config;
+		config["breadth_first"] = true;
+		breadth_first_storage.configure(config);
+	}
+	hierarchy.add_sub_storage(&recursive_storage);
+	hierarchy.add_sub_storage(&breadth_first_storage);
+
+	// The hierarchy is as follows, the levels are big enough to be combined
+	// in parallel:
+	// Entity 0
+	//  |- Entity 1 .. 1000
+	//  |   |- Entity 1001 .. 2000, one for each `Entity` of the previous level.
+	for (uint32_t i = 1; i <= 1000; i += 1) {
+		hierarchy.insert(i, Child(0));
+		hierarchy.insert(i + 1000, Child(i));
+	}
+
+	for (uint32_t i = 0; i <= 2000; i += 1) {
+		const TransformComponent t(Transform3D(Basis(), Vector3(1, real_t(i), 0)));
+		recursive_storage.insert(i, t);
+		breadth_first_storage.insert(i, t);
+	}
+	hierarchy.flush_hierarchy_changes();
+
+	// Change the root and an `Entity` in the middle: its subtree is reached
+	// by both.
+	*recursive_storage.get(0) = Transform3D(Basis(), Vector3(5, 0, 0));
+	*breadth_first_storage.get(0) = Transform3D(Basis(), Vector3(5, 0, 0));
+	*recursive_storage.get(10) = Transform3D(Basis(), Vector3(2, 0, 0));
+	*breadth_first_storage.get(10) = Transform3D(Basis(), Vector3(2, 0, 0));
+	// Change a global too.
+	*recursive_storage.get(1500, Space::GLOBAL) = Transform3D(Basis(), Vector3(0, 0, 9));
+	*breadth_first_storage.get(1500, Space::GLOBAL) = Transform3D(Basis(), Vector3(0, 0, 9));
+
+	recursive_storage.flush_changes();
+	breadth_first_storage.flush_changes();
+
+	{
+		const TransformComponent *global_1010 = std::as_const(breadth_first_storage).get(1010, Space::GLOBAL);
+		CHECK(ABS(global_1010->origin[0] - 8.) <= CMP_EPSILON);
+		CHECK(ABS(global_1010->origin[1] - 1010.) <= CMP_EPSILON);
+
+		const TransformComponent *global_1500 = std::as_const(breadth_first_storage).get(1500, Space::GLOBAL);
+		CHECK(ABS(global_1500->origin[2] - 9.) <= CMP_EPSILON);
+	}
+
+	bool same = true;
+	for (uint32_t i = 0; i <= 2000; i += 1) {
+		const TransformComponent *a = std::as_const(recursive_storage).get(i, Space::GLOBAL);
+		const TransformComponent *b = std::as_const(breadth_first_storage).get(i, Space::GLOBAL);
+		const TransformComponent *a_local = std::as_const(recursive_storage).get(i);
+		const TransformComponent *b_local = std::as_const(breadth_first_storage).get(i);
+		same = same && a->is_equal_approx(*b) && a_local->is_equal_approx(*b_local);
+	}
+	CHECK(same);
+
+	// Change the hierarchy: `Entity 1` is now child of `Entity 2000`.
+	hierarchy.insert(1, Child(2000));
+	hierarchy.flush_hierarchy_changes();
+
+	{
+		const TransformComponent *a = std::as_const(recursive_storage).get(1001, Space::GLOBAL);
+		const TransformComponent *b = std::as_const(breadth_first_storage).get(1001, Space::GLOBAL);
+		CHECK(a->is_equal_approx(*b));
+		// Entity 0 (5) + Entity 1000 (1) + Entity 2000 (1) + Entity 1 (1) + Entity 1001 (1).
+		CHECK(ABS(b->origin[0] - 9.) <= CMP_EPSILON);
+	}
+
+	hierarchy.set_thread_pool(nullptr);
+}
+
+TEST_CASE("[Modules][ECS] Test Hierarchy and HierarchicalStorage fork and restore.") {
+	Hierarchy hierarchy;
+	HierarchicalStorage<TransformComponent> transform_storage;
+	hierarchy.add_sub_storage(&transform_storage);
+
+	// Entity 0
+	// |- Entity 1
+	hierarchy.insert(1, Child(0));
+	transform_storage.insert(0, TransformComponent(Transform3D(Basis(), Vector3(1, 0, 0))));
+	transform_storage.insert(1, TransformComponent(Transform3D(Basis(), Vector3(1, 0, 0))));
+	hierarchy.flush_hierarchy_changes();
+
+	hierarchy.fork(0);
+	transform_storage.fork(0);
+
+	// Move the entity 1 under the new entity 2, and move the root.
+	hierarchy.insert(2, Child(0));
+	hierarchy.insert(1, Child(2));
+	transform_storage.insert(2, TransformComponent(Transform3D(Basis(), Vector3(5, 0, 0))));
+	transform_storage.get(0)->origin.x = 10;
+	hierarchy.flush_hierarchy_changes();
+
+	CHECK(ABS(std::as_const(transform_storage).get(1, Space::GLOBAL)->origin.x - 16.) <= CMP_EPSILON);
+	CHECK(std::as_const(hierarchy).get(1)->parent == EntityID(2));
+
+	hierarchy.restore_fork(0, 0);
+	transform_storage.restore_fork(0, 0);
+
+	// The structure and the global data are restored as they were.
+	CHECK(hierarchy.has(2) == false);
+	CHECK(std::as_const(hierarchy).get(1)->parent == EntityID(0));
+	CHECK(std::as_const(hierarchy).get(0)->first_child == EntityID(1));
+	CHECK(std::as_const(hierarchy).get(1)->next.is_null());
+	CHECK(transform_storage.has(2) == false);
+	CHECK(ABS(std::as_const(transform_storage).get(0)->origin.x - 1.) <= CMP_EPSILON);
+	CHECK(ABS(std::as_const(transform_storage).get(1, Space::GLOBAL)->origin.x - 2.) <= CMP_EPSILON);
+
+	// The propagation keeps working after the restore.
+	transform_storage.get(0)->origin.x = 3;
+	transform_storage.flush_changes();
+	CHECK(ABS(std::as_const(transform_storage).get(1, Space::GLOBAL)->origin.x - 4.) <= CMP_EPSILON);
+}
+
 // TODO test hierarchy sorting?
 } // namespace godex_storage_hierarchical_tests
 
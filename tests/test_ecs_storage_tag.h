@@ -0,0 +1,145 @@
+#ifndef TEST_ECS_STORAGE_TAG_H
+#define TEST_ECS_STORAGE_TAG_H
+
+#include "tests/test_macros.h"
+
+#include "../components/component.h"
+#include "../ecs.h"
+#include "../iterators/query.h"
+#include "../storage/tag_storage.h"
+#include "../world/world.h"
+
+namespace godex_storage_tag_tests {
+
+struct TestTagA {
+	COMPONENT(TestTagA, TagStorage)
+	static void _bind_methods() {}
+};
+
+struct TestTagB {
+	COMPONENT(TestTagB, TagStorage)
+	static void _bind_methods() {}
+};
+
+TEST_CASE("[Modules][ECS] Test tag storage insert and remove.") {
+	TagStorage<TestTagA> storage;
+
+	for (uint32_t i = 0; i < 300; i += 3) {
+		storage.insert(EntityID(i, 1), TestTagA());
+	}
+	CHECK(storage.has(0));
+	CHECK(storage.has(1) == false);
+	CHECK(storage.has(297));
+	CHECK(storage.has(298) == false);
+	// Never stored, far after the last word.
+	CHECK(storage.has(10000) == false);
+
+	storage.remove(EntityID(3, 1));
+	storage.remove(EntityID(297, 1));
+	CHECK(storage.has(3) == false);
+
+	// The list is sorted by index, and keeps the generations.
+	const EntitiesBuffer entities = storage.get_stored_entities();
+	CHECK(entities.count == 98);
+	CHECK(entities.entities[0] == EntityID(0, 1));
+	CHECK(entities.entities[1] == EntityID(6, 1));
+	CHECK(entities.entities[97] == EntityID(294, 1));
+
+	storage.clear();
+	CHECK(storage.has(0) == false);
+	CHECK(storage.get_stored_entities().count == 0);
+}
+
+TEST_CASE("[Modules][ECS] Test tag storage snapshot.") {
+	TagStorage<TestTagA> storage;
+	storage.insert(EntityID(2, 1), TestTagA());
+	storage.insert(EntityID(70, 3), TestTagA());
+
+	LocalVector<uint8_t> buffer;
+	SnapshotWriter writer(buffer);
+	storage.save_snapshot(writer, 0);
+
+	{
+		// The tags are loaded with their generations.
+		TagStorage<TestTagA> loaded;
+		SnapshotReader reader(buffer.ptr(), buffer.size());
+		CHECK(loaded.load_snapshot(reader, 0));
+		const EntitiesBuffer entities = loaded.get_stored_entities();
+		CHECK(entities.count == 2);
+		CHECK(entities.entities[0] == EntityID(2, 1));
+		CHECK(entities.entities[1] == EntityID(70, 3));
+	}
+
+	{
+		// The snapshot is never merged into the stored tags.
+		TagStorage<TestTagA> loaded;
+		loaded.insert(EntityID(5, 1), TestTagA());
+		SnapshotReader reader(buffer.ptr(), buffer.size());
+		ERR_PRINT_OFF;
+		CHECK(loaded.load_snapshot(reader, 0) == false);
+		ERR_PRINT_ON;
+		CHECK(loaded.has(5));
+		CHECK(loaded.has(2) == false);
+		CHECK(loaded.get_stored_entities().count == 1);
+	}
+}
+
+TEST_CASE("[Modules][ECS] Test Query with tag storages.") {
+	ECS::register_component<TestTagA>();
+	ECS::register_component<TestTagB>();
+
+	World world;
+
+	LocalVector<EntityID> entities;
+	for (uint32_t i = 0; i < 200; i += 1) {
+		const EntityID entity = world.create_entity();
+		entities.push_back(entity);
+		if (i % 2 == 0) {
+			world.add_component(entity, TestTagA());
+		}
+		if (i % 3 == 0) {
+			world.add_component(entity, TestTagB());
+		}
+	}
+
+	{
+		// The bitsets are intersected.
+		Query<EntityID, const TestTagA, const TestTagB> query(&world);
+		query.initiate_process(&world);
+
+		uint32_t count = 0;
+		for (auto [entity, a, b] : query) {
+			CHECK(a != nullptr);
+			CHECK(b != nullptr);
+			CHECK(world.get_storage<const TestTagA>()->has(entity));
+			CHECK(world.get_storage<const TestTagB>()->has(entity));
+			count += 1;
+		}
+		CHECK(count == 34);
+		query.conclude_process(&world);
+	}
+
+	{
+		Query<EntityID, const TestTagA, Not<TestTagB>> query(&world);
+		query.initiate_process(&world);
+		CHECK(query.count() == 66);
+		query.conclude_process(&world);
+	}
+
+	// Flip the tags, the entity list is rebuilt.
+	Storage<TestTagA> *storage_a = world.get_storage<TestTagA>();
+	storage_a->remove(entities[0]);
+	storage_a->insert(entities[3], TestTagA());
+
+	{
+		Query<EntityID, const TestTagA, const TestTagB> query(&world);
+		query.initiate_process(&world);
+		CHECK(query.has(entities[0]) == false);
+		CHECK(query.has(entities[3]));
+		CHECK(query.count() == 34);
+		query.conclude_process(&world);
+	}
+}
+} // namespace godex_storage_tag_tests
+
+#endif // TEST_ECS_STORAGE_TAG_H
@@ -12,6 +12,7 @@
 #include "../pipeline/pipeline_builder.h"
 #include "../storage/dense_vector_storage.h"
 #include "../systems/dynamic_system.h"
+#include "../world/command_buffer.h"
 #include "../world/world.h"
 #include "test_utilities.h"
 
@@ -76,6 +77,14 @@ public:
 	}
 };
 
+class TestSubCommandsDatabag : public godex::Databag {
+	DATABAG(TestSubCommandsDatabag)
+
+public:
+	/// The `Entities` seen by the sub dispatcher `System`.
+	int seen_entities = 0;
+};
+
 namespace godex_tests_system {
 
 void test_system_tag(Query<TransformComponent, const TagTestComponent> &p_query) {
@@ -614,6 +623,128 @@ TEST_CASE("[Modules][ECS] Test create and remove Entity from Systems.") {
 	}
 }
 
+void test_command_buffer_spawn(CommandBuffer &p_commands) {
+	for (uint32_t i = 0; i < 3; i += 1) {
+		const EntityID id = p_commands.create_entity();
+		p_commands.insert(id, TransformComponent());
+	}
+}
+
+void test_command_buffer_despawn(CommandBuffer &p_commands, Query<EntityID, const TransformComponent> &p_query) {
+	for (auto [entity, _t] : p_query) {
+		p_commands.destroy(entity);
+	}
+}
+
+TEST_CASE("[Modules][ECS] Test CommandBuffer skips the destroyed Entities.") {
+	World world;
+	CommandBuffer buffer;
+	world.add_command_buffer(&buffer);
+
+	// Destroyed by a previous command of the same buffer.
+	const EntityID destroyed = buffer.create_entity();
+	buffer.destroy(destroyed);
+	buffer.insert(destroyed, TransformComponent());
+
+	// The index is reused by another `Entity`.
+	const EntityID stale = world.create_entity();
+	world.destroy_entity(stale);
+	const EntityID reused = world.create_entity();
+	CHECK(reused.get_index() == stale.get_index());
+	world.add_component(reused, TransformComponent());
+	buffer.remove<TransformComponent>(stale);
+	buffer.insert(stale, TransformComponent());
+
+	world.flush_command_buffers();
+
+	CHECK(world.is_entity_alive(destroyed) == false);
+	CHECK(world.is_entity_alive(reused));
+	CHECK(world.get_storage<TransformComponent>()->get_stored_entities().count == 1);
+	CHECK(world.get_storage<TransformComponent>()->has(reused));
+	CHECK(world.get_storage<TransformComponent>()->has(destroyed) == false);
+}
+
+TEST_CASE("[Modules][ECS] Test create and remove Entity using the CommandBuffer.") {
+	godex::system_id spawn_system_id = ECS::register_system(test_command_buffer_spawn, "test_command_buffer_spawn").get_id();
+	godex::system_id despawn_system_id = ECS::register_system(test_command_buffer_despawn, "test_command_buffer_despawn").get_id();
+
+	// The `CommandBuffer` doesn't touch the storages, so it can run in parallel
+	// with the `System`s that read the same components.
+	CHECK(ECS::can_systems_run_in_parallel(spawn_system_id, despawn_system_id));
+
+	World world;
+
+	PipelineBuilder pipeline_builder;
+	pipeline_builder.add_system(spawn_system_id);
+	pipeline_builder.add_system(despawn_system_id);
+
+	Pipeline pipeline;
+	pipeline_builder.build(pipeline);
+	Token token = pipeline.prepare_world(&world);
+	pipeline.set_active(token, true);
+
+	for (uint32_t i = 0; i < 5; i += 1) {
+		pipeline.dispatch(token);
+
+		// The commands are already applied at the end of the stage: the
+		// `Entities` spawned in the previous dispatch are destroyed, and the
+		// new one are created.
+		Query<EntityID, const TransformComponent> query(&world);
+		query.initiate_process(&world);
+
+		uint32_t count = 0;
+		for (auto [entity, _t] : query) {
+			CHECK(world.is_entity_alive(entity));
+			count += 1;
+		}
+		CHECK(count == 3);
+	}
+
+	{
+		// The destroyed `Entity` IDs are reused, so the IDs never grow.
+		const EntityID entity = world.get_commands().create_entity();
+		CHECK(entity.get_index() < 6);
+	}
+}
+
+uint32_t test_sub_commands_execute(TestSubCommandsDatabag *p_bag) {
+	return 3;
+}
+
+void test_sub_commands_spawn(CommandBuffer &p_commands, TestSubCommandsDatabag *p_bag, Query<const TransformComponent> &p_query) {
+	p_bag->seen_entities += p_query.count();
+	p_commands.insert(p_commands.create_entity(), TransformComponent());
+}
+
+TEST_CASE("[Modules][ECS] Test the CommandBuffer of a sub dispatcher is applied by the main stage.") {
+	ECS::register_databag<TestSubCommandsDatabag>();
+	ECS::register_system_dispatcher(test_sub_commands_execute, "test_sub_commands_execute");
+	ECS::register_system(test_sub_commands_spawn, "test_sub_commands_spawn")
+			.execute_in(PHASE_PROCESS, "test_sub_commands_execute");
+
+	Vector<StringName> system_bundles;
+	Vector<StringName> systems;
+	systems.push_back(StringName("test_sub_commands_execute"));
+	systems.push_back(StringName("test_sub_commands_spawn"));
+
+	Pipeline pipeline;
+	PipelineBuilder::build_pipeline(system_bundles, systems, &pipeline);
+
+	World world;
+	Token token = pipeline.prepare_world(&world);
+	pipeline.set_active(token, true);
+
+	// The sub dispatcher runs 3 times, its commands are applied only once the
+	// main stage is done.
+	pipeline.dispatch(token);
+	CHECK(world.get_databag<TestSubCommandsDatabag>()->seen_entities == 0);
+	CHECK(world.get_storage<TransformComponent>()->get_stored_entities().count == 3);
+
+	pipeline.dispatch(token);
+	CHECK(world.get_databag<TestSubCommandsDatabag>()->seen_entities == 9);
+	CHECK(world.get_storage<TransformComponent>()->get_stored_entities().count == 6);
+}
+
 TEST_CASE("[Modules][ECS] Test system and hierarchy.") {
 	World world;
 
@@ -1226,6 +1357,42 @@ TEST_CASE("[Modules][ECS] Test `Events` class is able to fetch the emitter name.
 	}
 }
 
+TEST_CASE("[Modules][ECS] Test `EventStorage` interned emitters.") {
+	// The same name always returns the same id.
+	const godex::emitter_id id = get_emitter_id<EMITTER(InternTest1)>();
+	CHECK(id == EventEmitters::intern("InternTest1"));
+	CHECK(id == EventEmitters::get_id("InternTest1"));
+	CHECK(EventEmitters::get_name(id) == String("InternTest1"));
+	CHECK(EventEmitters::get_id("InternTestNeverUsed") == godex::EMITTER_NONE);
+
+	EventStorage<MyEvent1Test> storage;
+	storage.add_event_emitter("InternTest1");
+	storage.add_event_emitter("InternTest2");
+	CHECK(storage.has_emitter(id));
+	CHECK(storage.has_emitter("InternTest2"));
+
+	MyEvent1Test e;
+	for (uint32_t i = 0; i < 100; i += 1) {
+		e.a = i;
+		// Both the interned and the `String` versions store in the same place.
+		storage.add_event(id, e);
+		storage.add_event("InternTest2", e);
+	}
+	CHECK(storage.get_events(id)->size() == 100);
+	CHECK(storage.get_events("InternTest1")->size() == 100);
+	CHECK(storage.get_events("InternTest2")->size() == 100);
+	CHECK((*storage.get_events(id))[99].a == 99);
+
+	// The flush doesn't release the memory, so it's reused.
+	const MyEvent1Test *memory = storage.get_events(id)->ptr();
+	storage.flush_events();
+	CHECK(storage.get_events(id)->size() == 0);
+	CHECK(storage.get_events("InternTest2")->size() == 0);
+
+	storage.add_event(id, e);
+	CHECK(storage.get_events(id)->ptr() == memory);
+}
+
 TEST_CASE("[Modules][ECS] Make sure the events storages are automatically created.") {
 	ECS::register_system(test_emit_event, "test_emit_event");
 	ECS::register_system(test_fetch_event, "test_fetch_event")
@@ -1499,4 +1666,188 @@ TEST_CASE("[Modules][ECS] Make sure the function `can_systems_run_in_parallel` w
 }
 } // namespace godex_tests
 
+struct MyEvent3Test {
+	EVENT(MyEvent3Test)
+
+	int a = 0;
+};
+
+void test3_shared_emit1_event(SharedEventsEmitter<MyEvent3Test> &p_emitter) {
+	for (int i = 0; i < 50; i += 1) {
+		MyEvent3Test e;
+		e.a = 1;
+		p_emitter.emit<EMITTER(Test1)>(e);
+	}
+}
+
+void test3_shared_emit2_event(SharedEventsEmitter<MyEvent3Test> &p_emitter) {
+	for (int i = 0; i < 50; i += 1) {
+		MyEvent3Test e;
+		e.a = 2;
+		p_emitter.emit<EMITTER(Test1)>(e);
+	}
+}
+
+void test3_emit_event(EventsEmitter<MyEvent3Test> &p_emitter) {}
+
+void test3_fetch_event(EventsReceiver<MyEvent3Test, EMITTER(Test1)> &p_events) {
+	int count_1 = 0;
+	int count_2 = 0;
+	for (const MyEvent3Test *e : p_events) {
+		if (e->a == 1) {
+			count_1 += 1;
+		} else if (e->a == 2) {
+			count_2 += 1;
+		}
+	}
+	CHECK(count_1 == 50);
+	CHECK(count_2 == 50);
+}
+
+namespace godex_tests {
+TEST_CASE("[Modules][ECS] Test SharedEventsEmitter from parallel systems.") {
+	ECS::register_event<MyEvent3Test>();
+	ECS::register_system(test3_shared_emit1_event, "test3_shared_emit1_event");
+	ECS::register_system(test3_shared_emit2_event, "test3_shared_emit2_event");
+	ECS::register_system(test3_emit_event, "test3_emit_event");
+	ECS::register_system(test3_fetch_event, "test3_fetch_event")
+			.after("test3_shared_emit1_event")
+			.after("test3_shared_emit2_event");
+
+	const godex::system_id emit1_id = ECS::get_system_id("test3_shared_emit1_event");
+	const godex::system_id emit2_id = ECS::get_system_id("test3_shared_emit2_event");
+
+	// The shared emitters of the same event can run in parallel.
+	CHECK(ECS::can_systems_run_in_parallel(emit1_id, emit2_id));
+	// But not with the exclusive emitter, nor with the receiver.
+	CHECK(!ECS::can_systems_run_in_parallel(emit1_id, ECS::get_system_id("test3_emit_event")));
+	CHECK(!ECS::can_systems_run_in_parallel(emit1_id, ECS::get_system_id("test3_fetch_event")));
+
+	Pipeline pipeline;
+	{
+		Vector<StringName> system_bundles;
+
+		Vector<StringName> systems;
+		systems.push_back("test3_shared_emit1_event");
+		systems.push_back("test3_shared_emit2_event");
+		systems.push_back("test3_fetch_event");
+
+		PipelineBuilder::build_pipeline(system_bundles, systems, &pipeline);
+	}
+	pipeline.set_threads_count(4);
+
+	// Both the emitters are in the first stage, the receiver in the next one.
+	CHECK(pipeline.get_system_stage(emit1_id) == 0);
+	CHECK(pipeline.get_system_stage(emit2_id) == 0);
+	CHECK(pipeline.get_system_stage(ECS::get_system_id("test3_fetch_event")) == 1);
+
+	World world;
+	Token token = pipeline.prepare_world(&world);
+
+	int first_system_value = 0;
+	for (uint32_t i = 0; i < 3; i += 1) {
+		// The events are flushed each frame, so the receiver always gets 100 events.
+		pipeline.dispatch(token);
+		const LocalVector<MyEvent3Test> *events = world.get_events_storage<MyEvent3Test>()->get_events("Test1");
+		CHECK(events->size() == 100);
+
+		// The events are merged in `System` order, whatever thread run them.
+		if (i == 0) {
+			first_system_value = (*events)[0].a;
+		}
+		for (uint32_t e = 0; e < events->size(); e += 1) {
+			CHECK((*events)[e].a == (e < 50 ? first_system_value : 3 - first_system_value));
+		}
+	}
+
+	pipeline.release_world(token);
+}
+} // namespace godex_tests
+
+struct MyPersistentEventTest {
+	PERSISTENT_EVENT(MyPersistentEventTest)
+
+	int a = 0;
+};
+
+namespace godex_tests {
+TEST_CASE("[Modules][ECS] Test persistent EventStorage with read cursors.") {
+	ECS::register_event<MyPersistentEventTest>();
+
+	EventStorageBase *storage_base = ECS::create_events_storage(MyPersistentEventTest::get_event_id());
+	EventStorage<MyPersistentEventTest> *storage = static_cast<EventStorage<MyPersistentEventTest> *>(storage_base);
+	CHECK(storage->is_persistent());
+
+	storage->add_event_emitter("PersistentTest1");
+	const godex::emitter_id id = EventEmitters::get_id("PersistentTest1");
+
+	EventReader fast_reader;
+	EventReader slow_reader;
+	storage->add_reader(&fast_reader, id);
+	storage->add_reader(&slow_reader, id);
+
+	MyPersistentEventTest e;
+	uint32_t count = 0;
+	for (int frame = 0; frame < 4; frame += 1) {
+		// The emitter flushes, then emits two events per frame.
+		storage->flush_events();
+		e.a = frame;
+		storage->add_event(id, e);
+		storage->add_event(id, e);
+
+		// The fast reader reads each frame, and gets only the new events.
+		const MyPersistentEventTest *events = storage->read(&fast_reader, count);
+		CHECK(count == 2);
+		CHECK(events[0].a == frame);
+		CHECK(events[1].a == frame);
+	}
+
+	// The slow reader didn't read yet, so nothing was dropped: it gets all the
+	// events exactly once.
+	{
+		const MyPersistentEventTest *events = storage->read(&slow_reader, count);
+		CHECK(count == 8);
+		CHECK(events[0].a == 0);
+		CHECK(events[7].a == 3);
+		storage->read(&slow_reader, count);
+		CHECK(count == 0);
+	}
+
+	// Now that both the readers read everything, the flush drops the events.
+	storage->flush_events();
+	CHECK(storage->get_events(id)->size() == 0);
+
+	// When a reader is behind, only the consumed events are dropped.
+	e.a = 10;
+	storage->add_event(id, e);
+	storage->read(&fast_reader, count);
+	e.a = 11;
+	storage->add_event(id, e);
+	storage->flush_events();
+	CHECK(storage->get_events(id)->size() == 2);
+	{
+		const MyPersistentEventTest *events = storage->read(&fast_reader, count);
+		CHECK(count == 1);
+		CHECK(events[0].a == 11);
+	}
+	storage->flush_events();
+	CHECK(storage->get_events(id)->size() == 2);
+	{
+		const MyPersistentEventTest *events = storage->read(&slow_reader, count);
+		CHECK(count == 2);
+		CHECK(events[0].a == 10);
+		CHECK(events[1].a == 11);
+	}
+	storage->flush_events();
+	CHECK(storage->get_events(id)->size() == 0);
+
+	storage->remove_reader(&fast_reader);
+	CHECK(fast_reader.attached == false);
+
+	// The storage detaches the remaining readers when destroyed.
+	ECS::destroy_events_storage(MyPersistentEventTest::get_event_id(), storage_base);
+	CHECK(slow_reader.attached == false);
+}
+} // namespace godex_tests
+
 #endif // TEST_ECS_SYSTEM_H
@@ -3,11 +3,17 @@
 
 #include "tests/test_macros.h"
 
+#include "../components/dynamic_component.h"
 #include "../ecs.h"
+#include "../modules/godot/components/disabled.h"
+#include "../modules/godot/components/interpolated_transform_component.h"
 #include "../modules/godot/components/transform_component.h"
 #include "../modules/godot/databags/scene_tree_databag.h"
 #include "../modules/godot/nodes/ecs_world.h"
 #include "../modules/godot/nodes/entity.h"
+#include "../storage/dense_vector_storage.h"
+#include "../storage/snapshot.h"
+#include "../storage/steady_storage.h"
 #include "../world/world.h"
 
 struct Test1Databag : public godex::Databag {
@@ -19,6 +25,13 @@ public:
 
 namespace godex_tests_world {
 
+struct TestWorldSteadyComponent {
+	COMPONENT(TestWorldSteadyComponent, SteadyStorage)
+	static void _bind_methods() {}
+
+	int value = 0;
+};
+
 TEST_CASE("[Modules][ECS] Test world has self databag.") {
 	World world;
 	godex::Databag *commands_ptr = world.get_databag(WorldCommands::get_databag_id());
@@ -46,6 +59,96 @@ TEST_CASE("[Modules][ECS] Test world") {
 	CHECK((entity_1_transform_component.origin - transform_from_storage->origin).length() < CMP_EPSILON);
 }
 
+TEST_CASE("[Modules][ECS] Test world reuses the destroyed Entity IDs.") {
+	World world;
+
+	const EntityID entity_1 = world.create_entity()
+									  .with(TransformComponent());
+	const EntityID entity_2 = world.create_entity()
+									  .with(TransformComponent());
+	CHECK(entity_1.get_generation() == 0);
+	CHECK(world.is_entity_alive(entity_1));
+	CHECK(world.is_entity_alive(entity_2));
+
+	world.destroy_entity(entity_1);
+	CHECK(world.is_entity_alive(entity_1) == false);
+	CHECK(world.is_entity_alive(entity_2));
+
+	// The index is reused, with a new generation.
+	const EntityID entity_3 = world.create_entity()
+									  .with(TransformComponent());
+	CHECK(entity_3.get_index() == entity_1.get_index());
+	CHECK(entity_3.get_generation() == 1);
+	CHECK((entity_3 == entity_1) == false);
+	CHECK(entity_3 != entity_1);
+	// Compared with a `uint32_t`, it's the full ID.
+	CHECK(entity_3 == entity_3.get_raw_id());
+	CHECK(entity_3 != entity_1.get_raw_id());
+	CHECK(entity_3 != entity_3.get_index());
+	CHECK(EntityID() == UINT32_MAX);
+	CHECK(world.is_entity_alive(entity_3));
+	CHECK(world.is_entity_alive(entity_1) == false);
+
+	// The stale `EntityID` doesn't destroy the new `Entity`.
+	ERR_PRINT_OFF;
+	world.destroy_entity(entity_1);
+	ERR_PRINT_ON;
+	CHECK(world.is_entity_alive(entity_3));
+	CHECK(world.get_storage<TransformComponent>()->has(entity_3));
+
+	// The full ID survives the conversion to `Variant`.
+	const Variant v = entity_3;
+	CHECK(EntityID(v) == entity_3);
+
+	// A new index is used only when there are no free ones.
+	const EntityID entity_4 = world.create_entity();
+	CHECK(entity_4.get_index() == 2);
+	CHECK(entity_4.get_generation() == 0);
+}
+
+TEST_CASE("[Modules][ECS] Test world batch operations.") {
+	World world;
+
+	const EntityID prototype = world.create_entity()
+									   .with(TransformComponent(Transform3D(Basis(), Vector3(1.0, 2.0, 3.0))));
+
+	LocalVector<EntityID> entities;
+	world.create_entities(100, prototype, entities);
+	CHECK(entities.size() == 100);
+
+	const Storage<const TransformComponent> *storage = world.get_storage<const TransformComponent>();
+	for (uint32_t i = 0; i < entities.size(); i += 1) {
+		CHECK(world.is_entity_alive(entities[i]));
+		CHECK((entities[i] == prototype) == false);
+		REQUIRE(storage->has(entities[i]));
+		CHECK(storage->get(entities[i])->origin.is_equal_approx(Vector3(1.0, 2.0, 3.0)));
+	}
+
+	// Set a different component to each `Entity`.
+	LocalVector<TransformComponent> transforms;
+	transforms.resize(entities.size());
+	for (uint32_t i = 0; i < transforms.size(); i += 1) {
+		transforms[i].origin.x = i;
+	}
+	world.add_component_batch(entities.ptr(), entities.size(), transforms.ptr());
+	for (uint32_t i = 0; i < entities.size(); i += 1) {
+		CHECK(Math::is_equal_approx(storage->get(entities[i])->origin.x, real_t(i)));
+	}
+
+	// Remove the component from the first half.
+	world.remove_component_batch<TransformComponent>(entities.ptr(), 50);
+	CHECK(storage->has(entities[0]) == false);
+	CHECK(storage->has(entities[49]) == false);
+	CHECK(storage->has(entities[50]));
+	CHECK(storage->has(prototype));
+
+	// And add it back, all with the same data.
+	world.add_component_copies(entities.ptr(), 50, TransformComponent());
+	CHECK(storage->has(entities[0]));
+	CHECK(storage->get(entities[0])->origin.is_equal_approx(Vector3()));
+	CHECK(Math::is_equal_approx(storage->get(entities[50])->origin.x, real_t(50)));
+}
+
 TEST_CASE("[Modules][ECS] Test storage script component") {
 	LocalVector<ScriptProperty> props;
 	props.push_back({ PropertyInfo(Variant::INT, "variable_1"), 1 });
@@ -194,6 +297,69 @@ TEST_CASE("[Modules][ECS] Test storage script component") {
 	}
 }
 
+TEST_CASE("[Modules][ECS] Test packed and Variant script component layouts.") {
+	// The fixed size types are stored natively, the others as `Variant`.
+	CHECK(DynamicComponentInfo::get_packed_type_size(Variant::FLOAT) == int(sizeof(double)));
+	CHECK(DynamicComponentInfo::get_packed_type_size(Variant::TRANSFORM3D) == int(sizeof(Transform3D)));
+	CHECK(DynamicComponentInfo::get_packed_type_size(Variant::STRING) == -1);
+
+	LocalVector<ScriptProperty> packed_props;
+	packed_props.push_back({ PropertyInfo(Variant::BOOL, "flag"), true });
+	packed_props.push_back({ PropertyInfo(Variant::FLOAT, "speed"), 1.5 });
+	packed_props.push_back({ PropertyInfo(Variant::VECTOR3, "direction"), Vector3(0, 1, 0) });
+	packed_props.push_back({ PropertyInfo(Variant::INT, "counter"), 7 });
+
+	LocalVector<ScriptProperty> variant_props;
+	variant_props.push_back({ PropertyInfo(Variant::INT, "counter"), 7 });
+	variant_props.push_back({ PropertyInfo(Variant::STRING, "label"), String("hello") });
+
+	const uint32_t packed_id = ECS::register_or_update_script_component(
+			"TestWorldPackedComponent.gd",
+			packed_props,
+			StorageType::DENSE_VECTOR,
+			Vector<StringName>());
+	const uint32_t variant_id = ECS::register_or_update_script_component(
+			"TestWorldVariantComponent.gd",
+			variant_props,
+			StorageType::DENSE_VECTOR,
+			Vector<StringName>());
+
+	World world;
+	const EntityID entity = world.create_entity();
+	world.add_component(entity, packed_id, Dictionary());
+	world.add_component(entity, variant_id, Dictionary());
+
+	// Both the layouts are initialized with the defaults.
+	void *packed = world.get_storage(packed_id)->get_ptr(entity);
+	void *variant = world.get_storage(variant_id)->get_ptr(entity);
+	CHECK(ECS::unsafe_component_get_by_name(packed_id, packed, "flag") == Variant(true));
+	CHECK(ECS::unsafe_component_get_by_name(packed_id, packed, "speed") == Variant(1.5));
+	CHECK(ECS::unsafe_component_get_by_name(packed_id, packed, "direction") == Variant(Vector3(0, 1, 0)));
+	CHECK(ECS::unsafe_component_get_by_name(packed_id, packed, "counter") == Variant(7));
+	CHECK(ECS::unsafe_component_get_by_name(variant_id, variant, "label") == Variant(String("hello")));
+
+	// The index accessors work on both the layouts.
+	Variant value;
+	CHECK(ECS::unsafe_component_set_by_index(packed_id, packed, 1, 3.0));
+	CHECK(ECS::unsafe_component_get_by_index(packed_id, packed, 1, value));
+	CHECK(value == Variant(3.0));
+	CHECK(ECS::unsafe_component_set_by_index(variant_id, variant, 1, String("world")));
+	CHECK(ECS::unsafe_component_get_by_index(variant_id, variant, 1, value));
+	CHECK(value == Variant(String("world")));
+
+	// Setting a value with a different type is refused, the value is untouched.
+	CHECK(ECS::unsafe_component_set_by_index(packed_id, packed, 3, 1.0) == false);
+	CHECK(ECS::unsafe_component_get_by_name(packed_id, packed, "counter") == Variant(7));
+
+	// Setting a property doesn't touch the nearby ones.
+	ECS::unsafe_component_set_by_name(packed_id, packed, "flag", false);
+	ECS::unsafe_component_set_by_name(packed_id, packed, "direction", Vector3(1, 2, 3));
+	CHECK(ECS::unsafe_component_get_by_name(packed_id, packed, "flag") == Variant(false));
+	CHECK(ECS::unsafe_component_get_by_name(packed_id, packed, "speed") == Variant(3.0));
+	CHECK(ECS::unsafe_component_get_by_name(packed_id, packed, "direction") == Variant(Vector3(1, 2, 3)));
+	CHECK(ECS::unsafe_component_get_by_name(packed_id, packed, "counter") == Variant(7));
+}
+
 TEST_CASE("[Modules][ECS] Test World NodePath.") {
 	World world;
 	EntityID entity_1 = world.create_entity();
@@ -217,6 +383,183 @@ TEST_CASE("[Modules][ECS] Test World NodePath.") {
 	CHECK(world.get_entity_path(entity_3) == node_3);
 }
 
+TEST_CASE("[Modules][ECS] Test World snapshot save and load.") {
+	LocalVector<uint8_t> snapshot;
+	EntityID entity_1;
+	EntityID entity_2;
+	EntityID entity_3;
+
+	{
+		World world;
+
+		entity_1 = world.create_entity()
+						   .with(TransformComponent(Transform3D(Basis(), Vector3(1.0, 0.0, 0.0))));
+
+		InterpolatedTransformComponent interpolated;
+		interpolated.current_linear_velocity = Vector3(0.0, 2.0, 0.0);
+		entity_2 = world.create_entity()
+						   .with(interpolated)
+						   .with(TransformComponent(Transform3D(Basis(), Vector3(2.0, 0.0, 0.0))));
+
+		// Destroy an `Entity`, so its index is reused with a new generation.
+		const EntityID destroyed = world.create_entity();
+		world.destroy_entity(destroyed);
+		entity_3 = world.create_entity();
+		world.add_component(entity_3, Disabled());
+		CHECK(entity_3.get_index() == destroyed.get_index());
+		CHECK((entity_3 == destroyed) == false);
+
+		world.save_snapshot(snapshot);
+	}
+
+	World world;
+	CHECK(world.load_snapshot(snapshot.ptr(), snapshot.size()) == OK);
+
+	CHECK(world.is_entity_alive(entity_1));
+	CHECK(world.is_entity_alive(entity_2));
+	CHECK(world.is_entity_alive(entity_3));
+
+	// The raw layout of the `HierarchicalStorage`.
+	const Storage<const TransformComponent> *transforms = world.get_storage<const TransformComponent>();
+	CHECK(transforms != nullptr);
+	CHECK(transforms->get(entity_1)->origin.x == 1.0);
+	CHECK(transforms->get(entity_2)->origin.x == 2.0);
+	CHECK(transforms->has(entity_3) == false);
+
+	// The raw layout.
+	const Storage<const InterpolatedTransformComponent> *interpolated = world.get_storage<const InterpolatedTransformComponent>();
+	CHECK(interpolated != nullptr);
+	CHECK(interpolated->has(entity_1) == false);
+	CHECK(interpolated->get(entity_2)->current_linear_velocity.y == 2.0);
+	CHECK(world.get_storage<const Disabled>()->has(entity_3));
+
+	// The new `Entities` don't overlap with the loaded ones.
+	const EntityID entity_4 = world.create_entity();
+	CHECK((entity_4 == entity_1) == false);
+	CHECK((entity_4 == entity_2) == false);
+	CHECK((entity_4 == entity_3) == false);
+
+	// The snapshot can't be loaded into a world with `Entities`.
+	ERR_PRINT_OFF;
+	CHECK(world.load_snapshot(snapshot.ptr(), snapshot.size()) == ERR_ALREADY_IN_USE);
+
+	// A truncated snapshot is rejected, and nothing is loaded.
+	World world_2;
+	CHECK(world_2.load_snapshot(snapshot.ptr(), snapshot.size() / 2) != OK);
+	ERR_PRINT_ON;
+	CHECK(world_2.is_entity_alive(entity_1) == false);
+	CHECK(world_2.get_storage<const TransformComponent>() == nullptr || world_2.get_storage<const TransformComponent>()->has(entity_1) == false);
+
+	// So the whole snapshot can still be loaded.
+	CHECK(world_2.load_snapshot(snapshot.ptr(), snapshot.size()) == OK);
+	CHECK(world_2.get_storage<const TransformComponent>()->get(entity_1)->origin.x == 1.0);
+}
+
+TEST_CASE("[Modules][ECS] Test the raw snapshot refuses the corrupted counts.") {
+	const godex::component_id id = InterpolatedTransformComponent::get_component_id();
+	const InterpolatedTransformComponent component;
+
+	{
+		// `sizeof(EntityID) * count` overflows to `0`.
+		LocalVector<uint8_t> buffer;
+		SnapshotWriter writer(buffer);
+		writer.write_u32(SNAPSHOT_FORMAT_RAW);
+		writer.write_u32(sizeof(InterpolatedTransformComponent));
+		writer.write_u32(0x80000000);
+		writer.write_raw(&component, sizeof(InterpolatedTransformComponent));
+
+		DenseVectorStorage<InterpolatedTransformComponent> storage;
+		SnapshotReader reader(buffer.ptr(), buffer.size());
+		ERR_PRINT_OFF;
+		CHECK(storage.load_snapshot(reader, id) == false);
+		ERR_PRINT_ON;
+		CHECK(storage.get_stored_entities().count == 0);
+	}
+
+	{
+		// The same `Entity` twice.
+		LocalVector<uint8_t> buffer;
+		SnapshotWriter writer(buffer);
+		writer.write_u32(SNAPSHOT_FORMAT_RAW);
+		writer.write_u32(sizeof(InterpolatedTransformComponent));
+		writer.write_u32(2);
+		const EntityID entities[2] = { EntityID(3, 0), EntityID(3, 0) };
+		writer.write_raw(entities, sizeof(EntityID) * 2);
+		writer.write_raw(&component, sizeof(InterpolatedTransformComponent));
+		writer.write_raw(&component, sizeof(InterpolatedTransformComponent));
+
+		DenseVectorStorage<InterpolatedTransformComponent> storage;
+		SnapshotReader reader(buffer.ptr(), buffer.size());
+		ERR_PRINT_OFF;
+		CHECK(storage.load_snapshot(reader, id) == false);
+		ERR_PRINT_ON;
+		CHECK(storage.get_stored_entities().count == 0);
+		CHECK(storage.has(3) == false);
+	}
+}
+
+TEST_CASE("[Modules][ECS] Test World fork and restore.") {
+	World world;
+
+	const EntityID entity_1 = world.create_entity()
+									  .with(TransformComponent(Transform3D(Basis(), Vector3(1.0, 0.0, 0.0))));
+
+	const uint32_t fork_1 = world.fork();
+
+	world.get_storage<TransformComponent>()->get(entity_1)->origin.x = 2.0;
+	const EntityID entity_2 = world.create_entity()
+									  .with(TransformComponent())
+									  .with(Disabled());
+
+	const uint32_t fork_2 = world.fork();
+	CHECK(world.get_forks_count() == 2);
+
+	world.destroy_entity(entity_1);
+	CHECK(world.is_entity_alive(entity_1) == false);
+
+	// Back to the second fork.
+	CHECK(world.restore_fork(fork_2) == OK);
+	CHECK(world.is_entity_alive(entity_1));
+	CHECK(world.get_storage<const TransformComponent>()->get(entity_1)->origin.x == 2.0);
+	CHECK(world.get_storage<const Disabled>()->has(entity_2));
+
+	// Back to the first fork: the storage created after it is cleared too.
+	CHECK(world.restore_fork(fork_1) == OK);
+	CHECK(world.get_forks_count() == 1);
+	CHECK(world.is_entity_alive(entity_2) == false);
+	CHECK(world.get_storage<const TransformComponent>()->get(entity_1)->origin.x == 1.0);
+	CHECK(world.get_storage<const TransformComponent>()->has(entity_2) == false);
+	CHECK(world.get_storage<const Disabled>()->has(entity_2) == false);
+
+	// The `Entity` IDs are assigned as they were.
+	const EntityID entity_3 = world.create_entity();
+	CHECK(entity_3 == entity_2);
+
+	// The dropped and released forks can't be restored.
+	world.release_fork(fork_1);
+	CHECK(world.get_forks_count() == 0);
+	ERR_PRINT_OFF;
+	CHECK(world.restore_fork(fork_2) == ERR_DOES_NOT_EXIST);
+	CHECK(world.restore_fork(fork_1) == ERR_DOES_NOT_EXIST);
+	ERR_PRINT_ON;
+}
+
+TEST_CASE("[Modules][ECS] Test World refuses to fork the storages that can't be restored.") {
+	ECS::register_component<TestWorldSteadyComponent>();
+
+	World world;
+	world.create_entity()
+			.with(TransformComponent())
+			.with(TestWorldSteadyComponent());
+
+	// The `SteadyStorage` snapshot can't bring back its state, so nothing is
+	// forked.
+	ERR_PRINT_OFF;
+	CHECK(world.fork() == UINT32_MAX);
+	ERR_PRINT_ON;
+	CHECK(world.get_forks_count() == 0);
+}
+
 TEST_CASE("[Modules][ECS] Test WorldECS runtime API create entity from prefab.") {
 	WorldECS world;
 
@@ -229,7 +572,7 @@ TEST_CASE("[Modules][ECS] Test WorldECS runtime API create entity from prefab.")
 	const uint32_t entity_id = world.create_entity_from_prefab(&entity_prefab);
 
 	// Make sure something is created.
-	CHECK(entity_id != UINT32_MAX);
+	CHECK(EntityID(entity_id).is_null() == false);
 
 	// Make sure the component is created
 
@@ -245,7 +588,121 @@ TEST_CASE("[Modules][ECS] Test WorldECS runtime API create entity from prefab.")
 	CHECK(ABS(transf->origin.x - 10) <= CMP_EPSILON);
 }
 
-TEST_CASE("[Modules][ECS] Test WorldECS runtime API fetch databags.") {
+TEST_CASE("[Modules][ECS] Test WorldECS runtime API create entities from prefab.") {
+	WorldECS world;
+
+	Entity3D entity_prefab;
+
+	Dictionary defaults;
+	defaults["origin"] = Vector3(10.0, 0.0, 0.0);
+	entity_prefab.add_component("TransformComponent", defaults);
+
+	const PackedInt32Array entities = world.create_entities_from_prefab(&entity_prefab, 5);
+	CHECK(entities.size() == 5);
+
+	for (int i = 0; i < entities.size(); i += 1) {
+		Object *comp = world.get_entity_component_by_name(
+				entities[i],
+				"TransformComponent");
+		CHECK(comp != nullptr);
+
+		TransformComponent *transf = godex::unwrap_component<TransformComponent>(comp);
+		CHECK(ABS(transf->origin.x - 10) <= CMP_EPSILON);
+	}
+
+	// Change the prefab: the baked data must be refreshed.
+	entity_prefab.set_component_value("TransformComponent", "origin", Vector3(20.0, 0.0, 0.0));
+
+	const uint32_t entity_id = world.create_entity_from_prefab(&entity_prefab);
+	Object *comp = world.get_entity_component_by_name(
+			entity_id,
+			"TransformComponent");
+	CHECK(comp != nullptr);
+
+	TransformComponent *transf = godex::unwrap_component<TransformComponent>(comp);
+	CHECK(ABS(transf->origin.x - 20) <= CMP_EPSILON);
+}
+
+TEST_CASE("[Modules][ECS] Test the Entities instanced from the same scene share the conversion.") {
+	WorldECS world;
+
+	Dictionary defaults;
+	defaults["origin"] = Vector3(10.0, 0.0, 0.0);
+
+	Entity3D instance_1;
+	instance_1.set_scene_file_path("res://test_ecs_shared_bake_prefab.tscn");
+	instance_1.add_component("TransformComponent", defaults);
+
+	// Same scene, but this instance has its own data and one more component.
+	Entity3D instance_2;
+	instance_2.set_scene_file_path("res://test_ecs_shared_bake_prefab.tscn");
+	defaults["origin"] = Vector3(20.0, 0.0, 0.0);
+	instance_2.add_component("TransformComponent", defaults);
+	instance_2.add_component("Disabled", Dictionary());
+
+	const uint32_t entity_1 = world.create_entity_from_prefab(&instance_1);
+	const uint32_t entity_2 = world.create_entity_from_prefab(&instance_2);
+	const uint32_t entity_3 = world.create_entity_from_prefab(&instance_1);
+
+	CHECK(godex::unwrap_component<TransformComponent>(world.get_entity_component_by_name(entity_1, "TransformComponent"))->origin.x == 10.0);
+	CHECK(godex::unwrap_component<TransformComponent>(world.get_entity_component_by_name(entity_2, "TransformComponent"))->origin.x == 20.0);
+	CHECK(godex::unwrap_component<TransformComponent>(world.get_entity_component_by_name(entity_3, "TransformComponent"))->origin.x == 10.0);
+
+	CHECK(world.get_world()->get_storage<const Disabled>()->has(entity_2));
+	CHECK(world.get_world()->get_storage<const Disabled>()->has(entity_1) == false);
+	CHECK(world.get_world()->get_storage<const Disabled>()->has(entity_3) == false);
+}
+
+TEST_CASE("[Modules][ECS] Test the scene Entities are created in batch.") {
+	WorldECS world;
+
+	Entity3D root;
+	root.set_reference_by_nodepath(false);
+
+	Dictionary defaults;
+	LocalVector<Entity3D *> instances;
+	for (uint32_t i = 0; i < 4; i += 1) {
+		Entity3D *instance = memnew(Entity3D);
+		instance->set_reference_by_nodepath(false);
+		instance->set_scene_file_path("res://test_ecs_batch_scene_prefab.tscn");
+		defaults["origin"] = Vector3(real_t(i), 0.0, 0.0);
+		instance->add_component("TransformComponent", defaults);
+		root.add_child(instance);
+		instances.push_back(instance);
+	}
+	// This instance breaks the batch, having one more component.
+	instances[2]->add_component("Disabled", Dictionary());
+
+	Entity2D *entity_2d = memnew(Entity2D);
+	entity_2d->set_reference_by_nodepath(false);
+	entity_2d->add_component("Disabled", Dictionary());
+	root.add_child(entity_2d);
+
+	EntityBase::create_scene_entities(&root, world.get_world());
+
+	const EntityID root_entity = root.get_entity_id();
+	CHECK(root_entity.is_null() == false);
+	CHECK(entity_2d->get_entity_id().is_null() == false);
+	CHECK(world.get_world()->get_storage<const Disabled>()->has(entity_2d->get_entity_id()));
+
+	for (uint32_t i = 0; i < instances.size(); i += 1) {
+		const EntityID entity = instances[i]->get_entity_id();
+		CHECK(entity.is_null() == false);
+		CHECK(entity != root_entity);
+
+		// Each instance keeps its own data.
+		const TransformComponent *transform = world.get_world()->get_storage<const TransformComponent>()->get(entity);
+		CHECK(transform != nullptr);
+		CHECK(ABS(transform->origin.x - real_t(i)) <= CMP_EPSILON);
+		CHECK(world.get_world()->get_storage<const Disabled>()->has(entity) == (i == 2));
+	}
+
+	// Already created: nothing changes.
+	EntityBase::create_scene_entities(&root, world.get_world());
+	CHECK(root.get_entity_id() == root_entity);
+}
+
+TEST_CASE("[Modules][ECS] Test WorldECS runtime API fetch databags.") {TEST_CASE("[Modules][ECS] Test WorldECS runtime API fetch databags.") {
 	WorldECS world;
 
 	Object *world_res_raw = world.get_databag_by_name("World");
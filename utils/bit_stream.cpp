@@ -0,0 +1,84 @@
+#include "bit_stream.h"
+
+BitWriter::BitWriter(LocalVector<uint8_t> &r_buffer) :
+		buffer(r_buffer) {
+	// Keep writing after the data already in the buffer.
+	bit_count = uint64_t(buffer.size()) * 8;
+}
+
+void BitWriter::write_bits(uint64_t p_value, uint32_t p_bits) {
+	ERR_FAIL_COND(p_bits > 64);
+	while (p_bits > 0) {
+		const uint32_t bit_offset = bit_count & 7;
+		if (bit_offset == 0) {
+			buffer.push_back(0);
+		}
+		const uint32_t bits = MIN(p_bits, 8 - bit_offset);
+		const uint8_t mask = uint8_t((1 << bits) - 1);
+		buffer[buffer.size() - 1] |= uint8_t((p_value & mask) << bit_offset);
+		p_value >>= bits;
+		p_bits -= bits;
+		bit_count += bits;
+	}
+}
+
+void BitWriter::write_var_uint(uint64_t p_value) {
+	while (p_value >= 0x80) {
+		write_bits((p_value & 0x7F) | 0x80, 8);
+		p_value >>= 7;
+	}
+	write_bits(p_value, 8);
+}
+
+bool BitReader::read_bits(uint32_t p_bits, uint64_t &r_value) {
+	if (p_bits > 64 || p_bits > bit_size - bit_position) {
+		return false;
+	}
+	r_value = 0;
+	uint32_t shift = 0;
+	while (p_bits > 0) {
+		const uint32_t bit_offset = bit_position & 7;
+		const uint32_t bits = MIN(p_bits, 8 - bit_offset);
+		const uint8_t mask = uint8_t((1 << bits) - 1);
+		const uint64_t value = (data[bit_position >> 3] >> bit_offset) & mask;
+		r_value |= value << shift;
+		shift += bits;
+		p_bits -= bits;
+		bit_position += bits;
+	}
+	return true;
+}
+
+bool BitReader::read_bool(bool &r_value) {
+	uint64_t value;
+	if (read_bits(1, value) == false) {
+		return false;
+	}
+	r_value = value != 0;
+	return true;
+}
+
+bool BitReader::read_var_uint(uint64_t &r_value) {
+	r_value = 0;
+	for (uint32_t shift = 0; shift < 64; shift += 7) {
+		uint64_t byte;
+		if (read_bits(8, byte) == false) {
+			return false;
+		}
+		r_value |= (byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0) {
+			return true;
+		}
+	}
+	// Malformed, too many bytes.
+	return false;
+}
+
+bool BitReader::read_var_int(int64_t &r_value) {
+	uint64_t value;
+	if (read_var_uint(value) == false) {
+		return false;
+	}
+	r_value = int64_t(value >> 1) ^ -int64_t(value & 1);
+	return true;
+}
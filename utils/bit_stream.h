@@ -0,0 +1,51 @@
+#pragma once
+
+#include "core/templates/local_vector.h"
+
+/// Appends the values to a byte buffer, using just the bits they need.
+/// The small integers are written with a variable length, see `write_var_uint`.
+class BitWriter {
+	LocalVector<uint8_t> &buffer;
+	/// The bits written so far.
+	uint64_t bit_count = 0;
+
+public:
+	BitWriter(LocalVector<uint8_t> &r_buffer);
+
+	/// Writes the `p_bits` lower bits of `p_value`, `p_bits` is at most 64.
+	void write_bits(uint64_t p_value, uint32_t p_bits);
+
+	void write_bool(bool p_value) {
+		write_bits(p_value ? 1 : 0, 1);
+	}
+
+	/// Writes the value in groups of 7 bits: the small values take less space.
+	void write_var_uint(uint64_t p_value);
+
+	/// Like `write_var_uint`, the values close to `0` take less space.
+	void write_var_int(int64_t p_value) {
+		// ZigZag encoding, so the negative values are small too.
+		write_var_uint((uint64_t(p_value) << 1) ^ uint64_t(p_value >> 63));
+	}
+
+	uint64_t get_bit_count() const {
+		return bit_count;
+	}
+};
+
+/// Reads the values written by the `BitWriter`. All the functions return
+/// `false` when the buffer is too short, so it's never read out of bounds.
+class BitReader {
+	const uint8_t *data = nullptr;
+	uint64_t bit_size = 0;
+	uint64_t bit_position = 0;
+
+public:
+	BitReader(const uint8_t *p_data, uint32_t p_size) :
+			data(p_data), bit_size(uint64_t(p_size) * 8) {}
+
+	bool read_bits(uint32_t p_bits, uint64_t &r_value);
+	bool read_bool(bool &r_value);
+	bool read_var_uint(uint64_t &r_value);
+	bool read_var_int(int64_t &r_value);
+};
@@ -0,0 +1,135 @@
+#include "thread_pool.h"
+
+thread_local uint32_t ThreadPool::thread_index = 0;
+thread_local bool ThreadPool::executing_task = false;
+thread_local ThreadPool::Order ThreadPool::order;
+SafeNumeric<uint64_t> ThreadPool::runs_count;
+
+ThreadPool::ThreadPool() {}
+
+ThreadPool::~ThreadPool() {
+	set_threads_count(0);
+}
+
+void ThreadPool::set_threads_count(uint32_t p_count) {
+	MutexLock lock(run_mutex);
+
+	if (p_count == workers.size()) {
+		// Nothing to do.
+		return;
+	}
+
+	// Stop the current workers.
+	if (workers.size() > 0) {
+		exit_threads.set();
+		for (uint32_t i = 0; i < workers.size(); i += 1) {
+			work_semaphore.post();
+		}
+		for (uint32_t i = 0; i < workers.size(); i += 1) {
+			workers[i]->thread.wait_to_finish();
+			memdelete(workers[i]);
+		}
+		workers.clear();
+		exit_threads.clear();
+	}
+
+	// Start the new ones.
+	workers.resize(p_count);
+	for (uint32_t i = 0; i < p_count; i += 1) {
+		workers[i] = memnew(WorkerData);
+		workers[i]->pool = this;
+		// The index `0` is reserved to the calling thread.
+		workers[i]->thread_index = i + 1;
+		workers[i]->thread.start(worker_main, workers[i]);
+	}
+}
+
+uint32_t ThreadPool::get_threads_count() const {
+	return workers.size();
+}
+
+void ThreadPool::run(TaskFunc p_func, void *p_user_data, uint32_t p_tasks_count) {
+	if (p_tasks_count == 0) {
+		return;
+	}
+
+	if (executing_task || workers.size() == 0 || p_tasks_count == 1) {
+		// Nested call or nothing to split: execute on this thread.
+		for (uint32_t i = 0; i < p_tasks_count; i += 1) {
+			p_func(p_user_data, i);
+		}
+		return;
+	}
+
+	MutexLock lock(run_mutex);
+
+	task_func = p_func;
+	task_user_data = p_user_data;
+	tasks_count = p_tasks_count;
+	run_id = runs_count.increment();
+	next_task.set(0);
+
+	// Wake only the workers that can take a task, this thread takes one too.
+	const uint32_t awake_count = MIN(workers.size(), p_tasks_count - 1);
+	for (uint32_t i = 0; i < awake_count; i += 1) {
+		work_semaphore.post();
+	}
+
+	process_tasks();
+
+	// Join.
+	for (uint32_t i = 0; i < awake_count; i += 1) {
+		done_semaphore.wait();
+	}
+
+	task_func = nullptr;
+	task_user_data = nullptr;
+	tasks_count = 0;
+
+	// From now on, the work of this thread comes after the tasks.
+	order.run = run_id;
+	order.task = UINT32_MAX;
+}
+
+uint32_t ThreadPool::get_thread_index() {
+	return thread_index;
+}
+
+bool ThreadPool::is_executing_task() {
+	return executing_task;
+}
+
+ThreadPool::Order ThreadPool::get_order() {
+	return order;
+}
+
+void ThreadPool::process_tasks() {
+	const Order previous_order = order;
+	executing_task = true;
+	while (true) {
+		const uint32_t task_index = next_task.postincrement();
+		if (task_index >= tasks_count) {
+			break;
+		}
+		order.run = run_id;
+		order.task = task_index;
+		task_func(task_user_data, task_index);
+	}
+	executing_task = false;
+	order = previous_order;
+}
+
+void ThreadPool::worker_main(void *p_data) {
+	WorkerData *data = static_cast<WorkerData *>(p_data);
+	ThreadPool *pool = data->pool;
+	thread_index = data->thread_index;
+
+	while (true) {
+		pool->work_semaphore.wait();
+		if (pool->exit_threads.is_set()) {
+			break;
+		}
+		pool->process_tasks();
+		pool->done_semaphore.post();
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+
+/// Persistent pool of worker threads, used to split the work in many tasks
+/// that are executed concurrently.
+///
+/// The thread that calls `run` takes part in the execution, so a pool with `N`
+/// workers executes up to `N + 1` tasks at the same time.
+/// When `run` is called from a thread that is already executing a task (for
+/// example a `System` that is running in parallel with other systems) the
+/// tasks are executed serially on the calling thread, so nesting is always
+/// safe.
+class ThreadPool {
+public:
+	typedef void (*TaskFunc)(void *p_user_data, uint32_t p_task_index);
+
+	/// Identifies the work done by a thread: the `run` and its task. Sorting
+	/// by `Order` the data produced by many threads, gives always the same
+	/// result no matter which thread took which task.
+	struct Order {
+		/// The last `run` started by this thread, or the `run` of the task.
+		uint64_t run = 0;
+		/// The task index, or `UINT32_MAX` when not executing a task: what the
+		/// calling thread does after `run` comes after all its tasks.
+		uint32_t task = UINT32_MAX;
+
+		bool operator<(const Order &p_other) const {
+			return run == p_other.run ? task < p_other.task : run < p_other.run;
+		}
+	};
+
+private:
+	struct WorkerData {
+		ThreadPool *pool = nullptr;
+		uint32_t thread_index = 0;
+		Thread thread;
+	};
+
+	/// The workers, the array size never changes while `run` is executing.
+	LocalVector<WorkerData *> workers;
+
+	/// Taken by `run`, so only one thread at a time can use the workers.
+	Mutex run_mutex;
+	Semaphore work_semaphore;
+	Semaphore done_semaphore;
+	SafeFlag exit_threads;
+
+	TaskFunc task_func = nullptr;
+	void *task_user_data = nullptr;
+	uint32_t tasks_count = 0;
+	SafeNumeric<uint32_t> next_task;
+	/// The id of the `run` executing.
+	uint64_t run_id = 0;
+
+	/// Gives an id to each `run`, unique across the pools.
+	static SafeNumeric<uint64_t> runs_count;
+
+	static thread_local uint32_t thread_index;
+	static thread_local bool executing_task;
+	static thread_local Order order;
+
+public:
+	ThreadPool();
+	~ThreadPool();
+
+	/// Set the number of worker threads; `0` means that all the tasks are
+	/// executed by the calling thread.
+	/// Must not be called while `run` is executing.
+	void set_threads_count(uint32_t p_count);
+	uint32_t get_threads_count() const;
+
+	/// Executes `p_func` `p_tasks_count` times, passing the task index, and
+	/// returns once all the tasks are done.
+	void run(TaskFunc p_func, void *p_user_data, uint32_t p_tasks_count);
+
+	/// Returns the index of the thread that is executing this function: `0` for
+	/// any thread that is not a worker, `1 .. threads_count` for the workers.
+	/// Useful to store per thread data without locking.
+	static uint32_t get_thread_index();
+
+	/// Returns `true` if the calling thread is executing a task.
+	static bool is_executing_task();
+
+	/// Returns the `Order` of the work the calling thread is doing now.
+	static Order get_order();
+
+private:
+	void process_tasks();
+	static void worker_main(void *p_data);
+};
@@ -0,0 +1,165 @@
+#include "command_buffer.h"
+
+void *CommandBuffer::Lane::alloc(uint32_t p_size, uint32_t p_align) {
+	while (true) {
+		if (block_index < blocks.size()) {
+			const uint32_t offset = (block_used + p_align - 1) & ~(p_align - 1);
+			if (offset + p_size <= blocks_size[block_index]) {
+				block_used = offset + p_size;
+				return blocks[block_index] + offset;
+			}
+			// This block is full, try the next one.
+			block_index += 1;
+			block_used = 0;
+		} else {
+			// Allocate a new block, big enough to fit this data.
+			const uint32_t size = MAX(BLOCK_SIZE, p_size + p_align);
+			blocks.push_back(memnew_arr(uint8_t, size));
+			blocks_size.push_back(size);
+		}
+	}
+}
+
+void CommandBuffer::Lane::free_blocks() {
+	for (uint32_t i = 0; i < blocks.size(); i += 1) {
+		memdelete_arr(blocks[i]);
+	}
+	blocks.reset();
+	blocks_size.reset();
+	block_index = 0;
+	block_used = 0;
+}
+
+CommandBuffer::CommandBuffer() {
+	// Always at least the lane of the main thread.
+	lanes.resize(1);
+}
+
+CommandBuffer::~CommandBuffer() {
+	clear();
+	for (uint32_t i = 0; i < lanes.size(); i += 1) {
+		lanes[i].free_blocks();
+	}
+	if (world) {
+		world->remove_command_buffer(this);
+	}
+}
+
+void CommandBuffer::initiate_process(World *p_world) {
+	ThreadPool *thread_pool = p_world->get_thread_pool();
+	if (thread_pool) {
+		// The index `0` is used by the non worker threads.
+		const uint32_t lanes_count = thread_pool->get_threads_count() + 1;
+		if (lanes.size() < lanes_count) {
+			lanes.resize(lanes_count);
+		}
+	}
+}
+
+EntityID CommandBuffer::create_entity() {
+	ERR_FAIL_COND_V_MSG(world == nullptr, EntityID(), "This CommandBuffer is not part of any World.");
+	return world->get_commands().create_entity();
+}
+
+void CommandBuffer::destroy(EntityID p_entity) {
+	Command command;
+	command.type = COMMAND_DESTROY;
+	command.entity = p_entity;
+	command.order = ThreadPool::get_order();
+	get_lane().commands.push_back(command);
+}
+
+void CommandBuffer::remove(EntityID p_entity, godex::component_id p_component) {
+	Command command;
+	command.type = COMMAND_REMOVE;
+	command.entity = p_entity;
+	command.component = p_component;
+	command.order = ThreadPool::get_order();
+	get_lane().commands.push_back(command);
+}
+
+bool CommandBuffer::is_empty() const {
+	for (uint32_t i = 0; i < lanes.size(); i += 1) {
+		if (lanes[i].commands.size() > 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void CommandBuffer::flush(World *p_world) {
+	uint32_t used_lanes = 0;
+	uint32_t last_used_lane = 0;
+	for (uint32_t l = 0; l < lanes.size(); l += 1) {
+		if (lanes[l].commands.size() > 0) {
+			used_lanes += 1;
+			last_used_lane = l;
+		}
+	}
+
+	if (used_lanes == 1) {
+		// A single lane is already in order.
+		const Lane &lane = lanes[last_used_lane];
+		for (uint32_t i = 0; i < lane.commands.size(); i += 1) {
+			apply(p_world, lane.commands[i]);
+		}
+	} else if (used_lanes > 1) {
+		// Merge the lanes in task order.
+		sorted_commands.clear();
+		for (uint32_t l = 0; l < lanes.size(); l += 1) {
+			for (uint32_t i = 0; i < lanes[l].commands.size(); i += 1) {
+				SortedCommand sorted;
+				sorted.order = lanes[l].commands[i].order;
+				sorted.lane = l;
+				sorted.index = i;
+				sorted_commands.push_back(sorted);
+			}
+		}
+		sorted_commands.sort_custom<SortedCommandComparator>();
+		for (uint32_t i = 0; i < sorted_commands.size(); i += 1) {
+			apply(p_world, lanes[sorted_commands[i].lane].commands[sorted_commands[i].index]);
+		}
+		sorted_commands.clear();
+	}
+
+	for (uint32_t l = 0; l < lanes.size(); l += 1) {
+		lanes[l].commands.clear();
+		lanes[l].block_index = 0;
+		lanes[l].block_used = 0;
+	}
+}
+
+void CommandBuffer::apply(World *p_world, const Command &p_command) {
+	switch (p_command.type) {
+		case COMMAND_DESTROY: {
+			// The `Entity` may be already destroyed by another command.
+			if (p_world && p_world->is_entity_alive(p_command.entity)) {
+				p_world->destroy_entity(p_command.entity);
+			}
+		} break;
+		case COMMAND_INSERT: {
+			// The `Entity` may be destroyed by a previous command, or its index
+			// reused: only the component data is destroyed in that case.
+			const bool alive = p_world && p_world->is_entity_alive(p_command.entity);
+			p_command.insert_func(alive ? p_world : nullptr, p_command.entity, p_command.data);
+		} break;
+		case COMMAND_REMOVE: {
+			if (p_world && p_world->is_entity_alive(p_command.entity) && p_world->has_component(p_command.entity, p_command.component)) {
+				p_world->remove_component(p_command.entity, p_command.component);
+			}
+		} break;
+	}
+}
+
+void CommandBuffer::clear() {
+	// Passing `nullptr` just destroys the pending data.
+	flush(nullptr);
+}
+
+CommandBuffer::Lane &CommandBuffer::get_lane() {
+	const uint32_t index = ThreadPool::get_thread_index();
+#ifdef DEBUG_ENABLED
+	CRASH_COND_MSG(index >= lanes.size(), "The CommandBuffer has no lane for the thread " + itos(index) + ", make sure `initiate_process` is called.");
+#endif
+	return lanes[index];
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "../utils/thread_pool.h"
+#include "world.h"
+
+/// The `CommandBuffer` records the structural changes (destroy `Entities`, add
+/// and remove components) that a `System` wants to do, and applies them at the
+/// end of the stage, in single thread. The `System`s of a sub dispatcher are
+/// applied at the end of the main stage that runs the dispatcher.
+///
+/// Since the storages are not touched while the `System` runs, fetching the
+/// `CommandBuffer` doesn't declare any storage access: a `System` that spawns
+/// can run in parallel with the `System`s that read the same components.
+/// ```
+/// void spawn_bullets(CommandBuffer &p_commands, Query<const Gun> &p_query) {
+/// 	for (auto [gun] : p_query) {
+/// 		const EntityID bullet = p_commands.create_entity();
+/// 		p_commands.insert(bullet, TransformComponent(gun->muzzle));
+/// 	}
+/// }
+/// ```
+///
+/// Each worker thread records into its own lane, so it's safe to use the
+/// `CommandBuffer` from `Query::par_for_each`. The commands are applied in
+/// task order (see `ThreadPool::Order`), and in record order within a task: so
+/// the result doesn't depend on which worker took which chunk. The buffers of
+/// the `System`s are applied following the `System`s order in the pipeline.
+class CommandBuffer {
+	friend class World;
+
+	enum CommandType {
+		COMMAND_DESTROY,
+		COMMAND_INSERT,
+		COMMAND_REMOVE,
+	};
+
+	/// Inserts the data into the `World`, when not `nullptr`, then destroys it.
+	typedef void (*InsertFunc)(World *p_world, EntityID p_entity, void *p_data);
+
+	struct Command {
+		CommandType type = COMMAND_DESTROY;
+		EntityID entity;
+		godex::component_id component = godex::COMPONENT_NONE;
+		void *data = nullptr;
+		InsertFunc insert_func = nullptr;
+		/// The task that recorded this command.
+		ThreadPool::Order order;
+	};
+
+	/// A command of the lane `lane`, sorted by `flush`.
+	struct SortedCommand {
+		ThreadPool::Order order;
+		uint32_t lane = 0;
+		uint32_t index = 0;
+	};
+
+	struct SortedCommandComparator {
+		bool operator()(const SortedCommand &p_a, const SortedCommand &p_b) const {
+			if (p_a.order < p_b.order) {
+				return true;
+			}
+			if (p_b.order < p_a.order) {
+				return false;
+			}
+			return p_a.lane == p_b.lane ? p_a.index < p_b.index : p_a.lane < p_b.lane;
+		}
+	};
+
+	struct Lane {
+		LocalVector<Command> commands;
+		/// The memory of the components to insert, allocated in blocks so the
+		/// data never moves once recorded.
+		LocalVector<uint8_t *> blocks;
+		LocalVector<uint32_t> blocks_size;
+		uint32_t block_index = 0;
+		uint32_t block_used = 0;
+
+		void *alloc(uint32_t p_size, uint32_t p_align);
+		void free_blocks();
+	};
+
+	static constexpr uint32_t BLOCK_SIZE = 4096;
+
+	World *world = nullptr;
+	LocalVector<Lane> lanes;
+	/// Used by `flush` when more than one lane has commands.
+	LocalVector<SortedCommand> sorted_commands;
+
+public:
+	CommandBuffer();
+	~CommandBuffer();
+
+	/// Makes sure there is a lane for each thread of the `World` workers.
+	void initiate_process(World *p_world);
+
+	/// Immediately reserves a new `Entity`, so it's possible to add components to
+	/// it. Safe to call from many threads.
+	EntityID create_entity();
+
+	/// Destroys the `Entity` at the end of the stage.
+	void destroy(EntityID p_entity);
+
+	/// Adds the component to the `Entity` at the end of the stage. Skipped if
+	/// by then the `Entity` is destroyed, even by a previous command.
+	template <class C>
+	void insert(EntityID p_entity, const C &p_data);
+
+	/// Removes the component from the `Entity` at the end of the stage. Skipped
+	/// if by then the `Entity` is destroyed.
+	template <class C>
+	void remove(EntityID p_entity);
+	void remove(EntityID p_entity, godex::component_id p_component);
+
+	bool is_empty() const;
+
+	/// Applies all the recorded commands to the `World`, then clears them.
+	/// Must be called in single thread, when nobody is using the storages.
+	void flush(World *p_world);
+
+	/// Drops all the recorded commands.
+	void clear();
+
+private:
+	Lane &get_lane();
+	static void apply(World *p_world, const Command &p_command);
+
+	template <class C>
+	static void insert_component(World *p_world, EntityID p_entity, void *p_data);
+};
+
+template <class C>
+void CommandBuffer::insert(EntityID p_entity, const C &p_data) {
+	Lane &lane = get_lane();
+	void *mem = lane.alloc(sizeof(C), alignof(C));
+	memnew_placement(mem, C(p_data));
+
+	Command command;
+	command.type = COMMAND_INSERT;
+	command.entity = p_entity;
+	command.component = C::get_component_id();
+	command.data = mem;
+	command.insert_func = insert_component<C>;
+	command.order = ThreadPool::get_order();
+	lane.commands.push_back(command);
+}
+
+template <class C>
+void CommandBuffer::remove(EntityID p_entity) {
+	remove(p_entity, C::get_component_id());
+}
+
+template <class C>
+void CommandBuffer::insert_component(World *p_world, EntityID p_entity, void *p_data) {
+	C *data = static_cast<C *>(p_data);
+	if (p_world) {
+		p_world->add_component(p_entity, *data);
+	}
+	data->~C();
+}
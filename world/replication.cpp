@@ -0,0 +1,831 @@
+#include "replication.h"
+
+#include "../ecs.h"
+#include "../utils/bit_stream.h"
+#include "core/io/marshalls.h"
+#include "world.h"
+
+/// Returns the lanes of the variant type, or `0` if it's sent as `Variant`.
+static uint32_t get_lanes_count(Variant::Type p_type, ReplicationSchema::LaneType &r_lane_type) {
+	switch (p_type) {
+		case Variant::BOOL:
+			r_lane_type = ReplicationSchema::LANE_BOOL;
+			return 1;
+		case Variant::INT:
+			r_lane_type = ReplicationSchema::LANE_INT;
+			return 1;
+		case Variant::VECTOR2I:
+			r_lane_type = ReplicationSchema::LANE_INT;
+			return 2;
+		case Variant::VECTOR3I:
+			r_lane_type = ReplicationSchema::LANE_INT;
+			return 3;
+		case Variant::FLOAT:
+			r_lane_type = ReplicationSchema::LANE_REAL;
+			return 1;
+		case Variant::VECTOR2:
+			r_lane_type = ReplicationSchema::LANE_REAL;
+			return 2;
+		case Variant::VECTOR3:
+			r_lane_type = ReplicationSchema::LANE_REAL;
+			return 3;
+		case Variant::QUATERNION:
+		case Variant::COLOR:
+		case Variant::PLANE:
+			r_lane_type = ReplicationSchema::LANE_REAL;
+			return 4;
+		case Variant::TRANSFORM2D:
+			r_lane_type = ReplicationSchema::LANE_REAL;
+			return 6;
+		case Variant::BASIS:
+			r_lane_type = ReplicationSchema::LANE_REAL;
+			return 9;
+		case Variant::TRANSFORM3D:
+			r_lane_type = ReplicationSchema::LANE_REAL;
+			return 12;
+		default:
+			r_lane_type = ReplicationSchema::LANE_VARIANT;
+			return 0;
+	}
+}
+
+/// The bits of a real lane sent with the full precision.
+static uint32_t get_real_bits(const ReplicationSchema::Field &p_field) {
+	// The `Variant` float is always a `double`.
+	return p_field.type == Variant::FLOAT ? 64 : sizeof(real_t) * 8;
+}
+
+static int64_t quantize(const ReplicationSchema::Field &p_field, double p_value) {
+	if (p_field.step > 0.0) {
+		return int64_t(Math::round(p_value / p_field.step));
+	}
+	if (get_real_bits(p_field) == 64) {
+		int64_t bits;
+		memcpy(&bits, &p_value, sizeof(double));
+		return bits;
+	} else {
+		const float value = p_value;
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(float));
+		return bits;
+	}
+}
+
+static double dequantize(const ReplicationSchema::Field &p_field, int64_t p_lane) {
+	if (p_field.step > 0.0) {
+		return double(p_lane) * p_field.step;
+	}
+	if (get_real_bits(p_field) == 64) {
+		double value;
+		memcpy(&value, &p_lane, sizeof(double));
+		return value;
+	} else {
+		const uint32_t bits = p_lane;
+		float value;
+		memcpy(&value, &bits, sizeof(float));
+		return value;
+	}
+}
+
+static void basis_to_reals(const Basis &p_basis, real_t *r_reals) {
+	for (int r = 0; r < 3; r += 1) {
+		for (int c = 0; c < 3; c += 1) {
+			r_reals[r * 3 + c] = p_basis[r][c];
+		}
+	}
+}
+
+static Basis reals_to_basis(const real_t *p_reals) {
+	Basis basis;
+	for (int r = 0; r < 3; r += 1) {
+		for (int c = 0; c < 3; c += 1) {
+			basis[r][c] = p_reals[r * 3 + c];
+		}
+	}
+	return basis;
+}
+
+void ReplicationSchema::add_component(godex::component_id p_id, const Dictionary &p_quantization) {
+	ERR_FAIL_COND_MSG(ECS::verify_component_id(p_id) == false, "The component " + itos(p_id) + " is not registered.");
+	ERR_FAIL_COND_MSG(ECS::is_component_sharable(p_id), "The shared components can't be replicated.");
+
+	Component component;
+	component.id = p_id;
+
+	// The property list of the dynamic components needs an instance.
+	void *instance = ECS::new_component(p_id);
+	List<PropertyInfo> properties;
+	ECS::unsafe_component_get_property_list(p_id, instance, &properties);
+	ECS::free_component(p_id, instance);
+
+	ERR_FAIL_COND_MSG(properties.size() > int(MAX_FIELDS), "The component " + String(ECS::get_component_name(p_id)) + " has too many fields to be replicated.");
+
+	for (const PropertyInfo &property : properties) {
+		Field field;
+		field.name = property.name;
+		field.type = property.type;
+		field.lanes_count = get_lanes_count(property.type, field.lane_type);
+		field.step = p_quantization.get(property.name, 0.0);
+		if (field.lane_type == LANE_VARIANT) {
+			field.offset = component.variants_count;
+			component.variants_count += 1;
+		} else {
+			field.offset = component.lanes_count;
+			component.lanes_count += field.lanes_count;
+		}
+		component.fields.push_back(field);
+	}
+
+	components.push_back(component);
+}
+
+void ReplicationSchema::read_component(uint32_t p_index, const void *p_component, int64_t *r_lanes, Variant *r_variants) const {
+	const Component &component = components[p_index];
+	for (uint32_t f = 0; f < component.fields.size(); f += 1) {
+		const Field &field = component.fields[f];
+		const Variant value = ECS::unsafe_component_get_by_name(component.id, p_component, field.name);
+
+		if (field.lane_type == LANE_VARIANT) {
+			r_variants[field.offset] = value;
+			continue;
+		}
+
+		int64_t *lanes = r_lanes + field.offset;
+		real_t reals[12];
+		switch (field.type) {
+			case Variant::BOOL: {
+				lanes[0] = bool(value) ? 1 : 0;
+			} break;
+			case Variant::INT: {
+				lanes[0] = int64_t(value);
+			} break;
+			case Variant::VECTOR2I: {
+				const Vector2i v = value;
+				lanes[0] = v.x;
+				lanes[1] = v.y;
+			} break;
+			case Variant::VECTOR3I: {
+				const Vector3i v = value;
+				lanes[0] = v.x;
+				lanes[1] = v.y;
+				lanes[2] = v.z;
+			} break;
+			case Variant::FLOAT: {
+				// Quantized here, to keep the `double` precision.
+				lanes[0] = quantize(field, double(value));
+			} break;
+			case Variant::VECTOR2: {
+				const Vector2 v = value;
+				reals[0] = v.x;
+				reals[1] = v.y;
+			} break;
+			case Variant::VECTOR3: {
+				const Vector3 v = value;
+				reals[0] = v.x;
+				reals[1] = v.y;
+				reals[2] = v.z;
+			} break;
+			case Variant::QUATERNION: {
+				const Quaternion q = value;
+				reals[0] = q.x;
+				reals[1] = q.y;
+				reals[2] = q.z;
+				reals[3] = q.w;
+			} break;
+			case Variant::COLOR: {
+				const Color c = value;
+				reals[0] = c.r;
+				reals[1] = c.g;
+				reals[2] = c.b;
+				reals[3] = c.a;
+			} break;
+			case Variant::PLANE: {
+				const Plane p = value;
+				reals[0] = p.normal.x;
+				reals[1] = p.normal.y;
+				reals[2] = p.normal.z;
+				reals[3] = p.d;
+			} break;
+			case Variant::TRANSFORM2D: {
+				const Transform2D t = value;
+				for (int i = 0; i < 3; i += 1) {
+					reals[i * 2 + 0] = t[i].x;
+					reals[i * 2 + 1] = t[i].y;
+				}
+			} break;
+			case Variant::BASIS: {
+				basis_to_reals(value, reals);
+			} break;
+			case Variant::TRANSFORM3D: {
+				const Transform3D t = value;
+				basis_to_reals(t.basis, reals);
+				reals[9] = t.origin.x;
+				reals[10] = t.origin.y;
+				reals[11] = t.origin.z;
+			} break;
+			default:
+				CRASH_NOW_MSG("This type has no lanes.");
+		}
+
+		if (field.lane_type == LANE_REAL && field.type != Variant::FLOAT) {
+			for (uint32_t l = 0; l < field.lanes_count; l += 1) {
+				lanes[l] = quantize(field, reals[l]);
+			}
+		}
+	}
+}
+
+Variant ReplicationSchema::get_field(const Field &p_field, const int64_t *p_lanes, const Variant *p_variants) const {
+	if (p_field.lane_type == LANE_VARIANT) {
+		return p_variants[p_field.offset];
+	}
+
+	const int64_t *lanes = p_lanes + p_field.offset;
+	real_t reals[12];
+	if (p_field.lane_type == LANE_REAL) {
+		for (uint32_t l = 0; l < p_field.lanes_count; l += 1) {
+			reals[l] = dequantize(p_field, lanes[l]);
+		}
+	}
+
+	switch (p_field.type) {
+		case Variant::BOOL:
+			return lanes[0] != 0;
+		case Variant::INT:
+			return lanes[0];
+		case Variant::VECTOR2I:
+			return Vector2i(lanes[0], lanes[1]);
+		case Variant::VECTOR3I:
+			return Vector3i(lanes[0], lanes[1], lanes[2]);
+		case Variant::FLOAT:
+			return dequantize(p_field, lanes[0]);
+		case Variant::VECTOR2:
+			return Vector2(reals[0], reals[1]);
+		case Variant::VECTOR3:
+			return Vector3(reals[0], reals[1], reals[2]);
+		case Variant::QUATERNION:
+			return Quaternion(reals[0], reals[1], reals[2], reals[3]);
+		case Variant::COLOR:
+			return Color(reals[0], reals[1], reals[2], reals[3]);
+		case Variant::PLANE:
+			return Plane(Vector3(reals[0], reals[1], reals[2]), reals[3]);
+		case Variant::TRANSFORM2D: {
+			Transform2D t;
+			for (int i = 0; i < 3; i += 1) {
+				t[i] = Vector2(reals[i * 2 + 0], reals[i * 2 + 1]);
+			}
+			return t;
+		}
+		case Variant::BASIS:
+			return reals_to_basis(reals);
+		case Variant::TRANSFORM3D:
+			return Transform3D(reals_to_basis(reals), Vector3(reals[9], reals[10], reals[11]));
+		default:
+			CRASH_NOW_MSG("This type has no lanes.");
+			return Variant();
+	}
+}
+
+void ReplicationSchema::write_fields(uint32_t p_index, uint64_t p_mask, const int64_t *p_lanes, const Variant *p_variants, BitWriter &p_writer) const {
+	const Component &component = components[p_index];
+	p_writer.write_bits(p_mask, component.fields.size());
+
+	for (uint32_t f = 0; f < component.fields.size(); f += 1) {
+		if ((p_mask & (uint64_t(1) << f)) == 0) {
+			continue;
+		}
+
+		const Field &field = component.fields[f];
+		const int64_t *lanes = p_lanes + field.offset;
+		switch (field.lane_type) {
+			case LANE_BOOL: {
+				p_writer.write_bool(lanes[0] != 0);
+			} break;
+			case LANE_INT: {
+				for (uint32_t l = 0; l < field.lanes_count; l += 1) {
+					p_writer.write_var_int(lanes[l]);
+				}
+			} break;
+			case LANE_REAL: {
+				for (uint32_t l = 0; l < field.lanes_count; l += 1) {
+					if (field.step > 0.0) {
+						p_writer.write_var_int(lanes[l]);
+					} else {
+						p_writer.write_bits(lanes[l], get_real_bits(field));
+					}
+				}
+			} break;
+			case LANE_VARIANT: {
+				int len = 0;
+				const Variant &value = p_variants[field.offset];
+				Error err = encode_variant(value, nullptr, len, false);
+				ERR_FAIL_COND_MSG(err != OK, "The field " + field.name + " can't be replicated.");
+
+				LocalVector<uint8_t> bytes;
+				bytes.resize(len);
+				encode_variant(value, bytes.ptr(), len, false);
+				p_writer.write_var_uint(len);
+				for (int i = 0; i < len; i += 1) {
+					p_writer.write_bits(bytes[i], 8);
+				}
+			} break;
+		}
+	}
+}
+
+bool ReplicationSchema::read_fields(uint32_t p_index, uint64_t p_mask, int64_t *r_lanes, Variant *r_variants, BitReader &p_reader) const {
+	const Component &component = components[p_index];
+
+	for (uint32_t f = 0; f < component.fields.size(); f += 1) {
+		if ((p_mask & (uint64_t(1) << f)) == 0) {
+			continue;
+		}
+
+		const Field &field = component.fields[f];
+		int64_t *lanes = r_lanes + field.offset;
+		switch (field.lane_type) {
+			case LANE_BOOL: {
+				bool value;
+				ERR_FAIL_COND_V(p_reader.read_bool(value) == false, false);
+				lanes[0] = value ? 1 : 0;
+			} break;
+			case LANE_INT: {
+				for (uint32_t l = 0; l < field.lanes_count; l += 1) {
+					ERR_FAIL_COND_V(p_reader.read_var_int(lanes[l]) == false, false);
+				}
+			} break;
+			case LANE_REAL: {
+				for (uint32_t l = 0; l < field.lanes_count; l += 1) {
+					if (field.step > 0.0) {
+						ERR_FAIL_COND_V(p_reader.read_var_int(lanes[l]) == false, false);
+					} else {
+						uint64_t bits;
+						ERR_FAIL_COND_V(p_reader.read_bits(get_real_bits(field), bits) == false, false);
+						lanes[l] = bits;
+					}
+				}
+			} break;
+			case LANE_VARIANT: {
+				uint64_t len;
+				ERR_FAIL_COND_V(p_reader.read_var_uint(len) == false || len > UINT32_MAX, false);
+				LocalVector<uint8_t> bytes;
+				bytes.resize(len);
+				for (uint64_t i = 0; i < len; i += 1) {
+					uint64_t byte;
+					ERR_FAIL_COND_V(p_reader.read_bits(8, byte) == false, false);
+					bytes[i] = byte;
+				}
+				ERR_FAIL_COND_V(decode_variant(r_variants[field.offset], bytes.ptr(), len, nullptr, false) != OK, false);
+			} break;
+		}
+	}
+	return true;
+}
+
+ReplicationEncoder::ReplicationEncoder(World *p_world, const ReplicationSchema &p_schema) :
+		world(p_world),
+		schema(p_schema) {
+	CRASH_COND_MSG(world == nullptr, "The world can't be nullptr.");
+
+	states.resize(schema.get_components_count());
+	for (uint32_t c = 0; c < states.size(); c += 1) {
+		states[c] = memnew(ComponentState);
+
+		const godex::component_id id = schema.get_component(c).id;
+		world->create_storage(id);
+		StorageBase *storage = world->get_storage(id);
+		storage->add_change_recorder(&states[c]->recorder);
+
+		// The `Entities` already stored are sent by the first frame.
+		const EntitiesBuffer entities = storage->get_stored_entities();
+		for (uint32_t i = 0; i < entities.count; i += 1) {
+			states[c]->recorder.changed.insert(entities.entities[i]);
+		}
+	}
+}
+
+ReplicationEncoder::~ReplicationEncoder() {
+	for (uint32_t c = 0; c < states.size(); c += 1) {
+		StorageBase *storage = world->get_storage(schema.get_component(c).id);
+		if (storage) {
+			storage->remove_change_recorder(&states[c]->recorder);
+		}
+		memdelete(states[c]);
+	}
+	states.clear();
+}
+
+uint32_t ReplicationEncoder::encode(LocalVector<uint8_t> &r_buffer) {
+	sequence += 1;
+
+	if (frames.size() >= MAX_UNACKED_FRAMES) {
+		// Too old to be acknowledged, its fields are still pending.
+		frames.remove_at(0);
+	}
+	frames.resize(frames.size() + 1);
+	SentFrame &frame = frames[frames.size() - 1];
+	frame.sequence = sequence;
+
+	BitWriter writer(r_buffer);
+	writer.write_bits(sequence, 32);
+	for (uint32_t c = 0; c < states.size(); c += 1) {
+		encode_component(c, frame, writer);
+	}
+
+	return sequence;
+}
+
+void ReplicationEncoder::encode_component(uint32_t p_component, SentFrame &r_frame, BitWriter &p_writer) {
+	ComponentState &state = *states[p_component];
+	const ReplicationSchema::Component &component = schema.get_component(p_component);
+	const StorageBase *storage = world->get_storage(component.id);
+
+	// 1. The removed components.
+	if (state.recorder.cleared) {
+		for (uint32_t b = 0; b < state.baselines.size(); b += 1) {
+			if (state.baselines[b].entity.is_null() == false) {
+				remove_baseline(state, b);
+			}
+		}
+	}
+	state.recorder.removed.for_each([&](EntityID p_entity) {
+		const uint32_t b = state.baseline_index.get(p_entity);
+		if (b != PagedSparseIndex::NONE && state.baselines[b].entity == p_entity) {
+			remove_baseline(state, b);
+		}
+	});
+
+	// 2. The changed components and the not yet acknowledged ones.
+	// Each update is the `Entity` index in the high bits and the baseline
+	// in the low bits: sorted, so the indices are sent as small deltas.
+	updates.clear();
+	state.recorder.changed.for_each([&](EntityID p_entity) {
+		if (storage->has(p_entity)) {
+			const uint32_t b = get_baseline(state, p_component, p_entity);
+			if (state.baselines[b].visit_sequence != sequence) {
+				state.baselines[b].visit_sequence = sequence;
+				updates.push_back((uint64_t(p_entity.get_index()) << 32) | b);
+			}
+		}
+	});
+	for (uint32_t i = 0; i < state.pending.size(); i += 1) {
+		const EntityID entity = state.pending[i];
+		const uint32_t b = state.baseline_index.get(entity);
+		if (b != PagedSparseIndex::NONE && state.baselines[b].entity == entity && state.baselines[b].visit_sequence != sequence) {
+			state.baselines[b].visit_sequence = sequence;
+			updates.push_back((uint64_t(entity.get_index()) << 32) | b);
+		}
+	}
+	state.recorder.clear();
+	updates.sort();
+
+	// 3. Diff against the baseline.
+	state.pending.clear();
+	uint32_t updates_count = 0;
+	for (uint32_t i = 0; i < updates.size(); i += 1) {
+		const uint32_t b = updates[i] & UINT32_MAX;
+		Baseline &baseline = state.baselines[b];
+
+		const uint32_t lanes_offset = r_frame.lanes.size();
+		const uint32_t variants_offset = r_frame.variants.size();
+		r_frame.lanes.resize(lanes_offset + component.lanes_count);
+		r_frame.variants.resize(variants_offset + component.variants_count);
+		int64_t *lanes = r_frame.lanes.ptr() + lanes_offset;
+		Variant *variants = r_frame.variants.ptr() + variants_offset;
+		schema.read_component(p_component, storage->get_ptr(baseline.entity), lanes, variants);
+
+		uint64_t mask = 0;
+		if (baseline.acked == false) {
+			// The receiver may not have this component, send it all: also
+			// when it has no fields, so the receiver adds it.
+			mask = component.fields.size() == ReplicationSchema::MAX_FIELDS ? UINT64_MAX : (uint64_t(1) << component.fields.size()) - 1;
+		} else {
+			const int64_t *baseline_lanes = state.baseline_lanes.ptr() + b * component.lanes_count;
+			const Variant *baseline_variants = state.baseline_variants.ptr() + b * component.variants_count;
+			for (uint32_t f = 0; f < component.fields.size(); f += 1) {
+				const ReplicationSchema::Field &field = component.fields[f];
+				bool changed = false;
+				if (field.lane_type == ReplicationSchema::LANE_VARIANT) {
+					changed = variants[field.offset] != baseline_variants[field.offset];
+				} else {
+					for (uint32_t l = field.offset; l < field.offset + field.lanes_count; l += 1) {
+						changed = changed || lanes[l] != baseline_lanes[l];
+					}
+				}
+				if (changed) {
+					mask |= uint64_t(1) << f;
+				}
+			}
+			// The fields not yet acknowledged are sent again: the receiver may
+			// have a value different from the baseline.
+			mask |= baseline.pending_mask;
+		}
+
+		if (mask == 0 && baseline.acked) {
+			// Nothing to send.
+			r_frame.lanes.resize(lanes_offset);
+			r_frame.variants.resize(variants_offset);
+			continue;
+		}
+
+		baseline.pending_mask |= mask;
+		baseline.last_sent_sequence = sequence;
+		if (baseline.insert_sequence == 0) {
+			baseline.insert_sequence = sequence;
+		}
+		state.pending.push_back(baseline.entity);
+
+		SentUpdate update;
+		update.component = p_component;
+		update.entity = baseline.entity;
+		update.mask = mask;
+		update.lanes_offset = lanes_offset;
+		update.variants_offset = variants_offset;
+		r_frame.updates.push_back(update);
+		updates_count += 1;
+	}
+
+	// 4. Write the section.
+	const bool has_section = updates_count > 0 || state.removals.size() > 0;
+	p_writer.write_bool(has_section);
+	if (has_section == false) {
+		return;
+	}
+
+	const SentUpdate *sent_updates = r_frame.updates.ptr() + r_frame.updates.size() - updates_count;
+	p_writer.write_var_uint(updates_count);
+	uint32_t previous_index = 0;
+	for (uint32_t i = 0; i < updates_count; i += 1) {
+		const EntityID entity = sent_updates[i].entity;
+		p_writer.write_var_uint(entity.get_index() - previous_index);
+		p_writer.write_bits(entity.get_generation(), 32 - EntityID::INDEX_BITS);
+		previous_index = entity.get_index();
+
+		schema.write_fields(
+				p_component,
+				sent_updates[i].mask,
+				r_frame.lanes.ptr() + sent_updates[i].lanes_offset,
+				r_frame.variants.ptr() + sent_updates[i].variants_offset,
+				p_writer);
+	}
+
+	p_writer.write_var_uint(state.removals.size());
+	for (uint32_t i = 0; i < state.removals.size(); i += 1) {
+		p_writer.write_bits(state.removals[i].entity.get_raw_id(), 32);
+	}
+}
+
+uint32_t ReplicationEncoder::get_baseline(ComponentState &p_state, uint32_t p_component, EntityID p_entity) {
+	uint32_t b = p_state.baseline_index.get(p_entity);
+	if (b != PagedSparseIndex::NONE) {
+		if (p_state.baselines[b].entity == p_entity) {
+			return b;
+		}
+		// The index is used by a new `Entity`: the old one is gone.
+		remove_baseline(p_state, b);
+	}
+
+	// The component is sent again, so drop its removal if still pending.
+	for (uint32_t i = 0; i < p_state.removals.size(); i += 1) {
+		if (p_state.removals[i].entity == p_entity) {
+			p_state.removals.remove_at_unordered(i);
+			break;
+		}
+	}
+
+	const ReplicationSchema::Component &component = schema.get_component(p_component);
+	if (p_state.free_baselines.size() > 0) {
+		b = p_state.free_baselines[p_state.free_baselines.size() - 1];
+		p_state.free_baselines.resize(p_state.free_baselines.size() - 1);
+	} else {
+		b = p_state.baselines.size();
+		p_state.baselines.push_back(Baseline());
+		p_state.baseline_lanes.resize(p_state.baseline_lanes.size() + component.lanes_count);
+		p_state.baseline_variants.resize(p_state.baseline_variants.size() + component.variants_count);
+	}
+
+	p_state.baselines[b] = Baseline();
+	p_state.baselines[b].entity = p_entity;
+	p_state.baseline_index.set(p_entity, b);
+	return b;
+}
+
+void ReplicationEncoder::remove_baseline(ComponentState &p_state, uint32_t p_baseline) {
+	Baseline &baseline = p_state.baselines[p_baseline];
+
+	if (baseline.insert_sequence != 0) {
+		// The receiver may have this component.
+		Removal removal;
+		removal.entity = baseline.entity;
+		removal.sequence = sequence;
+		p_state.removals.push_back(removal);
+	}
+
+	p_state.baseline_index.erase(baseline.entity);
+	baseline = Baseline();
+	p_state.free_baselines.push_back(p_baseline);
+}
+
+void ReplicationEncoder::ack(uint32_t p_sequence) {
+	int64_t frame_index = -1;
+	for (uint32_t i = 0; i < frames.size(); i += 1) {
+		if (frames[i].sequence == p_sequence) {
+			frame_index = i;
+			break;
+		}
+	}
+	if (frame_index == -1) {
+		// Already acknowledged, or too old.
+		return;
+	}
+
+	const SentFrame &frame = frames[frame_index];
+	for (uint32_t i = 0; i < frame.updates.size(); i += 1) {
+		const SentUpdate &update = frame.updates[i];
+		ComponentState &state = *states[update.component];
+		const uint32_t b = state.baseline_index.get(update.entity);
+		if (b == PagedSparseIndex::NONE || (state.baselines[b].entity == update.entity) == false) {
+			// Removed in the meantime.
+			continue;
+		}
+
+		Baseline &baseline = state.baselines[b];
+		if (p_sequence < baseline.insert_sequence) {
+			// Sent before the component was removed and added back.
+			continue;
+		}
+
+		// The receiver has these values now.
+		const ReplicationSchema::Component &component = schema.get_component(update.component);
+		int64_t *baseline_lanes = state.baseline_lanes.ptr() + b * component.lanes_count;
+		Variant *baseline_variants = state.baseline_variants.ptr() + b * component.variants_count;
+		for (uint32_t f = 0; f < component.fields.size(); f += 1) {
+			if ((update.mask & (uint64_t(1) << f)) == 0) {
+				continue;
+			}
+			const ReplicationSchema::Field &field = component.fields[f];
+			if (field.lane_type == ReplicationSchema::LANE_VARIANT) {
+				baseline_variants[field.offset] = frame.variants[update.variants_offset + field.offset];
+			} else {
+				for (uint32_t l = field.offset; l < field.offset + field.lanes_count; l += 1) {
+					baseline_lanes[l] = frame.lanes[update.lanes_offset + l];
+				}
+			}
+		}
+
+		// The first frame that sends a component, sends all its fields.
+		baseline.acked = true;
+		if (baseline.last_sent_sequence <= p_sequence) {
+			baseline.pending_mask = 0;
+		}
+	}
+
+	// The removals are sent by all the frames, until acknowledged.
+	for (uint32_t c = 0; c < states.size(); c += 1) {
+		LocalVector<Removal> &removals = states[c]->removals;
+		for (int64_t i = int64_t(removals.size()) - 1; i >= 0; i -= 1) {
+			if (removals[i].sequence <= p_sequence) {
+				removals.remove_at_unordered(i);
+			}
+		}
+	}
+
+	// The older frames are not needed anymore.
+	for (int64_t i = frame_index; i >= 0; i -= 1) {
+		frames.remove_at(i);
+	}
+}
+
+ReplicationDecoder::ReplicationDecoder(World *p_world, const ReplicationSchema &p_schema) :
+		world(p_world),
+		schema(p_schema) {
+	CRASH_COND_MSG(world == nullptr, "The world can't be nullptr.");
+	for (uint32_t c = 0; c < schema.get_components_count(); c += 1) {
+		world->create_storage(schema.get_component(c).id);
+	}
+}
+
+Error ReplicationDecoder::decode(const uint8_t *p_data, uint32_t p_size, uint32_t &r_sequence) {
+	BitReader reader(p_data, p_size);
+
+	uint64_t sequence;
+	ERR_FAIL_COND_V(reader.read_bits(32, sequence) == false, ERR_FILE_CORRUPT);
+	r_sequence = sequence;
+	if (r_sequence <= last_sequence) {
+		// Older than the applied state.
+		return ERR_SKIP;
+	}
+
+	ERR_FAIL_COND_V_MSG(read_frame(reader) == false, ERR_FILE_CORRUPT, "The replication frame " + itos(r_sequence) + " is malformed.");
+	last_sequence = r_sequence;
+
+	// Apply the frame.
+	for (uint32_t i = 0; i < decoded_updates.size(); i += 1) {
+		const DecodedUpdate &update = decoded_updates[i];
+		const ReplicationSchema::Component &component = schema.get_component(update.component);
+		const int64_t *lanes = decoded_lanes.ptr() + update.lanes_offset;
+		const Variant *variants = decoded_variants.ptr() + update.variants_offset;
+
+		RemoteEntity *remote = entities.lookup_ptr(update.entity.get_raw_id());
+		if (remote == nullptr) {
+			RemoteEntity new_remote;
+			new_remote.local = world->create_entity_index();
+			entities.insert(update.entity.get_raw_id(), new_remote);
+			remote = entities.lookup_ptr(update.entity.get_raw_id());
+		}
+
+		if (world->has_component(remote->local, component.id) == false) {
+			world->add_component(remote->local, component.id, Dictionary());
+			remote->components_count += 1;
+		}
+
+		void *data = world->get_storage(component.id)->get_ptr(remote->local);
+		for (uint32_t f = 0; f < component.fields.size(); f += 1) {
+			if ((update.mask & (uint64_t(1) << f)) != 0) {
+				const ReplicationSchema::Field &field = component.fields[f];
+				ECS::unsafe_component_set_by_name(component.id, data, field.name, schema.get_field(field, lanes, variants));
+			}
+		}
+	}
+
+	for (uint32_t i = 0; i < decoded_removals.size(); i += 1) {
+		const DecodedRemoval &removal = decoded_removals[i];
+		const godex::component_id id = schema.get_component(removal.component).id;
+
+		RemoteEntity *remote = entities.lookup_ptr(removal.entity.get_raw_id());
+		if (remote == nullptr || world->has_component(remote->local, id) == false) {
+			// Already removed.
+			continue;
+		}
+
+		world->remove_component(remote->local, id);
+		remote->components_count -= 1;
+		if (remote->components_count == 0) {
+			world->destroy_entity(remote->local);
+			entities.remove(removal.entity.get_raw_id());
+		}
+	}
+
+	return OK;
+}
+
+bool ReplicationDecoder::read_frame(BitReader &p_reader) {
+	decoded_updates.clear();
+	decoded_removals.clear();
+	decoded_lanes.clear();
+	decoded_variants.clear();
+
+	for (uint32_t c = 0; c < schema.get_components_count(); c += 1) {
+		const ReplicationSchema::Component &component = schema.get_component(c);
+
+		bool has_section;
+		ERR_FAIL_COND_V(p_reader.read_bool(has_section) == false, false);
+		if (has_section == false) {
+			continue;
+		}
+
+		uint64_t updates_count;
+		ERR_FAIL_COND_V(p_reader.read_var_uint(updates_count) == false || updates_count > EntityID::INDEX_MASK, false);
+		uint64_t index = 0;
+		for (uint64_t i = 0; i < updates_count; i += 1) {
+			uint64_t index_delta;
+			uint64_t generation;
+			uint64_t mask;
+			ERR_FAIL_COND_V(p_reader.read_var_uint(index_delta) == false, false);
+			ERR_FAIL_COND_V(p_reader.read_bits(32 - EntityID::INDEX_BITS, generation) == false, false);
+			ERR_FAIL_COND_V(p_reader.read_bits(component.fields.size(), mask) == false, false);
+			index += index_delta;
+			ERR_FAIL_COND_V(index > EntityID::INDEX_MASK, false);
+
+			DecodedUpdate update;
+			update.component = c;
+			update.entity = EntityID(index, generation);
+			update.mask = mask;
+			update.lanes_offset = decoded_lanes.size();
+			update.variants_offset = decoded_variants.size();
+			decoded_lanes.resize(decoded_lanes.size() + component.lanes_count);
+			decoded_variants.resize(decoded_variants.size() + component.variants_count);
+
+			ERR_FAIL_COND_V(schema.read_fields(c, mask, decoded_lanes.ptr() + update.lanes_offset, decoded_variants.ptr() + update.variants_offset, p_reader) == false, false);
+			decoded_updates.push_back(update);
+		}
+
+		uint64_t removals_count;
+		ERR_FAIL_COND_V(p_reader.read_var_uint(removals_count) == false || removals_count > EntityID::INDEX_MASK, false);
+		for (uint64_t i = 0; i < removals_count; i += 1) {
+			uint64_t raw_id;
+			ERR_FAIL_COND_V(p_reader.read_bits(32, raw_id) == false, false);
+
+			DecodedRemoval removal;
+			removal.component = c;
+			removal.entity = EntityID(uint32_t(raw_id));
+			decoded_removals.push_back(removal);
+		}
+	}
+	return true;
+}
+
+EntityID ReplicationDecoder::get_local_entity(EntityID p_remote) const {
+	const RemoteEntity *remote = entities.lookup_ptr(p_remote.get_raw_id());
+	return remote == nullptr ? EntityID() : remote->local;
+}
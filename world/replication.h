@@ -0,0 +1,227 @@
+#pragma once
+
+#include "../ecs_types.h"
+#include "../storage/storage.h"
+#include "core/templates/oa_hash_map.h"
+
+class World;
+class BitWriter;
+class BitReader;
+
+/// Describes the components replicated by the `ReplicationEncoder`, and how
+/// their fields are quantized. The encoder and the decoder must use the same
+/// schema: the components are identified by their position into it.
+///
+/// Each field is split in lanes: a `Vector3` has 3 real lanes, a `Transform3D`
+/// 12, and so on. The lanes are compared and sent already quantized, so a
+/// change smaller than the quantization step is never sent. The fields of the
+/// other types are sent as `Variant`s.
+class ReplicationSchema {
+public:
+	/// A component can't have more fields than this, the field mask of each
+	/// component update is an `uint64_t`.
+	static constexpr uint32_t MAX_FIELDS = 64;
+
+	enum LaneType {
+		LANE_BOOL,
+		LANE_INT,
+		LANE_REAL,
+		/// The field is sent as `Variant`.
+		LANE_VARIANT,
+	};
+
+	struct Field {
+		StringName name;
+		Variant::Type type = Variant::NIL;
+		LaneType lane_type = LANE_VARIANT;
+		/// The real lanes are sent as multiple of this step; when `0` they are
+		/// sent with the full precision.
+		real_t step = 0.0;
+		uint32_t lanes_count = 0;
+		/// Offset of the first lane, or of the `Variant` for `LANE_VARIANT`.
+		uint32_t offset = 0;
+	};
+
+	struct Component {
+		godex::component_id id = godex::COMPONENT_NONE;
+		LocalVector<Field> fields;
+		uint32_t lanes_count = 0;
+		uint32_t variants_count = 0;
+	};
+
+private:
+	LocalVector<Component> components;
+
+public:
+	/// Adds the component to replicate. `p_quantization` maps the field names
+	/// to the quantization step of their real numbers, for example:
+	/// `{"origin": 0.01}`. The fields not listed keep the full precision.
+	void add_component(godex::component_id p_id, const Dictionary &p_quantization = Dictionary());
+
+	uint32_t get_components_count() const {
+		return components.size();
+	}
+
+	const Component &get_component(uint32_t p_index) const {
+		return components[p_index];
+	}
+
+	/// Reads all the fields of the component into lanes and `Variant`s.
+	void read_component(uint32_t p_index, const void *p_component, int64_t *r_lanes, Variant *r_variants) const;
+
+	/// Builds back the field value, from its lanes.
+	Variant get_field(const Field &p_field, const int64_t *p_lanes, const Variant *p_variants) const;
+
+	/// Writes the fields selected by `p_mask`.
+	void write_fields(uint32_t p_index, uint64_t p_mask, const int64_t *p_lanes, const Variant *p_variants, BitWriter &p_writer) const;
+
+	/// Reads the fields selected by `p_mask`.
+	bool read_fields(uint32_t p_index, uint64_t p_mask, int64_t *r_lanes, Variant *r_variants, BitReader &p_reader) const;
+};
+
+/// Encodes the component changes of a `World` into a compact binary stream,
+/// one frame at a time, that the `ReplicationDecoder` applies to another
+/// `World`.
+///
+/// The encoder uses a `ChangeRecorder` for each component, so each frame costs
+/// as much as the `Entities` that changed, not as the stored ones. The
+/// changes are sent as field diffs against the baseline: the values the
+/// receiver acknowledged, by calling `ack` with the frame sequence. The fields
+/// sent in the frames not yet acknowledged are sent again, so the receiver
+/// always converges, even if some frames are lost.
+///
+/// Use one encoder for each receiver. The encoder must be destroyed before the
+/// `World`.
+class ReplicationEncoder {
+	/// The frames kept to be acknowledged: the older are dropped, and their
+	/// fields are sent again until a newer frame is acknowledged.
+	static constexpr uint32_t MAX_UNACKED_FRAMES = 64;
+
+	/// The receiver state of a replicated component.
+	struct Baseline {
+		EntityID entity;
+		/// The fields sent by the frames not yet acknowledged.
+		uint64_t pending_mask = 0;
+		uint32_t last_sent_sequence = 0;
+		/// The sequence of the frame that first sent the component.
+		uint32_t insert_sequence = 0;
+		/// The last frame that took this `Entity` into account.
+		uint32_t visit_sequence = 0;
+		/// `true` once the receiver acknowledged the component: from now on
+		/// only the fields different from the baseline are sent.
+		bool acked = false;
+	};
+
+	struct Removal {
+		EntityID entity;
+		/// The frame that first sent the removal: the removal is sent by all
+		/// the frames, until one of them is acknowledged.
+		uint32_t sequence = 0;
+	};
+
+	struct ComponentState {
+		ChangeRecorder recorder;
+		/// `Entity` index -> baseline.
+		PagedSparseIndex baseline_index;
+		LocalVector<Baseline> baselines;
+		LocalVector<int64_t> baseline_lanes;
+		LocalVector<Variant> baseline_variants;
+		LocalVector<uint32_t> free_baselines;
+		/// The `Entities` that have something not yet acknowledged.
+		LocalVector<EntityID> pending;
+		LocalVector<Removal> removals;
+	};
+
+	struct SentUpdate {
+		uint32_t component;
+		EntityID entity;
+		uint64_t mask;
+		/// All the lanes of the component are stored, from these offsets.
+		uint32_t lanes_offset;
+		uint32_t variants_offset;
+	};
+
+	struct SentFrame {
+		uint32_t sequence = 0;
+		LocalVector<SentUpdate> updates;
+		LocalVector<int64_t> lanes;
+		LocalVector<Variant> variants;
+	};
+
+	World *world = nullptr;
+	ReplicationSchema schema;
+	LocalVector<ComponentState *> states;
+	LocalVector<SentFrame> frames;
+	uint32_t sequence = 0;
+
+	// Cache.
+	LocalVector<uint64_t> updates;
+
+public:
+	/// All the `Entities` already in the `World` are sent by the first frame.
+	ReplicationEncoder(World *p_world, const ReplicationSchema &p_schema);
+	~ReplicationEncoder();
+
+	/// Appends to `r_buffer` the frame with the changes since the last
+	/// acknowledged frame, and returns its sequence.
+	uint32_t encode(LocalVector<uint8_t> &r_buffer);
+
+	/// The receiver applied the frame `p_sequence`.
+	void ack(uint32_t p_sequence);
+
+private:
+	uint32_t get_baseline(ComponentState &p_state, uint32_t p_component, EntityID p_entity);
+	void remove_baseline(ComponentState &p_state, uint32_t p_baseline);
+	void encode_component(uint32_t p_component, SentFrame &r_frame, BitWriter &p_writer);
+};
+
+/// Applies the frames created by the `ReplicationEncoder` to a `World`. The
+/// replicated `Entities` are created on the first update, and destroyed once
+/// they don't have any replicated component.
+class ReplicationDecoder {
+	struct RemoteEntity {
+		EntityID local;
+		uint32_t components_count = 0;
+	};
+
+	struct DecodedUpdate {
+		uint32_t component;
+		EntityID entity;
+		uint64_t mask;
+		uint32_t lanes_offset;
+		uint32_t variants_offset;
+	};
+
+	struct DecodedRemoval {
+		uint32_t component;
+		EntityID entity;
+	};
+
+	World *world = nullptr;
+	ReplicationSchema schema;
+	/// Remote `Entity` raw ID -> local `Entity`.
+	OAHashMap<uint32_t, RemoteEntity> entities;
+	uint32_t last_sequence = 0;
+
+	// Cache.
+	LocalVector<DecodedUpdate> decoded_updates;
+	LocalVector<DecodedRemoval> decoded_removals;
+	LocalVector<int64_t> decoded_lanes;
+	LocalVector<Variant> decoded_variants;
+
+public:
+	ReplicationDecoder(World *p_world, const ReplicationSchema &p_schema);
+
+	/// Applies the frame and sets its sequence into `r_sequence`, to
+	/// acknowledge it to the encoder. The frames older than the last applied
+	/// are skipped, returning `ERR_SKIP`: they must not be acknowledged.
+	/// The frame is fully read before being applied, so a malformed frame is
+	/// never applied.
+	Error decode(const uint8_t *p_data, uint32_t p_size, uint32_t &r_sequence);
+
+	/// Returns the local `Entity` of the remote one, or a null `EntityID`.
+	EntityID get_local_entity(EntityID p_remote) const;
+
+private:
+	bool read_frame(BitReader &p_reader);
+};
@@ -3,7 +3,10 @@
 
 #include "../ecs.h"
 #include "../pipeline/pipeline.h"
+#include "../storage/archetype_storage.h"
 #include "../storage/hierarchical_storage.h"
+#include "command_buffer.h"
+#include "core/io/file_access.h"
 
 EntityBuilder::EntityBuilder(World *p_world) :
 		world(p_world) {
@@ -25,13 +28,66 @@ void WorldCommands::_bind_methods() {
 }
 
 EntityID WorldCommands::create_entity() {
-	return entity_register++;
+	MutexLock lock(entity_mutex);
+	return allocate_entity();
+}
+
+void WorldCommands::create_entities(uint32_t p_count, LocalVector<EntityID> &r_entities) {
+	r_entities.reserve(r_entities.size() + p_count);
+
+	MutexLock lock(entity_mutex);
+	for (uint32_t i = 0; i < p_count; i += 1) {
+		const EntityID entity = allocate_entity();
+		ERR_FAIL_COND(entity.is_null());
+		r_entities.push_back(entity);
+	}
+}
+
+EntityID WorldCommands::allocate_entity() {
+	if (free_indices_head < free_indices.size()) {
+		const uint32_t index = free_indices[free_indices_head];
+		free_indices_head += 1;
+		if (free_indices_head == free_indices.size()) {
+			free_indices.clear();
+			free_indices_head = 0;
+		}
+		return EntityID(index, generations[index]);
+	}
+
+	ERR_FAIL_COND_V_MSG(entity_register >= EntityID::INDEX_MASK, EntityID(), "The maximum number of `Entities` is reached.");
+	generations.push_back(0);
+	return EntityID(entity_register++, 0);
 }
 
 void WorldCommands::destroy_deferred(EntityID p_entity) {
 	garbage_list.push_back(p_entity);
 }
 
+bool WorldCommands::is_alive(EntityID p_entity) const {
+	MutexLock lock(entity_mutex);
+
+	const uint32_t index = p_entity.get_index();
+	return index < generations.size() && generations[index] == p_entity.get_generation();
+}
+
+void WorldCommands::release_entity(EntityID p_entity) {
+	MutexLock lock(entity_mutex);
+
+	const uint32_t index = p_entity.get_index();
+	generations[index] = (generations[index] + 1) & EntityID::GENERATION_MASK;
+
+	if (free_indices_head > 0 && free_indices_head >= free_indices.size() / 2) {
+		// Drop the already reused indices, so the queue doesn't grow.
+		const uint32_t count = free_indices.size() - free_indices_head;
+		for (uint32_t i = 0; i < count; i += 1) {
+			free_indices[i] = free_indices[free_indices_head + i];
+		}
+		free_indices.resize(count);
+		free_indices_head = 0;
+	}
+	free_indices.push_back(index);
+}
+
 void World::_bind_methods() {
 	add_method("get_entity_from_path", &World::get_entity_from_path);
 	add_method("get_entity_path", &World::get_entity_path);
@@ -58,6 +114,18 @@ World::World(WorldECS *p_world_ecs) :
 }
 
 World::~World() {
+	for (uint32_t i = 0; i < command_buffers.size(); i += 1) {
+		// The pending commands are dropped.
+		command_buffers[i]->clear();
+		command_buffers[i]->world = nullptr;
+	}
+	command_buffers.clear();
+
+	if (archetype_registry) {
+		// Detach the storages first, so the entities are not moved between
+		// the archetypes while the storages are destroyed.
+		archetype_registry->detach_storages();
+	}
 	for (uint32_t i = 0; i < storages.size(); i += 1) {
 		if (storages[i]) {
 			delete storages[i];
@@ -72,6 +140,10 @@ World::~World() {
 			memdelete(databags[i]);
 		}
 	}
+	if (archetype_registry) {
+		memdelete(archetype_registry);
+		archetype_registry = nullptr;
+	}
 }
 
 EntityID World::create_entity_index() {
@@ -83,6 +155,24 @@ const EntityBuilder &World::create_entity() {
 	return entity_builder;
 }
 
+void World::create_entities(uint32_t p_count, LocalVector<EntityID> &r_entities) {
+	commands.create_entities(p_count, r_entities);
+}
+
+void World::create_entities(uint32_t p_count, EntityID p_prototype, LocalVector<EntityID> &r_entities) {
+	const uint32_t start = r_entities.size();
+	commands.create_entities(p_count, r_entities);
+	// Fewer `Entities` are created when the limit is reached.
+	const uint32_t count = r_entities.size() - start;
+	const EntityID *entities = r_entities.ptr() + start;
+
+	for (uint32_t i = 0; i < storages.size(); i += 1) {
+		if (storages[i] != nullptr && storages[i]->has(p_prototype)) {
+			storages[i]->insert_from_prototype(p_prototype, entities, count);
+		}
+	}
+}
+
 void World::assign_nodepath_to_entity(EntityID p_entity, const NodePath &p_path) {
 	// TODO consider to convert the nodepath to a more efficient structure?
 	// maybe by partizioning each node to a tree structure, it's possible to find
@@ -99,6 +189,11 @@ void World::assign_nodepath_to_entity(EntityID p_entity, const NodePath &p_path)
 }
 
 void World::destroy_entity(EntityID p_entity) {
+	const bool created_by_commands = p_entity.get_index() < commands.generations.size();
+	// The components of a stale `EntityID` belong to the `Entity` that is now
+	// using the index, so they must not be touched.
+	ERR_FAIL_COND_MSG(created_by_commands && commands.is_alive(p_entity) == false, "The Entity " + itos(p_entity.get_index()) + " (generation " + itos(p_entity.get_generation()) + ") is already destroyed.");
+
 	// Removes the components assigned to this entity.
 	for (uint32_t i = 0; i < storages.size(); i += 1) {
 		if (storages[i] != nullptr && storages[i]->has(p_entity)) {
@@ -106,7 +201,14 @@ void World::destroy_entity(EntityID p_entity) {
 		}
 	}
 
-	// TODO consider to reuse this ID.
+	if (created_by_commands) {
+		// Now it's safe to reuse this index.
+		commands.release_entity(p_entity);
+	}
+}
+
+bool World::is_entity_alive(EntityID p_entity) const {
+	return commands.is_alive(p_entity);
 }
 
 EntityID World::get_entity_from_path(const NodePath &p_path) const {
@@ -135,13 +237,49 @@ const WorldCommands &World::get_commands() const {
 }
 
 void World::flush() {
+	flush_command_buffers();
+
 	// Destroy the `Entities`.
 	for (uint32_t i = 0; i < commands.garbage_list.size(); i += 1) {
-		destroy_entity(commands.garbage_list[i]);
+		const EntityID entity = commands.garbage_list[i];
+		if (entity.get_index() < commands.generations.size() && commands.is_alive(entity) == false) {
+			// Already destroyed, maybe marked twice.
+			continue;
+		}
+		destroy_entity(entity);
 	}
 	commands.garbage_list.clear();
 }
 
+void World::add_command_buffer(CommandBuffer *p_buffer) {
+	ERR_FAIL_COND_MSG(command_buffers.find(p_buffer) >= 0, "This CommandBuffer is already added.");
+	command_buffers.push_back(p_buffer);
+	p_buffer->world = this;
+}
+
+void World::remove_command_buffer(CommandBuffer *p_buffer) {
+	const int64_t index = command_buffers.find(p_buffer);
+	ERR_FAIL_COND_MSG(index < 0, "This CommandBuffer is not part of this World.");
+	command_buffers.remove_at(index);
+	p_buffer->world = nullptr;
+}
+
+void World::flush_command_buffers() {
+	for (uint32_t i = 0; i < command_buffers.size(); i += 1) {
+		if (command_buffers[i]->is_empty() == false) {
+			command_buffers[i]->flush(this);
+		}
+	}
+}
+
+const ArchetypeRegistry *World::get_archetype_registry() const {
+	return archetype_registry;
+}
+
+ThreadPool *World::get_thread_pool() const {
+	return thread_pool;
+}
+
 void World::add_component(EntityID p_entity, uint32_t p_component_id, const Dictionary &p_data) {
 	create_storage(p_component_id);
 	StorageBase *storage = get_storage(p_component_id);
@@ -149,12 +287,25 @@ void World::add_component(EntityID p_entity, uint32_t p_component_id, const Dict
 	storage->insert_dynamic(p_entity, p_data);
 }
 
+void World::add_component_batch(const EntityID *p_entities, uint32_t p_count, uint32_t p_component_id, const void *const *p_data) {
+	create_storage(p_component_id);
+	StorageBase *storage = get_storage(p_component_id);
+	ERR_FAIL_COND(storage == nullptr);
+	storage->insert_batch_ptr(p_entities, p_count, p_data);
+}
+
 void World::remove_component(EntityID p_entity, uint32_t p_component_id) {
 	StorageBase *storage = get_storage(p_component_id);
 	ERR_FAIL_COND(storage == nullptr);
 	storage->remove(p_entity);
 }
 
+void World::remove_component_batch(const EntityID *p_entities, uint32_t p_count, uint32_t p_component_id) {
+	StorageBase *storage = get_storage(p_component_id);
+	ERR_FAIL_COND(storage == nullptr);
+	storage->remove_batch(p_entities, p_count);
+}
+
 bool World::has_component(EntityID p_entity, uint32_t p_component_id) const {
 	const StorageBase *storage = get_storage(p_component_id);
 	if (unlikely(storage == nullptr)) {
@@ -184,6 +335,247 @@ void World::add_shared_component(EntityID p_entity, uint32_t p_component_id, god
 	storage->insert(p_entity, p_shared_component_id);
 }
 
+/// Identifies the `World` snapshots, and their format version.
+static const uint32_t SNAPSHOT_MAGIC = 0x58444f47; // GODX
+static const uint32_t SNAPSHOT_VERSION = 1;
+
+void World::save_snapshot(LocalVector<uint8_t> &r_buffer) const {
+	SnapshotWriter writer(r_buffer);
+	writer.write_u32(SNAPSHOT_MAGIC);
+	writer.write_u32(SNAPSHOT_VERSION);
+
+	// The `Entities`, so the IDs stay valid.
+	const uint32_t free_count = commands.free_indices.size() - commands.free_indices_head;
+	writer.write_u32(commands.entity_register);
+	writer.write_raw(commands.generations.ptr(), sizeof(uint8_t) * commands.generations.size());
+	writer.write_u32(free_count);
+	writer.write_raw(commands.free_indices.ptr() + commands.free_indices_head, sizeof(uint32_t) * free_count);
+
+	// The storages.
+	const uint32_t storages_count_position = writer.get_position();
+	uint32_t storages_count = 0;
+	writer.write_u32(0);
+
+	for (uint32_t i = 0; i < storages.size(); i += 1) {
+		if (storages[i] == nullptr) {
+			continue;
+		}
+		if (ECS::is_component_sharable(i)) {
+			WARN_PRINT_ONCE("The shared components are not stored into the snapshot.");
+			continue;
+		}
+
+		writer.write_string(ECS::get_component_name(i));
+		const uint32_t size_position = writer.get_position();
+		writer.write_u32(0);
+		storages[i]->save_snapshot(writer, i);
+		writer.patch_u32(size_position, writer.get_position() - size_position - sizeof(uint32_t));
+		storages_count += 1;
+	}
+
+	writer.patch_u32(storages_count_position, storages_count);
+}
+
+Error World::save_snapshot_to_file(const String &p_path) const {
+	LocalVector<uint8_t> buffer;
+	save_snapshot(buffer);
+
+	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::WRITE);
+	ERR_FAIL_COND_V_MSG(file.is_null(), ERR_CANT_CREATE, "Can't create the snapshot file: " + p_path);
+	file->store_buffer(buffer.ptr(), buffer.size());
+	return OK;
+}
+
+/// Returns `false` if any of the `Entities` is not below `p_entity_register`.
+static bool are_entities_registered(const EntitiesBuffer &p_entities, uint32_t p_entity_register) {
+	for (uint32_t i = 0; i < p_entities.count; i += 1) {
+		if (p_entities.entities[i].get_index() >= p_entity_register) {
+			return false;
+		}
+	}
+	return true;
+}
+
+Error World::load_snapshot(const uint8_t *p_data, uint32_t p_size) {
+	ERR_FAIL_COND_V_MSG(is_dispatching_in_progress, ERR_BUSY, "The snapshot can't be loaded while the world is dispatched.");
+	ERR_FAIL_COND_V_MSG(commands.entity_register != 0, ERR_ALREADY_IN_USE, "The snapshot can be loaded only into a world without `Entities`.");
+
+	SnapshotReader reader(p_data, p_size);
+	uint32_t magic;
+	uint32_t version;
+	ERR_FAIL_COND_V_MSG(reader.read_u32(magic) == false || magic != SNAPSHOT_MAGIC, ERR_FILE_UNRECOGNIZED, "This is not a `World` snapshot.");
+	ERR_FAIL_COND_V_MSG(reader.read_u32(version) == false || version != SNAPSHOT_VERSION, ERR_FILE_UNRECOGNIZED, "This snapshot version is not supported.");
+
+	// The `Entities`.
+	uint32_t entity_register;
+	uint32_t free_count;
+	ERR_FAIL_COND_V(reader.read_u32(entity_register) == false, ERR_FILE_CORRUPT);
+	const uint8_t *generations = reader.read_array(entity_register, sizeof(uint8_t));
+	ERR_FAIL_COND_V(generations == nullptr, ERR_FILE_CORRUPT);
+	ERR_FAIL_COND_V(reader.read_u32(free_count) == false, ERR_FILE_CORRUPT);
+	const uint8_t *free_indices = reader.read_array(free_count, sizeof(uint32_t));
+	ERR_FAIL_COND_V(free_indices == nullptr, ERR_FILE_CORRUPT);
+	for (uint32_t i = 0; i < free_count; i += 1) {
+		uint32_t index;
+		memcpy(&index, free_indices + sizeof(uint32_t) * i, sizeof(uint32_t));
+		ERR_FAIL_COND_V_MSG(index >= entity_register, ERR_FILE_CORRUPT, "The snapshot free index " + itos(index) + " is not a valid Entity.");
+	}
+
+	// Read all the storage sections before touching the world, so a truncated
+	// snapshot is refused as a whole.
+	struct Section {
+		godex::component_id id;
+		String name;
+		SnapshotReader reader = SnapshotReader(nullptr, 0);
+	};
+	LocalVector<Section> sections;
+	uint32_t storages_count;
+	ERR_FAIL_COND_V(reader.read_u32(storages_count) == false, ERR_FILE_CORRUPT);
+	for (uint32_t i = 0; i < storages_count; i += 1) {
+		Section section;
+		uint32_t size;
+		ERR_FAIL_COND_V(reader.read_string(section.name) == false, ERR_FILE_CORRUPT);
+		ERR_FAIL_COND_V(reader.read_u32(size) == false, ERR_FILE_CORRUPT);
+		ERR_FAIL_COND_V(reader.read_section(size, section.reader) == false, ERR_FILE_CORRUPT);
+
+		section.id = ECS::get_component_id(section.name);
+		if (section.id == godex::COMPONENT_NONE) {
+			WARN_PRINT("The component " + section.name + " stored into the snapshot doesn't exist anymore, skipped.");
+			continue;
+		}
+		sections.push_back(section);
+	}
+
+	// Load the storages. If a section is malformed, all the loaded storages are
+	// cleared again, so the world is never left half loaded.
+	for (uint32_t i = 0; i < sections.size(); i += 1) {
+		create_storage(sections[i].id);
+		StorageBase *storage = get_storage(sections[i].id);
+		ERR_FAIL_COND_V(storage == nullptr, ERR_BUG);
+		if (storage->load_snapshot(sections[i].reader, sections[i].id) == false ||
+				are_entities_registered(storage->get_stored_entities(), entity_register) == false) {
+			for (uint32_t l = 0; l <= i; l += 1) {
+				get_storage(sections[l].id)->clear();
+			}
+			ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, "The snapshot section of the component " + sections[i].name + " is corrupted, nothing is loaded.");
+		}
+	}
+
+	commands.entity_register = entity_register;
+	commands.generations.resize(entity_register);
+	if (entity_register > 0) {
+		memcpy(commands.generations.ptr(), generations, sizeof(uint8_t) * entity_register);
+	}
+	commands.free_indices.resize(free_count);
+	if (free_count > 0) {
+		memcpy(commands.free_indices.ptr(), free_indices, sizeof(uint32_t) * free_count);
+	}
+	commands.free_indices_head = 0;
+
+	return OK;
+}
+
+Error World::load_snapshot_from_file(const String &p_path) {
+	Error err;
+	const Vector<uint8_t> data = FileAccess::get_file_as_bytes(p_path, &err);
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Can't read the snapshot file: " + p_path);
+	return load_snapshot(data.ptr(), data.size());
+}
+
+uint32_t World::fork() {
+	ERR_FAIL_COND_V_MSG(is_dispatching_in_progress, UINT32_MAX, "The world can't be forked while dispatched.");
+
+	// Refuse before touching anything, a partial fork can't be restored.
+	for (uint32_t i = 0; i < storages.size(); i += 1) {
+		if (storages[i] == nullptr || ECS::is_component_sharable(i)) {
+			continue;
+		}
+		ERR_FAIL_COND_V_MSG(storages[i]->is_forkable() == false, UINT32_MAX, "The world can't be forked: the storage " + storages[i]->get_type_name() + " of the component " + ECS::get_component_name(i) + " can't restore its state.");
+	}
+
+	// Propagate the pending hierarchy changes, so the forked data is final.
+	static_cast<Hierarchy *>(get_storage<Child>())->flush_hierarchy_changes();
+
+	forks.resize(forks.size() + 1);
+	Fork &fork = forks[forks.size() - 1];
+	fork.id = fork_id_counter++;
+	fork.entity_register = commands.entity_register;
+	fork.generations = commands.generations;
+	fork.free_indices.resize(commands.free_indices.size() - commands.free_indices_head);
+	for (uint32_t i = 0; i < fork.free_indices.size(); i += 1) {
+		fork.free_indices[i] = commands.free_indices[commands.free_indices_head + i];
+	}
+
+	for (uint32_t i = 0; i < storages.size(); i += 1) {
+		if (storages[i] == nullptr) {
+			continue;
+		}
+		if (ECS::is_component_sharable(i)) {
+			WARN_PRINT_ONCE("The shared components are not forked.");
+			continue;
+		}
+		storages[i]->fork(i);
+	}
+
+	return fork.id;
+}
+
+Error World::restore_fork(uint32_t p_fork_id) {
+	ERR_FAIL_COND_V_MSG(is_dispatching_in_progress, ERR_BUSY, "The world can't be restored while dispatched.");
+
+	int64_t index = -1;
+	for (uint32_t i = 0; i < forks.size(); i += 1) {
+		if (forks[i].id == p_fork_id) {
+			index = i;
+			break;
+		}
+	}
+	ERR_FAIL_COND_V_MSG(index == -1, ERR_DOES_NOT_EXIST, "The fork " + itos(p_fork_id) + " doesn't exist or it's already released.");
+
+	const Fork &fork = forks[index];
+	commands.entity_register = fork.entity_register;
+	commands.generations = fork.generations;
+	commands.free_indices = fork.free_indices;
+	commands.free_indices_head = 0;
+	commands.garbage_list.clear();
+
+	for (uint32_t i = 0; i < storages.size(); i += 1) {
+		if (storages[i] == nullptr || ECS::is_component_sharable(i)) {
+			continue;
+		}
+		storages[i]->restore_fork(index, i);
+	}
+
+	forks.resize(index + 1);
+	return OK;
+}
+
+void World::release_fork(uint32_t p_fork_id) {
+	uint32_t count = 0;
+	while (count < forks.size() && forks[count].id <= p_fork_id) {
+		count += 1;
+	}
+	if (count == 0) {
+		// Nothing to do.
+		return;
+	}
+
+	for (uint32_t i = 0; i < storages.size(); i += 1) {
+		if (storages[i] == nullptr || ECS::is_component_sharable(i)) {
+			continue;
+		}
+		storages[i]->release_forks(count);
+	}
+
+	for (uint32_t i = 0; i < count; i += 1) {
+		forks.remove_at(0);
+	}
+}
+
+uint32_t World::get_forks_count() const {
+	return forks.size();
+}
+
 const StorageBase *World::get_storage(uint32_t p_storage_id) const {
 	ERR_FAIL_COND_V_MSG(p_storage_id == UINT32_MAX, nullptr, "The component is not registered.");
 
@@ -244,6 +636,15 @@ void World::create_storage(uint32_t p_component_id) {
 		hierarchy->add_sub_storage(hs);
 	}
 
+	// Automatically set the archetype registry, if this is an ArchetypeStorage.
+	ArchetypeStorageBase *as = dynamic_cast<ArchetypeStorageBase *>(storages[p_component_id]);
+	if (as) {
+		if (archetype_registry == nullptr) {
+			archetype_registry = memnew(ArchetypeRegistry);
+		}
+		archetype_registry->add_storage(p_component_id, as);
+	}
+
 	// Search the config for this storage.
 	Dictionary config = storages_config.get(
 			ECS::get_component_name(p_component_id),
@@ -257,6 +658,14 @@ void World::create_storage(uint32_t p_component_id) {
 	}
 
 	storages[p_component_id]->configure(config);
+
+	if (forks.size() > 0 && ECS::is_component_sharable(p_component_id) == false) {
+		// The storage didn't exist when the alive forks were taken: fork it
+		// empty, so restoring one of them clears it.
+		for (uint32_t i = 0; i < forks.size(); i += 1) {
+			storages[p_component_id]->fork(p_component_id);
+		}
+	}
 }
 
 void World::destroy_storage(uint32_t p_component_id) {
@@ -4,9 +4,12 @@
 #include "../ecs_types.h"
 #include "../storage/event_storage.h"
 #include "../storage/storage.h"
+#include "core/os/mutex.h"
 #include "core/string/string_name.h"
 #include "core/templates/local_vector.h"
 
+class ArchetypeRegistry;
+class CommandBuffer;
 class StorageBase;
 class World;
 class WorldECS;
@@ -64,20 +67,49 @@ class WorldCommands : public godex::Databag {
 
 	friend class World;
 
+	/// Guards the `Entity` IDs allocation: the `CommandBuffer`s create the
+	/// `Entities` from the `System`s, that may run in parallel. `is_alive`
+	/// takes it too, since the `generations` may grow meanwhile.
+	mutable Mutex entity_mutex;
+
 	/// Used to keep tracks of entity IDs.
 	uint32_t entity_register = 0;
 
+	/// The current generation of each `Entity` index.
+	LocalVector<uint8_t> generations;
+	/// Queue of the destroyed `Entity` indices, ready to be reused. The oldest
+	/// is reused first, so the generations wrap as late as possible.
+	LocalVector<uint32_t> free_indices;
+	uint32_t free_indices_head = 0;
+
 	/// List of `Entity` to destroy.
 	LocalVector<EntityID> garbage_list;
 
 	static void _bind_methods();
 
 public:
-	/// Immediately creates a new `Entity`.
+	/// Immediately creates a new `Entity`. Safe to call from many threads.
 	EntityID create_entity();
 
+	/// Immediately creates `p_count` new `Entities`, appended to `r_entities`.
+	/// The lock is taken once for the whole batch. Stops early if the maximum
+	/// number of `Entities` is reached.
+	void create_entities(uint32_t p_count, LocalVector<EntityID> &r_entities);
+
 	/// Mark this `Entity` for disposal.
 	void destroy_deferred(EntityID p_entity);
+
+	/// Returns `true` if the `Entity` is created and not yet destroyed: a
+	/// stale `EntityID`, that points to a reused index, returns `false`.
+	bool is_alive(EntityID p_entity) const;
+
+private:
+	/// Takes a free `Entity` index, or a new one. The `entity_mutex` must be
+	/// locked by the caller.
+	EntityID allocate_entity();
+
+	/// Releases the `Entity` index so it can be reused, with a new generation.
+	void release_entity(EntityID p_entity);
 };
 
 /// The World is a special `Databag` because it's used to store all the ECS storages.
@@ -101,8 +133,15 @@ class World : public godex::Databag {
 	LocalVector<StorageBase *> storages;
 	LocalVector<godex::Databag *> databags;
 	LocalVector<EventStorageBase *> events_storages;
+	/// Shared by all the `ArchetypeStorage`s of this world, created with the
+	/// first one.
+	ArchetypeRegistry *archetype_registry = nullptr;
 	EntityBuilder entity_builder = EntityBuilder(this);
 	bool is_dispatching_in_progress = false;
+	/// The workers of the `Pipeline` that is dispatching this world.
+	ThreadPool *thread_pool = nullptr;
+	/// The `CommandBuffer`s of the `System`s, in the order they were added.
+	LocalVector<CommandBuffer *> command_buffers;
 	OAHashMap<NodePath, EntityID> entity_paths;
 
 	/// Storages configuration, the format is as follows:
@@ -112,6 +151,17 @@ class World : public godex::Databag {
 	Dictionary storages_config;
 	WorldECS *world_ecs = nullptr;
 
+	/// The `Entities` state of a fork: the storages fork their own data.
+	struct Fork {
+		uint32_t id;
+		uint32_t entity_register;
+		LocalVector<uint8_t> generations;
+		LocalVector<uint32_t> free_indices;
+	};
+	/// The alive forks, the oldest first.
+	LocalVector<Fork> forks;
+	uint32_t fork_id_counter = 0;
+
 	static void _bind_methods();
 
 public:
@@ -144,13 +194,26 @@ public:
 	/// It's undefined behavior use it in any other way than the above one.
 	const EntityBuilder &create_entity();
 
+	/// Creates `p_count` new `Entities` at once, appended to `r_entities`.
+	void create_entities(uint32_t p_count, LocalVector<EntityID> &r_entities);
+
+	/// Creates `p_count` new `Entities` at once, appended to `r_entities`, each
+	/// with a copy of all the components of the `p_prototype` `Entity`.
+	/// The components are inserted storage by storage, so each storage reserves
+	/// its memory and notifies the changes just once.
+	void create_entities(uint32_t p_count, EntityID p_prototype, LocalVector<EntityID> &r_entities);
+
 	/// This function can be used to associate a NodePath to an entity,
 	/// so it's possible to uniquly identify the entity.
 	void assign_nodepath_to_entity(EntityID p_entity, const NodePath &p_path);
 
-	/// Remove the entity from this World.
+	/// Remove the entity from this World. Its index is reused later, with a new
+	/// generation, so the old `EntityID` becomes stale.
 	void destroy_entity(EntityID p_entity);
 
+	/// Returns `true` if the `Entity` is created and not yet destroyed.
+	bool is_entity_alive(EntityID p_entity) const;
+
 	EntityID get_entity_from_path(const NodePath &p_path) const;
 	NodePath get_entity_path(EntityID p_id) const;
 
@@ -160,6 +223,19 @@ public:
 	/// Flushes every pending action.
 	void flush();
 
+	/// The `CommandBuffer` is applied by `flush_command_buffers`, until removed.
+	void add_command_buffer(CommandBuffer *p_buffer);
+	void remove_command_buffer(CommandBuffer *p_buffer);
+
+	/// Applies the commands recorded by the `CommandBuffer`s, following the
+	/// order they were added. Called by the `Pipeline` at the end of each stage
+	/// of the main dispatcher.
+	void flush_command_buffers();
+
+	/// Returns the workers of the `Pipeline` that is dispatching this `World`,
+	/// or `nullptr` when the world is not being dispatched.
+	ThreadPool *get_thread_pool() const;
+
 	/// Adds a new component (or sets the default if already exists) to a
 	/// specific Entity.
 	template <class C>
@@ -168,6 +244,17 @@ public:
 	template <class C>
 	void remove_component(EntityID p_entity);
 
+	/// Adds `p_data[i]` to `p_entities[i]`, for all the `p_count` `Entities`.
+	template <class C>
+	void add_component_batch(const EntityID *p_entities, uint32_t p_count, const C *p_data);
+
+	/// Adds a copy of `p_data` to all the `p_count` `Entities`.
+	template <class C>
+	void add_component_copies(const EntityID *p_entities, uint32_t p_count, const C &p_data);
+
+	template <class C>
+	void remove_component_batch(const EntityID *p_entities, uint32_t p_count);
+
 	template <class C>
 	bool has_component(EntityID p_entity) const;
 
@@ -175,7 +262,11 @@ public:
 	/// contains the initialization parameters.
 	/// Usually this function is used to initialize the script components.
 	void add_component(EntityID p_entity, uint32_t p_component_id, const Dictionary &p_data);
+	/// Adds `*p_data[i]` to `p_entities[i]`, for all the `p_count` `Entities`.
+	/// Each `p_data[i]` points to a component of type `p_component_id`.
+	void add_component_batch(const EntityID *p_entities, uint32_t p_count, uint32_t p_component_id, const void *const *p_data);
 	void remove_component(EntityID p_entity, uint32_t p_component_id);
+	void remove_component_batch(const EntityID *p_entities, uint32_t p_count, uint32_t p_component_id);
 	bool has_component(EntityID p_entity, uint32_t p_component_id) const;
 
 	template <class C>
@@ -183,6 +274,47 @@ public:
 	godex::SID create_shared_component(uint32_t p_component_id, const Dictionary &p_component_data);
 	void add_shared_component(EntityID p_entity, uint32_t p_component_id, godex::SID p_shared_component_id);
 
+	/// Writes the `Entities` and the components of this world into a binary
+	/// snapshot, that `load_snapshot` can restore. Each storage writes its own
+	/// section: the components that opt in with `SNAPSHOT_RAW_LAYOUT` are
+	/// stored as raw arrays, all the others (script components included) as
+	/// `Variant`s. The shared components and the databags are not stored.
+	void save_snapshot(LocalVector<uint8_t> &r_buffer) const;
+	Error save_snapshot_to_file(const String &p_path) const;
+
+	/// Restores the snapshot created by `save_snapshot`. The world must not
+	/// have any `Entity`: the `EntityID`s are restored as they were.
+	/// The snapshot is validated before the world is touched, and a malformed
+	/// storage section clears what was loaded: the world is never left half
+	/// loaded.
+	Error load_snapshot(const uint8_t *p_data, uint32_t p_size);
+	Error load_snapshot_from_file(const String &p_path);
+
+	/// Forks the world, so `restore_fork` can roll it back to the current
+	/// state: useful to predict many frames and roll back on correction.
+	/// The storages are forked lazily: `DenseVectorStorage`,
+	/// `HierarchicalStorage` and `Hierarchy` copy a page of their data only
+	/// when it's written after the fork, the `TagStorage` is copied
+	/// entirely and the `BatchStorage` falls back to its snapshot. The shared
+	/// components and the databags are not forked.
+	/// Fails, returning `UINT32_MAX`, when a storage can't restore its state
+	/// (see `StorageBase::is_forkable`): the `SteadyStorage` and the
+	/// `ArchetypeStorage` are never forked.
+	/// Call this between two dispatches. Returns the fork ID.
+	uint32_t fork();
+
+	/// Rolls back the world to the state of the fork `p_fork_id`. The newer
+	/// forks are dropped, while `p_fork_id` is kept so it can be restored
+	/// again.
+	Error restore_fork(uint32_t p_fork_id);
+
+	/// Drops the fork `p_fork_id` and the older ones: keep alive only the
+	/// forks that may be restored, since each one holds the data written
+	/// after it.
+	void release_fork(uint32_t p_fork_id);
+
+	uint32_t get_forks_count() const;
+
 	/// Returns the const storage pointed by the give ID.
 	const StorageBase *get_storage(uint32_t p_storage_id) const;
 
@@ -246,6 +378,10 @@ public:
 	/// Retuns a databag pointer.
 	const godex::Databag *get_databag(godex::databag_id p_id) const;
 
+	/// Returns the registry used by the `ArchetypeStorage`s of this world, or
+	/// `nullptr` if no `ArchetypeStorage` exists.
+	const ArchetypeRegistry *get_archetype_registry() const;
+
 	/// Retuns the events storage pointer.
 	template <class E>
 	EventStorage<E> *get_events_storage();
@@ -302,6 +438,27 @@ void World::remove_component(EntityID p_entity) {
 	remove_component(p_entity, C::get_component_id());
 }
 
+template <class C>
+void World::add_component_batch(const EntityID *p_entities, uint32_t p_count, const C *p_data) {
+	create_storage<C>();
+	Storage<C> *storage = get_storage<C>();
+	ERR_FAIL_COND(storage == nullptr);
+	storage->insert_batch(p_entities, p_count, p_data);
+}
+
+template <class C>
+void World::add_component_copies(const EntityID *p_entities, uint32_t p_count, const C &p_data) {
+	create_storage<C>();
+	Storage<C> *storage = get_storage<C>();
+	ERR_FAIL_COND(storage == nullptr);
+	storage->insert_batch(p_entities, p_count, p_data);
+}
+
+template <class C>
+void World::remove_component_batch(const EntityID *p_entities, uint32_t p_count) {
+	remove_component_batch(p_entities, p_count, C::get_component_id());
+}
+
 template <class C>
 bool World::has_component(EntityID p_entity) const {
 	return has_component(p_entity, C::get_component_id());